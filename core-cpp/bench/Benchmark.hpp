@@ -0,0 +1,356 @@
+#pragma once
+
+#include "inference_engine/InferenceEngine.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <filesystem>
+#include <functional>
+#include <iomanip>
+#include <memory>
+#include <numeric>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace inference_engine
+{
+namespace bench
+{
+struct Options
+{
+    size_t iterations = 1000;
+    size_t create_iterations = 10;
+    std::filesystem::path output_path = "bench-results.json";
+
+    // Model files, or directories whose files with the backend's extension are all benchmarked.
+    std::vector<std::filesystem::path> model_paths = {"bench-models"};
+};
+
+// Parses `[--iterations N] [--create-iterations N] [--output FILE] [MODEL_OR_DIRECTORY...]`.
+inline Options parse_options(int argc, char **argv)
+{
+    Options options;
+    std::vector<std::filesystem::path> model_paths;
+
+    for (auto i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+
+        if ((arg == "--iterations" || arg == "--create-iterations" || arg == "--output") && i + 1 >= argc)
+        {
+            throw std::runtime_error("missing value for " + arg);
+        }
+
+        if (arg == "--iterations")
+        {
+            options.iterations = std::stoul(argv[++i]);
+        }
+        else if (arg == "--create-iterations")
+        {
+            options.create_iterations = std::stoul(argv[++i]);
+        }
+        else if (arg == "--output")
+        {
+            options.output_path = argv[++i];
+        }
+        else
+        {
+            model_paths.push_back(arg);
+        }
+    }
+
+    if (!model_paths.empty())
+    {
+        options.model_paths = model_paths;
+    }
+
+    return options;
+}
+
+// Expands directories into the files with the given extension they contain, in name order.
+inline std::vector<std::filesystem::path> find_models(const std::vector<std::filesystem::path> &paths, const std::string &extension)
+{
+    std::vector<std::filesystem::path> models;
+
+    for (const auto &path : paths)
+    {
+        if (!std::filesystem::is_directory(path))
+        {
+            models.push_back(path);
+            continue;
+        }
+
+        std::vector<std::filesystem::path> files;
+
+        for (const auto &entry : std::filesystem::directory_iterator(path))
+        {
+            if (entry.path().extension() == extension)
+            {
+                files.push_back(entry.path());
+            }
+        }
+
+        std::sort(files.begin(), files.end());
+        models.insert(models.end(), files.begin(), files.end());
+    }
+
+    return models;
+}
+
+// A model together with two sets of shapes that reshapes alternate between. Output shapes are only set for
+// backends that cannot infer them, and are left empty otherwise.
+struct Case
+{
+    std::filesystem::path model_path;
+    std::vector<std::vector<std::vector<size_t>>> input_shape_sets;
+    std::vector<std::vector<std::vector<size_t>>> output_shape_sets;
+};
+
+struct Statistics
+{
+    size_t count;
+    std::chrono::duration<double, std::micro> p50;
+    std::chrono::duration<double, std::micro> p90;
+    std::chrono::duration<double, std::micro> p99;
+    std::chrono::duration<double, std::micro> max;
+
+    // Operations per second spent in the measured operation.
+    double throughput;
+};
+
+inline Statistics get_statistics(std::vector<std::chrono::nanoseconds> samples)
+{
+    if (samples.empty())
+    {
+        return {};
+    }
+
+    std::sort(samples.begin(), samples.end());
+
+    auto percentile = [&samples](double p) {
+        auto rank = static_cast<size_t>(std::ceil(p * samples.size()));
+        return samples[std::max<size_t>(rank, 1) - 1];
+    };
+
+    auto total = std::accumulate(samples.begin(), samples.end(), std::chrono::nanoseconds(0));
+
+    return {
+        samples.size(),
+        percentile(0.5),
+        percentile(0.9),
+        percentile(0.99),
+        samples.back(),
+        samples.size() / std::chrono::duration<double>(total).count(),
+    };
+}
+
+struct Result
+{
+    std::string model;
+    std::string operation;
+
+    // Input shapes the operation ran with, if it depends on them.
+    std::string shapes;
+
+    Statistics statistics;
+};
+
+// Measures creating, reshaping, binding and running engines of one backend, and reports latency percentiles.
+class Benchmark
+{
+public:
+    using CreateEngine = std::function<std::unique_ptr<InferenceEngine>(const std::filesystem::path &model_path)>;
+
+    Benchmark(std::string backend, CreateEngine create_engine, const Options &options)
+        : backend(std::move(backend))
+        , create_engine(std::move(create_engine))
+        , options(options)
+    {
+    }
+
+    void run(const Case &model_case)
+    {
+        auto model = model_case.model_path.stem().string();
+        std::vector<std::chrono::nanoseconds> samples;
+
+        for (auto i = 0; i < options.create_iterations; i++)
+        {
+            std::unique_ptr<InferenceEngine> engine;
+            samples.push_back(measure([&] { engine = create_engine(model_case.model_path); }));
+        }
+
+        add_result(model, "create", "", samples);
+
+        auto engine = create_engine(model_case.model_path);
+
+        for (auto i = 0; i < options.iterations; i++)
+        {
+            samples.push_back(measure([&] { reshape(*engine, model_case, i % 2); }));
+        }
+
+        add_result(model, "reshape", "", samples);
+
+        reshape(*engine, model_case, 0);
+        auto buffers = allocate_buffers(*engine);
+
+        for (auto i = 0; i < options.iterations; i++)
+        {
+            auto &buffer_set = buffers[i % 2];
+
+            samples.push_back(measure([&] {
+                for (auto j = 0; j < engine->get_input_count(); j++)
+                {
+                    engine->set_input_raw_data(j, buffer_set[j].data());
+                }
+
+                for (auto j = 0; j < engine->get_output_count(); j++)
+                {
+                    engine->set_output_raw_data(j, buffer_set[engine->get_input_count() + j].data());
+                }
+            }));
+        }
+
+        add_result(model, "bind", "", samples);
+
+        for (auto set = 0; set < model_case.input_shape_sets.size(); set++)
+        {
+            reshape(*engine, model_case, set);
+            engine->warmup({model_case.input_shape_sets[set]}, 3);
+
+            for (auto i = 0; i < options.iterations; i++)
+            {
+                samples.push_back(measure([&] { engine->run(); }));
+            }
+
+            add_result(model, "run", format_shapes(model_case.input_shape_sets[set]), samples);
+        }
+    }
+
+    // Prints one row per result.
+    void print(std::ostream &os) const
+    {
+        os << std::left << std::setw(20) << "model" << std::setw(10) << "operation" << std::setw(24) << "shapes" << std::right << std::setw(12)
+           << "p50 (us)" << std::setw(12) << "p90 (us)" << std::setw(12) << "p99 (us)" << std::setw(12) << "max (us)" << std::setw(14) << "ops/s"
+           << "\n";
+
+        for (const auto &result : results)
+        {
+            const auto &statistics = result.statistics;
+
+            os << std::left << std::setw(20) << result.model << std::setw(10) << result.operation << std::setw(24) << result.shapes << std::right
+               << std::fixed << std::setprecision(1) << std::setw(12) << statistics.p50.count() << std::setw(12) << statistics.p90.count()
+               << std::setw(12) << statistics.p99.count() << std::setw(12) << statistics.max.count() << std::setw(14) << statistics.throughput
+               << "\n";
+        }
+    }
+
+    void write_json(std::ostream &os) const
+    {
+        os << "{\n";
+        os << "  \"backend\": \"" << backend << "\",\n";
+        os << "  \"iterations\": " << options.iterations << ",\n";
+        os << "  \"create_iterations\": " << options.create_iterations << ",\n";
+        os << "  \"results\": [";
+
+        for (auto i = 0; i < results.size(); i++)
+        {
+            const auto &result = results[i];
+            const auto &statistics = result.statistics;
+
+            os << (i > 0 ? ",\n" : "\n") << "    {";
+            os << "\"model\": \"" << result.model << "\", ";
+            os << "\"operation\": \"" << result.operation << "\", ";
+            os << "\"shapes\": \"" << result.shapes << "\", ";
+            os << "\"count\": " << statistics.count << ", ";
+            os << std::fixed << std::setprecision(3);
+            os << "\"p50_us\": " << statistics.p50.count() << ", ";
+            os << "\"p90_us\": " << statistics.p90.count() << ", ";
+            os << "\"p99_us\": " << statistics.p99.count() << ", ";
+            os << "\"max_us\": " << statistics.max.count() << ", ";
+            os << "\"throughput_per_s\": " << statistics.throughput;
+            os << "}";
+        }
+
+        os << "\n  ]\n}\n";
+    }
+
+private:
+    template <typename F>
+    static std::chrono::nanoseconds measure(F &&f)
+    {
+        auto start = std::chrono::steady_clock::now();
+        f();
+        return std::chrono::steady_clock::now() - start;
+    }
+
+    static void reshape(InferenceEngine &engine, const Case &model_case, size_t set)
+    {
+        engine.set_input_shapes(model_case.input_shape_sets[set]);
+
+        if (!model_case.output_shape_sets.empty())
+        {
+            const auto &shapes = model_case.output_shape_sets[set];
+
+            for (auto i = 0; i < shapes.size(); i++)
+            {
+                engine.set_output_shape(i, shapes[i]);
+            }
+        }
+    }
+
+    // Two sets of caller buffers for all inputs and outputs, sized for the current shapes.
+    static std::vector<std::vector<std::vector<std::byte>>> allocate_buffers(const InferenceEngine &engine)
+    {
+        std::vector<std::vector<std::vector<std::byte>>> buffers(2);
+
+        for (auto &buffer_set : buffers)
+        {
+            for (auto i = 0; i < engine.get_input_count(); i++)
+            {
+                buffer_set.emplace_back(count_elements(engine.get_input_shape(i)) * get_element_size(engine.get_input_element_type(i)));
+            }
+
+            for (auto i = 0; i < engine.get_output_count(); i++)
+            {
+                buffer_set.emplace_back(count_elements(engine.get_output_shape(i)) * get_element_size(engine.get_output_element_type(i)));
+            }
+        }
+
+        return buffers;
+    }
+
+    static std::string format_shapes(const std::vector<std::vector<size_t>> &shapes)
+    {
+        std::string text;
+
+        for (const auto &shape : shapes)
+        {
+            text += text.empty() ? "" : ",";
+
+            for (auto i = 0; i < shape.size(); i++)
+            {
+                text += (i > 0 ? "x" : "") + std::to_string(shape[i]);
+            }
+        }
+
+        return text;
+    }
+
+    void add_result(const std::string &model, const std::string &operation, const std::string &shapes, std::vector<std::chrono::nanoseconds> &samples)
+    {
+        results.push_back({model, operation, shapes, get_statistics(std::move(samples))});
+        samples.clear();
+    }
+
+    const std::string backend;
+    const CreateEngine create_engine;
+    const Options options;
+
+    std::vector<Result> results;
+};
+} // namespace bench
+} // namespace inference_engine
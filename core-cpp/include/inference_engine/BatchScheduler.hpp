@@ -0,0 +1,296 @@
+#pragma once
+
+#include "inference_engine/InferenceEngine.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace inference_engine
+{
+struct BatchSchedulerOptions
+{
+    // Maximum number of rows stacked along the batch dimension into one run.
+    size_t max_batch_size = 8;
+
+    // How long the oldest queued request may wait for others to fill its batch.
+    std::chrono::microseconds max_queue_delay = std::chrono::milliseconds(1);
+
+    // Output shapes without the batch dimension, for engines that cannot infer output shapes from input shapes.
+    // Leave empty to use the output shapes reported by the engine after reshaping its inputs.
+    std::vector<std::vector<size_t>> output_shapes;
+};
+
+// Stacks independently submitted requests along the leading (batch) dimension and runs them as one batch.
+// The scheduler drives the engine from its own thread, so the engine must not be used elsewhere meanwhile.
+class BatchScheduler
+{
+public:
+    struct Tensor
+    {
+        std::vector<size_t> shape;
+        std::vector<float> data;
+    };
+
+    BatchScheduler(InferenceEngine &engine, const BatchSchedulerOptions &options = {})
+        : engine(engine)
+        , options(options)
+        , input_buffers(engine.get_input_count())
+        , output_buffers(engine.get_output_count())
+        , worker(&BatchScheduler::work, this)
+    {
+    }
+
+    BatchScheduler(const BatchScheduler &) = delete;
+    BatchScheduler &operator=(const BatchScheduler &) = delete;
+
+    ~BatchScheduler()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+
+        condition.notify_one();
+        worker.join();
+    }
+
+    std::future<std::vector<Tensor>> submit(std::vector<Tensor> inputs)
+    {
+        if (inputs.size() != engine.get_input_count())
+        {
+            throw std::runtime_error("number of request inputs does not match the engine");
+        }
+
+        for (const auto &input : inputs)
+        {
+            if (input.shape.empty() || input.shape[0] != inputs[0].shape[0])
+            {
+                throw std::runtime_error("request inputs must share the leading batch dimension");
+            }
+
+            if (input.shape[0] == 0)
+            {
+                throw std::runtime_error("request batch dimension must not be zero");
+            }
+
+            if (input.data.size() != count_elements(input.shape))
+            {
+                throw std::runtime_error("request input data does not match its shape");
+            }
+        }
+
+        Request request;
+        request.inputs = std::move(inputs);
+        request.batch_size = request.inputs[0].shape[0];
+        request.enqueue_time = std::chrono::steady_clock::now();
+
+        auto future = request.promise.get_future();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            queue.push_back(std::move(request));
+        }
+
+        condition.notify_one();
+
+        return future;
+    }
+
+private:
+    struct Request
+    {
+        std::vector<Tensor> inputs;
+        size_t batch_size;
+        std::chrono::steady_clock::time_point enqueue_time;
+        std::promise<std::vector<Tensor>> promise;
+    };
+
+    InferenceEngine &engine;
+    const BatchSchedulerOptions options;
+
+    std::vector<std::vector<float>> input_buffers;
+    std::vector<std::vector<float>> output_buffers;
+
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::deque<Request> queue;
+    bool stopping = false;
+
+    std::thread worker;
+
+    static bool is_compatible(const Request &a, const Request &b)
+    {
+        for (auto i = 0; i < a.inputs.size(); i++)
+        {
+            if (!std::equal(a.inputs[i].shape.begin() + 1, a.inputs[i].shape.end(), b.inputs[i].shape.begin() + 1, b.inputs[i].shape.end()))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    size_t count_compatible_rows() const
+    {
+        size_t rows = 0;
+
+        for (const auto &request : queue)
+        {
+            if (is_compatible(queue.front(), request))
+            {
+                rows += request.batch_size;
+            }
+        }
+
+        return rows;
+    }
+
+    std::vector<Request> take_batch()
+    {
+        std::vector<Request> batch;
+        size_t rows = 0;
+
+        for (auto it = queue.begin(); it != queue.end();)
+        {
+            if (batch.empty() || (is_compatible(batch.front(), *it) && rows + it->batch_size <= options.max_batch_size))
+            {
+                rows += it->batch_size;
+                batch.push_back(std::move(*it));
+                it = queue.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+
+        return batch;
+    }
+
+    void work()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+
+        while (true)
+        {
+            condition.wait(lock, [this] { return stopping || !queue.empty(); });
+
+            if (queue.empty())
+            {
+                return;
+            }
+
+            condition.wait_until(lock, queue.front().enqueue_time + options.max_queue_delay, [this] {
+                return stopping || count_compatible_rows() >= options.max_batch_size;
+            });
+
+            auto batch = take_batch();
+            lock.unlock();
+
+            try
+            {
+                run_batch(batch);
+            }
+            catch (...)
+            {
+                for (auto &request : batch)
+                {
+                    request.promise.set_exception(std::current_exception());
+                }
+            }
+
+            lock.lock();
+        }
+    }
+
+    void run_batch(std::vector<Request> &batch)
+    {
+        size_t rows = 0;
+
+        for (const auto &request : batch)
+        {
+            rows += request.batch_size;
+        }
+
+        for (auto i = 0; i < input_buffers.size(); i++)
+        {
+            auto shape = batch.front().inputs[i].shape;
+            shape[0] = rows;
+
+            if (engine.get_input_shape(i) != shape)
+            {
+                engine.set_input_shape(i, shape);
+            }
+
+            auto &buffer = input_buffers[i];
+            buffer.clear();
+
+            for (const auto &request : batch)
+            {
+                buffer.insert(buffer.end(), request.inputs[i].data.begin(), request.inputs[i].data.end());
+            }
+
+            engine.set_input_data(i, buffer.data());
+        }
+
+        for (auto i = 0; i < output_buffers.size(); i++)
+        {
+            if (i < options.output_shapes.size())
+            {
+                std::vector<size_t> shape{rows};
+                shape.insert(shape.end(), options.output_shapes[i].begin(), options.output_shapes[i].end());
+
+                if (engine.get_output_shape(i) != shape)
+                {
+                    engine.set_output_shape(i, shape);
+                }
+            }
+
+            const auto &shape = engine.get_output_shape(i);
+
+            if (shape.empty() || shape[0] != rows)
+            {
+                throw std::runtime_error("output batch dimension does not match the stacked requests");
+            }
+
+            output_buffers[i].resize(count_elements(shape));
+            engine.set_output_data(i, output_buffers[i].data());
+        }
+
+        engine.run();
+
+        std::vector<std::vector<Tensor>> outputs(batch.size());
+
+        for (auto i = 0; i < output_buffers.size(); i++)
+        {
+            const auto &shape = engine.get_output_shape(i);
+            auto row_size = count_elements(shape) / rows;
+            auto data = output_buffers[i].begin();
+
+            for (auto r = 0; r < batch.size(); r++)
+            {
+                Tensor output;
+                output.shape = shape;
+                output.shape[0] = batch[r].batch_size;
+                output.data.assign(data, data + batch[r].batch_size * row_size);
+                data += batch[r].batch_size * row_size;
+                outputs[r].push_back(std::move(output));
+            }
+        }
+
+        for (auto r = 0; r < batch.size(); r++)
+        {
+            batch[r].promise.set_value(std::move(outputs[r]));
+        }
+    }
+};
+} // namespace inference_engine
@@ -0,0 +1,134 @@
+#pragma once
+
+#include "inference_engine/CpuPlacement.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <vector>
+
+namespace inference_engine
+{
+// A 64-byte aligned block of memory that engine-owned tensor buffers are carved from.
+// It only grows when a layout needs more bytes than it has ever held, so going back to a known set of shapes does
+// not touch the heap. Laying out new sizes moves the buffers carved from it before, which only reallocate preserves the
+// contents of.
+class BufferArena
+{
+public:
+    static constexpr size_t alignment = 64;
+
+    BufferArena() = default;
+
+    // Places the memory of the arena on a NUMA node, or leaves it to the OS for a negative node. Every buffer is
+    // followed by at least the given padding, for kernels that read past the end of their inputs.
+    explicit BufferArena(int numa_node, size_t padding = 0)
+        : numa_node(numa_node)
+        , padding(padding)
+    {
+    }
+
+    // Lays out buffers of the given byte sizes back to back, each starting at an aligned address.
+    void allocate(const std::vector<size_t> &sizes, std::vector<std::byte *> &buffers)
+    {
+        reserve(get_layout_size(sizes));
+
+        auto buffer = data.get();
+        buffers.resize(sizes.size());
+
+        for (auto i = 0; i < sizes.size(); i++)
+        {
+            buffers[i] = buffer;
+            buffer += get_stride(sizes[i]);
+        }
+    }
+
+    // Lays out buffers like allocate, but keeps the contents of the buffers laid out before, which buffers holds
+    // with their previous sizes. Sizes must not shrink, so that buffers only move towards the end of the arena.
+    void reallocate(const std::vector<size_t> &previous_sizes, const std::vector<size_t> &sizes, std::vector<std::byte *> &buffers)
+    {
+        auto size = get_layout_size(sizes);
+        std::unique_ptr<std::byte[], Deleter> previous_data;
+
+        if (size > capacity)
+        {
+            previous_data = std::move(data);
+            capacity = 0;
+        }
+
+        reserve(size);
+        buffers.resize(sizes.size());
+
+        // The last buffers move first, so that no buffer is overwritten before it has moved.
+        auto buffer = data.get() + size;
+
+        for (auto i = sizes.size(); i-- > 0;)
+        {
+            buffer -= get_stride(sizes[i]);
+
+            if (i < previous_sizes.size() && buffers[i] && buffers[i] != buffer)
+            {
+                std::memmove(buffer, buffers[i], previous_sizes[i]);
+            }
+
+            buffers[i] = buffer;
+        }
+    }
+
+    size_t get_capacity() const
+    {
+        return capacity;
+    }
+
+private:
+    struct Deleter
+    {
+        void operator()(std::byte *data) const
+        {
+            ::operator delete[](data, std::align_val_t(alignment));
+        }
+    };
+
+    size_t get_stride(size_t size) const
+    {
+        return (size + padding + alignment - 1) / alignment * alignment;
+    }
+
+    size_t get_layout_size(const std::vector<size_t> &sizes) const
+    {
+        size_t size = 0;
+
+        for (auto buffer_size : sizes)
+        {
+            size += get_stride(buffer_size);
+        }
+
+        return size;
+    }
+
+    void reserve(size_t size)
+    {
+        // Keeps even empty layouts backed by memory so that no buffer is null.
+        size = std::max(size, alignment);
+
+        if (size > capacity)
+        {
+            data.reset();
+            data.reset(static_cast<std::byte *>(::operator new[](size, std::align_val_t(alignment))));
+            capacity = size;
+
+            if (numa_node >= 0)
+            {
+                bind_to_numa_node(data.get(), size, numa_node);
+            }
+        }
+    }
+
+    std::unique_ptr<std::byte[], Deleter> data;
+    size_t capacity = 0;
+    int numa_node = -1;
+    size_t padding = 0;
+};
+} // namespace inference_engine
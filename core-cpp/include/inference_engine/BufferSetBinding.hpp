@@ -0,0 +1,208 @@
+#pragma once
+
+#include "inference_engine/InferenceEngine.hpp"
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace inference_engine
+{
+// A buffer set of an engine that binds some tensors to fixed buffers and keeps the other tensors bound as they were
+// when it was registered. It is registered on first selection, and again once its fixed buffers changed or reshaping
+// the engine dropped it, so that switching between such sets costs one select_buffer_set per run. The set is released
+// along with the binding, so the engine must outlive it.
+class BufferSetBinding
+{
+public:
+    BufferSetBinding() = default;
+
+    // Copies take the fixed buffers but not the registration, which stays with one binding.
+    BufferSetBinding(const BufferSetBinding &other)
+        : inputs(other.inputs)
+        , outputs(other.outputs)
+    {
+    }
+
+    BufferSetBinding(BufferSetBinding &&other) noexcept
+        : inputs(std::move(other.inputs))
+        , outputs(std::move(other.outputs))
+        , registered_inputs(std::move(other.registered_inputs))
+        , registered_outputs(std::move(other.registered_outputs))
+        , engine(std::exchange(other.engine, nullptr))
+        , id(std::exchange(other.id, 0))
+    {
+    }
+
+    BufferSetBinding &operator=(const BufferSetBinding &other)
+    {
+        inputs = other.inputs;
+        outputs = other.outputs;
+        return *this;
+    }
+
+    BufferSetBinding &operator=(BufferSetBinding &&other) noexcept
+    {
+        if (this != &other)
+        {
+            release();
+            inputs = std::move(other.inputs);
+            outputs = std::move(other.outputs);
+            registered_inputs = std::move(other.registered_inputs);
+            registered_outputs = std::move(other.registered_outputs);
+            engine = std::exchange(other.engine, nullptr);
+            id = std::exchange(other.id, 0);
+        }
+
+        return *this;
+    }
+
+    ~BufferSetBinding()
+    {
+        release();
+    }
+
+    // Fixes the buffer of a tensor in the set, or leaves it as the engine has it bound for null.
+    void set_input(size_t index, const void *data)
+    {
+        if (index >= inputs.size())
+        {
+            inputs.resize(index + 1);
+        }
+
+        inputs[index] = data;
+    }
+
+    void set_output(size_t index, void *data)
+    {
+        if (index >= outputs.size())
+        {
+            outputs.resize(index + 1);
+        }
+
+        outputs[index] = data;
+    }
+
+    // Selects the set if the engine still has it registered with the fixed buffers, so that tensors bound from now on
+    // are bound in it. Returns whether it did.
+    bool try_select(InferenceEngine &engine) const
+    {
+        if (&engine != this->engine || id == 0 || id >= engine.get_buffer_set_count())
+        {
+            return false;
+        }
+
+        engine.select_buffer_set(id);
+        return is_bound(engine);
+    }
+
+    void select(InferenceEngine &engine)
+    {
+        if (try_select(engine))
+        {
+            return;
+        }
+
+        // The current bindings fill in the tensors that are not fixed, so this runs before releasing the old set,
+        // which selects set 0.
+        std::vector<const void *> set_inputs(engine.get_input_count());
+        std::vector<void *> set_outputs(engine.get_output_count());
+
+        for (size_t i = 0; i < set_inputs.size(); i++)
+        {
+            set_inputs[i] = i < inputs.size() && inputs[i] ? inputs[i] : engine.get_input_raw_data(i);
+        }
+
+        for (size_t i = 0; i < set_outputs.size(); i++)
+        {
+            set_outputs[i] = i < outputs.size() && outputs[i] ? outputs[i] : const_cast<void *>(engine.get_output_raw_data(i));
+        }
+
+        release();
+        id = engine.register_buffer_set(set_inputs, set_outputs);
+        this->engine = &engine;
+        registered_inputs = std::move(set_inputs);
+        registered_outputs = std::move(set_outputs);
+        engine.select_buffer_set(id);
+    }
+
+    // Unregisters the set if the engine still has it, rather than a set registered under the same id after reshaping
+    // dropped it, and selects set 0.
+    void release() noexcept
+    {
+        if (!engine)
+        {
+            return;
+        }
+
+        if (id < engine->get_buffer_set_count())
+        {
+            engine->select_buffer_set(id);
+
+            if (is_registered(*engine))
+            {
+                engine->unregister_buffer_set(id);
+            }
+            else
+            {
+                engine->select_buffer_set(0);
+            }
+        }
+
+        engine = nullptr;
+        id = 0;
+    }
+
+private:
+    bool is_bound(InferenceEngine &engine) const
+    {
+        for (size_t i = 0; i < inputs.size(); i++)
+        {
+            if (inputs[i] && engine.get_input_raw_data(i) != inputs[i])
+            {
+                return false;
+            }
+        }
+
+        for (size_t i = 0; i < outputs.size(); i++)
+        {
+            if (outputs[i] && engine.get_output_raw_data(i) != outputs[i])
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool is_registered(InferenceEngine &engine) const
+    {
+        for (size_t i = 0; i < registered_inputs.size(); i++)
+        {
+            if (engine.get_input_raw_data(i) != registered_inputs[i])
+            {
+                return false;
+            }
+        }
+
+        for (size_t i = 0; i < registered_outputs.size(); i++)
+        {
+            if (engine.get_output_raw_data(i) != registered_outputs[i])
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    std::vector<const void *> inputs;
+    std::vector<void *> outputs;
+    std::vector<const void *> registered_inputs;
+    std::vector<void *> registered_outputs;
+
+    // Null and 0 until registered, as set 0 is the engine's own.
+    InferenceEngine *engine = nullptr;
+    size_t id = 0;
+};
+} // namespace inference_engine
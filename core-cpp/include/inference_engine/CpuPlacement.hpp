@@ -0,0 +1,183 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace inference_engine
+{
+namespace detail
+{
+#ifdef __linux__
+constexpr int mpol_default = 0;
+constexpr int mpol_preferred = 1;
+constexpr unsigned long mpol_mf_move = 1 << 1;
+
+// Large enough for the highest node count Linux supports.
+constexpr size_t node_mask_bits = 1024;
+constexpr size_t node_mask_word_bits = 8 * sizeof(unsigned long);
+
+inline std::vector<unsigned long> get_node_mask(int node)
+{
+    if (node < 0 || node >= node_mask_bits)
+    {
+        throw std::runtime_error("invalid NUMA node " + std::to_string(node));
+    }
+
+    std::vector<unsigned long> mask(node_mask_bits / node_mask_word_bits);
+    mask[node / node_mask_word_bits] = 1ul << (node % node_mask_word_bits);
+    return mask;
+}
+#endif
+} // namespace detail
+
+// Prefers a NUMA node for the pages spanning a range of memory, and moves the ones already placed elsewhere unless
+// other processes map them too. Anonymous pages touched later are allocated on the node by whichever thread touches
+// them, while pages of mapped files follow the policy of the thread that reads them in. Only supported on Linux.
+inline void bind_to_numa_node(const void *data, size_t size, int node)
+{
+    if (size == 0)
+    {
+        return;
+    }
+
+#ifdef __linux__
+    auto mask = detail::get_node_mask(node);
+    auto page_size = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+    auto start = reinterpret_cast<uintptr_t>(data) / page_size * page_size;
+    auto end = (reinterpret_cast<uintptr_t>(data) + size + page_size - 1) / page_size * page_size;
+
+    if (syscall(SYS_mbind, start, end - start, detail::mpol_preferred, mask.data(), detail::node_mask_bits + 1, detail::mpol_mf_move) != 0)
+    {
+        throw std::runtime_error("failed to bind memory to NUMA node " + std::to_string(node));
+    }
+#else
+    throw std::runtime_error("NUMA placement is not supported on this platform");
+#endif
+}
+
+// Prefers a NUMA node for the memory the current thread allocates and reads in until the scope ends.
+// Does nothing for a negative node.
+class NumaNodeScope
+{
+public:
+    explicit NumaNodeScope(int node)
+    {
+        if (node < 0)
+        {
+            return;
+        }
+
+#ifdef __linux__
+        previous_mask.resize(detail::node_mask_bits / detail::node_mask_word_bits);
+
+        if (syscall(SYS_get_mempolicy, &previous_mode, previous_mask.data(), detail::node_mask_bits + 1, nullptr, 0) != 0)
+        {
+            throw std::runtime_error("failed to get the NUMA memory policy");
+        }
+
+        auto mask = detail::get_node_mask(node);
+
+        if (syscall(SYS_set_mempolicy, detail::mpol_preferred, mask.data(), detail::node_mask_bits + 1) != 0)
+        {
+            throw std::runtime_error("failed to prefer NUMA node " + std::to_string(node));
+        }
+
+        is_active = true;
+#else
+        throw std::runtime_error("NUMA placement is not supported on this platform");
+#endif
+    }
+
+    NumaNodeScope(const NumaNodeScope &) = delete;
+    NumaNodeScope &operator=(const NumaNodeScope &) = delete;
+
+    ~NumaNodeScope()
+    {
+#ifdef __linux__
+        if (is_active)
+        {
+            auto mask = previous_mode == detail::mpol_default ? nullptr : previous_mask.data();
+            syscall(SYS_set_mempolicy, previous_mode, mask, mask ? detail::node_mask_bits + 1 : 0);
+        }
+#endif
+    }
+
+private:
+    bool is_active = false;
+    int previous_mode = 0;
+    std::vector<unsigned long> previous_mask;
+};
+
+// Restricts the current thread to a set of cores until the scope ends, so that threads it creates meanwhile inherit
+// the restriction. Does nothing for an empty set. Only supported on Linux.
+class ThreadAffinityScope
+{
+public:
+    explicit ThreadAffinityScope(const std::vector<size_t> &cores)
+    {
+        if (cores.empty())
+        {
+            return;
+        }
+
+#ifdef __linux__
+        if (pthread_getaffinity_np(pthread_self(), sizeof(previous_set), &previous_set) != 0)
+        {
+            throw std::runtime_error("failed to get the thread affinity");
+        }
+
+        cpu_set_t set;
+        CPU_ZERO(&set);
+
+        for (auto core : cores)
+        {
+            if (core >= CPU_SETSIZE)
+            {
+                throw std::runtime_error("invalid core " + std::to_string(core));
+            }
+
+            CPU_SET(core, &set);
+        }
+
+        if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0)
+        {
+            throw std::runtime_error("failed to set the thread affinity");
+        }
+
+        is_active = true;
+#else
+        throw std::runtime_error("thread affinity is not supported on this platform");
+#endif
+    }
+
+    ThreadAffinityScope(const ThreadAffinityScope &) = delete;
+    ThreadAffinityScope &operator=(const ThreadAffinityScope &) = delete;
+
+    ~ThreadAffinityScope()
+    {
+#ifdef __linux__
+        if (is_active)
+        {
+            pthread_setaffinity_np(pthread_self(), sizeof(previous_set), &previous_set);
+        }
+#endif
+    }
+
+private:
+    bool is_active = false;
+
+#ifdef __linux__
+    cpu_set_t previous_set;
+#endif
+};
+} // namespace inference_engine
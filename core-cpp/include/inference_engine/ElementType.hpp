@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace inference_engine
+{
+enum class ElementType
+{
+    Float32,
+    Float16,
+    Int8,
+    Uint8,
+    Int16,
+    Int32,
+    Int64,
+    Bool,
+};
+
+// IEEE 754 half-precision value kept as its raw bits.
+struct Float16
+{
+    uint16_t bits;
+};
+
+inline size_t get_element_size(ElementType type)
+{
+    switch (type)
+    {
+    case ElementType::Float32:
+        return sizeof(float);
+    case ElementType::Float16:
+        return sizeof(Float16);
+    case ElementType::Int8:
+        return sizeof(int8_t);
+    case ElementType::Uint8:
+        return sizeof(uint8_t);
+    case ElementType::Int16:
+        return sizeof(int16_t);
+    case ElementType::Int32:
+        return sizeof(int32_t);
+    case ElementType::Int64:
+        return sizeof(int64_t);
+    case ElementType::Bool:
+        return sizeof(bool);
+    }
+
+    return 0;
+}
+
+template <typename T>
+constexpr ElementType get_element_type()
+{
+    if constexpr (std::is_same_v<T, float>)
+    {
+        return ElementType::Float32;
+    }
+    else if constexpr (std::is_same_v<T, Float16>)
+    {
+        return ElementType::Float16;
+    }
+    else if constexpr (std::is_same_v<T, int8_t>)
+    {
+        return ElementType::Int8;
+    }
+    else if constexpr (std::is_same_v<T, uint8_t>)
+    {
+        return ElementType::Uint8;
+    }
+    else if constexpr (std::is_same_v<T, int16_t>)
+    {
+        return ElementType::Int16;
+    }
+    else if constexpr (std::is_same_v<T, int32_t>)
+    {
+        return ElementType::Int32;
+    }
+    else if constexpr (std::is_same_v<T, int64_t>)
+    {
+        return ElementType::Int64;
+    }
+    else if constexpr (std::is_same_v<T, bool>)
+    {
+        return ElementType::Bool;
+    }
+    else
+    {
+        static_assert(sizeof(T) == 0, "unsupported element type");
+    }
+}
+} // namespace inference_engine
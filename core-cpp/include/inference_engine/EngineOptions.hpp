@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <vector>
+
+namespace inference_engine
+{
+enum class ExecutionMode
+{
+    Sequential,
+    Parallel,
+};
+
+enum class OptimizationLevel
+{
+    Disabled,
+    Basic,
+    Extended,
+    All,
+};
+
+struct EngineOptions
+{
+    // Number of threads used to parallelize the execution within nodes.
+    // 0 lets the backend pick its own default.
+    size_t intra_op_num_threads = 1;
+
+    // Number of threads used to parallelize the execution of the graph across nodes.
+    // 0 lets the backend pick its own default. Only used by ORT in parallel execution mode.
+    size_t inter_op_num_threads = 0;
+
+    // Whether independent nodes of the graph may be executed concurrently. Only used by ORT.
+    ExecutionMode execution_mode = ExecutionMode::Sequential;
+
+    // Graph optimizations applied when the model is loaded. Only used by ORT.
+    OptimizationLevel optimization_level = OptimizationLevel::All;
+
+    // Directory keeping ORT-format copies of optimized models, keyed by the model and its size, the optimization level
+    // and the ORT version, so that later engines only deserialize them. Empty disables the cache, and a directory that
+    // cannot be created or written leaves models uncached. Models optimized at the All level
+    // may be specific to the CPU they were optimized on, so the directory should not be shared across machines.
+    // Only used by ORT.
+    std::filesystem::path optimized_model_cache_dir;
+
+    // Whether to run on the global thread pools of the process-wide environment instead of per-engine ones.
+    // The pools are sized by the thread counts of the engine that creates the environment. Only used by ORT.
+    bool use_global_thread_pool = false;
+
+    // Cores that each intra-op thread other than the one calling run is pinned to, as intra_op_num_threads - 1 sets of
+    // core indices starting from 0. Empty leaves placement to the OS. With the global thread pool, the sets of the
+    // engine creating the environment apply. TFLite cannot pin its threads one by one, so it only confines the threads
+    // of the XNNPACK delegate to all of the cores and rejects them without it. Only supported on Linux for TFLite.
+    std::vector<std::vector<size_t>> intra_op_thread_affinities;
+
+    // NUMA node that the model pages and engine-owned buffers are placed on, and that is preferred for memory allocated
+    // while creating the engine and reshaping it. Memory that the backend allocates while running follows the running
+    // thread, so the engine should be run from threads on the node. Negative leaves placement to the OS. Only supported
+    // on Linux.
+    int numa_node = -1;
+
+    // Whether idle intra-op and inter-op threads spin for new work before sleeping, which lowers the latency of
+    // back-to-back runs but burns CPU between them. With the global thread pool, the setting of the engine creating
+    // the environment applies. TFLite exposes no control over its thread pools and rejects disabling it.
+    bool allow_spinning = true;
+
+    // Whether quantized int8 and uint8 inputs and outputs are exposed as float tensors that are converted on every run.
+    // Only used by TFLite.
+    bool use_float_io = false;
+
+    // Number of input-shape combinations whose allocated interpreters are kept so that reshaping back to one of them
+    // does not plan and allocate again. Every cached interpreter holds its own tensor arena, so the default of 1 keeps
+    // only the current one. Values below 1 are treated as 1. Only used by TFLite.
+    size_t shape_cache_capacity = 1;
+
+    // Whether to run supported operators on the XNNPACK delegate, with weights packed once per model and shared by all
+    // engines of the model, such as the ones of an engine pool. Otherwise TFLite applies its default delegates.
+    // Caller buffers bound to delegated tensors may be read up to 16 bytes past their end. Delegated graphs cannot be
+    // resized, so that a reshape missing the shape cache builds a new interpreter with a new delegate and thread pool,
+    // which only reuses the packed weights. Models reshaped between a few shapes should have the shape cache hold them
+    // all. Only used by TFLite.
+    bool use_xnnpack = false;
+
+    // Number of threads of the XNNPACK delegate. 0 uses intra_op_num_threads. Only used by TFLite.
+    size_t xnnpack_num_threads = 0;
+
+    // Whether the XNNPACK delegate also runs 8-bit quantized operators. Only used by TFLite.
+    bool xnnpack_enable_quantized = true;
+
+    // Whether the XNNPACK delegate computes float operators in half precision, which is faster on CPUs with native fp16
+    // arithmetic at the cost of accuracy. Only used by TFLite.
+    bool xnnpack_force_fp16 = false;
+
+    // Whether the engine keeps runtime statistics. Disabled engines skip all of the bookkeeping.
+    bool enable_stats = false;
+
+    // Whether per-operator timings can be collected with start_profiling and stop_profiling. ORT can only profile a
+    // session from its creation, so that it creates a session of its own for the engine on every start.
+    bool enable_profiling = false;
+};
+} // namespace inference_engine
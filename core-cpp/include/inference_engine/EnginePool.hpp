@@ -0,0 +1,138 @@
+#pragma once
+
+#include "inference_engine/InferenceEngine.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace inference_engine
+{
+// Hands out engines that share one loaded model so that many threads can run it concurrently.
+// Engines are created lazily up to the capacity and keep the shapes and data bindings of their previous user.
+class EnginePool
+{
+public:
+    class Lease
+    {
+    public:
+        Lease(EnginePool &pool, std::unique_ptr<InferenceEngine> engine)
+            : pool(&pool)
+            , engine(std::move(engine))
+        {
+        }
+
+        Lease(Lease &&other) = default;
+
+        Lease &operator=(Lease &&other)
+        {
+            if (this != &other)
+            {
+                release();
+                pool = other.pool;
+                engine = std::move(other.engine);
+            }
+
+            return *this;
+        }
+
+        ~Lease()
+        {
+            release();
+        }
+
+        InferenceEngine &operator*() const
+        {
+            return *engine;
+        }
+
+        InferenceEngine *operator->() const
+        {
+            return engine.get();
+        }
+
+        InferenceEngine *get() const
+        {
+            return engine.get();
+        }
+
+        void release()
+        {
+            if (engine)
+            {
+                pool->checkin(std::move(engine));
+            }
+        }
+
+    private:
+        EnginePool *pool;
+        std::unique_ptr<InferenceEngine> engine;
+    };
+
+    explicit EnginePool(size_t capacity)
+        : capacity(capacity > 0 ? capacity : std::max<size_t>(std::thread::hardware_concurrency(), 1))
+    {
+    }
+
+    virtual ~EnginePool() = default;
+
+    size_t get_capacity() const
+    {
+        return capacity;
+    }
+
+    Lease checkout()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+
+        condition.wait(lock, [this] { return !idle_engines.empty() || engine_count < capacity; });
+
+        if (!idle_engines.empty())
+        {
+            auto engine = std::move(idle_engines.back());
+            idle_engines.pop_back();
+            return Lease(*this, std::move(engine));
+        }
+
+        engine_count++;
+        lock.unlock();
+
+        try
+        {
+            return Lease(*this, create_engine());
+        }
+        catch (...)
+        {
+            lock.lock();
+            engine_count--;
+            condition.notify_one();
+            throw;
+        }
+    }
+
+protected:
+    virtual std::unique_ptr<InferenceEngine> create_engine() = 0;
+
+private:
+    const size_t capacity;
+
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::vector<std::unique_ptr<InferenceEngine>> idle_engines;
+    size_t engine_count = 0;
+
+    void checkin(std::unique_ptr<InferenceEngine> engine)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            idle_engines.push_back(std::move(engine));
+        }
+
+        condition.notify_one();
+    }
+};
+} // namespace inference_engine
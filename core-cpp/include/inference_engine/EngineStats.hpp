@@ -0,0 +1,225 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+
+namespace inference_engine
+{
+// Runtime statistics of an engine since it was created or its statistics were last reset.
+// Percentiles are estimated from a histogram and are within 1/8 of the actual run latency.
+struct EngineStats
+{
+    uint64_t run_count = 0;
+    std::chrono::nanoseconds run_time_total{0};
+    std::chrono::nanoseconds run_time_min{0};
+    std::chrono::nanoseconds run_time_max{0};
+    std::chrono::nanoseconds run_time_p50{0};
+    std::chrono::nanoseconds run_time_p99{0};
+
+    uint64_t reshape_count = 0;
+    std::chrono::nanoseconds reshape_time_total{0};
+
+    // Bytes of caller buffers bound to inputs and outputs.
+    uint64_t bytes_bound = 0;
+};
+
+// Collects engine statistics with relaxed atomics, so that they can be read while another thread runs the engine.
+// Run latencies go into log-linear buckets: each power of two is split into 8 buckets of equal width.
+class EngineStatsRecorder
+{
+public:
+    EngineStatsRecorder()
+    {
+        reset();
+    }
+
+    EngineStatsRecorder(const EngineStatsRecorder &) = delete;
+    EngineStatsRecorder &operator=(const EngineStatsRecorder &) = delete;
+
+    void record_run(std::chrono::nanoseconds duration)
+    {
+        auto ns = static_cast<uint64_t>(duration.count());
+
+        run_count.fetch_add(1, std::memory_order_relaxed);
+        run_time_total.fetch_add(ns, std::memory_order_relaxed);
+        buckets[get_bucket(ns)].fetch_add(1, std::memory_order_relaxed);
+
+        auto min = run_time_min.load(std::memory_order_relaxed);
+        while (ns < min && !run_time_min.compare_exchange_weak(min, ns, std::memory_order_relaxed))
+        {
+        }
+
+        auto max = run_time_max.load(std::memory_order_relaxed);
+        while (ns > max && !run_time_max.compare_exchange_weak(max, ns, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    void record_reshape(std::chrono::nanoseconds duration)
+    {
+        reshape_count.fetch_add(1, std::memory_order_relaxed);
+        reshape_time_total.fetch_add(static_cast<uint64_t>(duration.count()), std::memory_order_relaxed);
+    }
+
+    void record_binding(uint64_t byte_count)
+    {
+        bytes_bound.fetch_add(byte_count, std::memory_order_relaxed);
+    }
+
+    EngineStats get_stats() const
+    {
+        EngineStats stats;
+        stats.run_count = run_count.load(std::memory_order_relaxed);
+        stats.run_time_total = std::chrono::nanoseconds(run_time_total.load(std::memory_order_relaxed));
+        stats.run_time_min = std::chrono::nanoseconds(stats.run_count > 0 ? run_time_min.load(std::memory_order_relaxed) : 0);
+        stats.run_time_max = std::chrono::nanoseconds(run_time_max.load(std::memory_order_relaxed));
+        stats.reshape_count = reshape_count.load(std::memory_order_relaxed);
+        stats.reshape_time_total = std::chrono::nanoseconds(reshape_time_total.load(std::memory_order_relaxed));
+        stats.bytes_bound = bytes_bound.load(std::memory_order_relaxed);
+
+        std::array<uint64_t, bucket_count> counts;
+        uint64_t count = 0;
+
+        for (auto i = 0; i < bucket_count; i++)
+        {
+            counts[i] = buckets[i].load(std::memory_order_relaxed);
+            count += counts[i];
+        }
+
+        stats.run_time_p50 = get_percentile(counts, count, 0.5, stats.run_time_min, stats.run_time_max);
+        stats.run_time_p99 = get_percentile(counts, count, 0.99, stats.run_time_min, stats.run_time_max);
+
+        return stats;
+    }
+
+    // Not atomic as a whole: runs recorded while resetting may be partly kept.
+    void reset()
+    {
+        run_count.store(0, std::memory_order_relaxed);
+        run_time_total.store(0, std::memory_order_relaxed);
+        run_time_min.store(UINT64_MAX, std::memory_order_relaxed);
+        run_time_max.store(0, std::memory_order_relaxed);
+        reshape_count.store(0, std::memory_order_relaxed);
+        reshape_time_total.store(0, std::memory_order_relaxed);
+        bytes_bound.store(0, std::memory_order_relaxed);
+
+        for (auto &bucket : buckets)
+        {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+    }
+
+private:
+    static constexpr size_t sub_bucket_bits = 3;
+    static constexpr size_t sub_bucket_count = 1 << sub_bucket_bits;
+
+    // Values below 2 * sub_bucket_count get a bucket each, and every power of two above gets sub_bucket_count.
+    static constexpr size_t bucket_count = 2 * sub_bucket_count + (64 - sub_bucket_bits - 1) * sub_bucket_count;
+
+    static size_t get_bucket(uint64_t value)
+    {
+        if (value < 2 * sub_bucket_count)
+        {
+            return static_cast<size_t>(value);
+        }
+
+        size_t exponent = 63;
+        while (!(value >> exponent))
+        {
+            exponent--;
+        }
+
+        auto sub_bucket = static_cast<size_t>(value >> (exponent - sub_bucket_bits)) & (sub_bucket_count - 1);
+        return 2 * sub_bucket_count + (exponent - sub_bucket_bits - 1) * sub_bucket_count + sub_bucket;
+    }
+
+    // Midpoint of the values that fall into the bucket.
+    static uint64_t get_bucket_value(size_t bucket)
+    {
+        if (bucket < 2 * sub_bucket_count)
+        {
+            return bucket;
+        }
+
+        auto exponent = (bucket - 2 * sub_bucket_count) / sub_bucket_count + sub_bucket_bits + 1;
+        auto sub_bucket = (bucket - 2 * sub_bucket_count) % sub_bucket_count;
+        auto width = uint64_t(1) << (exponent - sub_bucket_bits);
+
+        return (uint64_t(1) << exponent) + sub_bucket * width + width / 2;
+    }
+
+    static std::chrono::nanoseconds get_percentile(const std::array<uint64_t, bucket_count> &counts, uint64_t count, double percentile, std::chrono::nanoseconds min, std::chrono::nanoseconds max)
+    {
+        if (count == 0)
+        {
+            return std::chrono::nanoseconds(0);
+        }
+
+        auto rank = std::max<uint64_t>(static_cast<uint64_t>(percentile * count + 0.5), 1);
+        uint64_t seen = 0;
+
+        for (auto i = 0; i < bucket_count; i++)
+        {
+            seen += counts[i];
+
+            if (seen >= rank)
+            {
+                auto value = std::chrono::nanoseconds(get_bucket_value(i));
+                return std::clamp(value, min, max);
+            }
+        }
+
+        return max;
+    }
+
+    std::atomic<uint64_t> run_count;
+    std::atomic<uint64_t> run_time_total;
+    std::atomic<uint64_t> run_time_min;
+    std::atomic<uint64_t> run_time_max;
+    std::atomic<uint64_t> reshape_count;
+    std::atomic<uint64_t> reshape_time_total;
+    std::atomic<uint64_t> bytes_bound;
+    std::array<std::atomic<uint64_t>, bucket_count> buckets;
+};
+
+// Records the time from its construction to its destruction into a recorder, unless the recorder is null or the
+// scope is left by an exception.
+class StatsTimer
+{
+public:
+    using Record = void (EngineStatsRecorder::*)(std::chrono::nanoseconds);
+
+    StatsTimer(EngineStatsRecorder *recorder, Record record)
+        : recorder(recorder)
+        , record(record)
+    {
+        if (recorder)
+        {
+            exception_count = std::uncaught_exceptions();
+            start = std::chrono::steady_clock::now();
+        }
+    }
+
+    StatsTimer(const StatsTimer &) = delete;
+    StatsTimer &operator=(const StatsTimer &) = delete;
+
+    ~StatsTimer()
+    {
+        if (recorder && std::uncaught_exceptions() == exception_count)
+        {
+            (recorder->*record)(std::chrono::steady_clock::now() - start);
+        }
+    }
+
+private:
+    EngineStatsRecorder *recorder;
+    Record record;
+    int exception_count = 0;
+    std::chrono::steady_clock::time_point start;
+};
+} // namespace inference_engine
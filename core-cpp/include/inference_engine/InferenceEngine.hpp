@@ -1,13 +1,48 @@
 #pragma once
 
+#include "inference_engine/ElementType.hpp"
+#include "inference_engine/EngineStats.hpp"
+#include "inference_engine/ProfileTrace.hpp"
+#include "inference_engine/Span.hpp"
+
+#include <chrono>
 #include <cstddef>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <stdexcept>
 #include <vector>
 
 namespace inference_engine
 {
+// Durations of warming up one set of input shapes.
+struct WarmupTiming
+{
+    std::chrono::nanoseconds reshape{0};
+    std::chrono::nanoseconds first_run{0};
+    std::chrono::nanoseconds last_run{0};
+};
+
+// Number of elements of a tensor of the given shape.
+inline size_t count_elements(Span<const size_t> shape)
+{
+    size_t count = 1;
+
+    for (auto size : shape)
+    {
+        count *= size;
+    }
+
+    return count;
+}
+
 class InferenceEngine
 {
 public:
+    // Invoked once a run started by run_async has finished, with the exception it failed with, if any.
+    using RunCallback = std::function<void(std::exception_ptr)>;
+
     virtual ~InferenceEngine() = default;
 
     virtual size_t get_input_count() const = 0;
@@ -16,15 +51,156 @@ public:
     virtual const std::vector<size_t> &get_input_shape(size_t index) const = 0;
     virtual const std::vector<size_t> &get_output_shape(size_t index) const = 0;
 
-    virtual void set_input_shape(size_t index, const std::vector<size_t> &shape) = 0;
-    virtual void set_output_shape(size_t index, const std::vector<size_t> &shape) = 0;
+    // Setting the current shapes again allocates nothing, so callers may pass their shapes on every run. Reshaping may
+    // move the engine-owned buffers of any tensor, so their data pointers must be fetched again afterwards.
+    virtual void set_input_shape(size_t index, Span<const size_t> shape) = 0;
+
+    // Reshapes all inputs at once, so that backends plan and allocate only once.
+    virtual void set_input_shapes(Span<const Span<const size_t>> shapes) = 0;
+
+    virtual void set_output_shape(size_t index, Span<const size_t> shape) = 0;
+
+    void set_input_shape(size_t index, const std::vector<size_t> &shape)
+    {
+        set_input_shape(index, Span<const size_t>(shape));
+    }
+
+    void set_input_shapes(const std::vector<std::vector<size_t>> &shapes)
+    {
+        set_input_shapes(get_spans(shapes));
+    }
+
+    void set_output_shape(size_t index, const std::vector<size_t> &shape)
+    {
+        set_output_shape(index, Span<const size_t>(shape));
+    }
+
+    virtual ElementType get_input_element_type(size_t index) const = 0;
+    virtual ElementType get_output_element_type(size_t index) const = 0;
+
+    // Buffers hold the element count of the shape times the element size of the tensor.
+    virtual void *get_input_raw_data(size_t index) = 0;
+    virtual const void *get_output_raw_data(size_t index) const = 0;
+
+    // Caller buffers must stay valid while bound. With XNNPACK, TFLite may read up to 16 bytes past the end of input
+    // buffers, so those need that much readable memory after them.
+    virtual void set_input_raw_data(size_t index, const void *data) = 0;
+    virtual void set_output_raw_data(size_t index, void *data) = 0;
+
+    // Registers buffers for all inputs and outputs up front, null standing for the engine-owned ones, and returns the
+    // id that selects them for the following runs. The engine's own bindings are buffer set 0, and setting data
+    // changes the selected set. Reshaping drops all registered sets.
+    virtual size_t register_buffer_set(const std::vector<const void *> &inputs, const std::vector<void *> &outputs) = 0;
+    virtual void select_buffer_set(size_t id) = 0;
 
-    virtual float *get_input_data(size_t index) = 0;
-    virtual const float *get_output_data(size_t index) const = 0;
+    // Releases a registered buffer set, whose id later registrations may hand out again. Selecting a released id, like
+    // releasing the selected set, selects set 0.
+    virtual void unregister_buffer_set(size_t id) = 0;
 
-    virtual void set_input_data(size_t index, const float *data) = 0;
-    virtual void set_output_data(size_t index, float *data) = 0;
+    // Number of buffer set slots including the engine's own, which reshaping drops back to 1.
+    virtual size_t get_buffer_set_count() const = 0;
 
+    // Bytes of the model data, which engines of a pool share, and of the engine-owned buffers. Memory that the backend
+    // allocates for intermediate tensors is not included.
+    virtual size_t get_memory_footprint() const = 0;
+
+    template <typename T>
+    T *get_input_data(size_t index)
+    {
+        check_element_type(get_element_type<T>(), get_input_element_type(index));
+        return static_cast<T *>(get_input_raw_data(index));
+    }
+
+    template <typename T>
+    const T *get_output_data(size_t index) const
+    {
+        check_element_type(get_element_type<T>(), get_output_element_type(index));
+        return static_cast<const T *>(get_output_raw_data(index));
+    }
+
+    template <typename T>
+    void set_input_data(size_t index, const T *data)
+    {
+        check_element_type(get_element_type<T>(), get_input_element_type(index));
+        set_input_raw_data(index, data);
+    }
+
+    template <typename T>
+    void set_output_data(size_t index, T *data)
+    {
+        check_element_type(get_element_type<T>(), get_output_element_type(index));
+        set_output_raw_data(index, data);
+    }
+
+    float *get_input_data(size_t index)
+    {
+        return get_input_data<float>(index);
+    }
+
+    const float *get_output_data(size_t index) const
+    {
+        return get_output_data<float>(index);
+    }
+
+    void set_input_data(size_t index, const float *data)
+    {
+        set_input_data<float>(index, data);
+    }
+
+    void set_output_data(size_t index, float *data)
+    {
+        set_output_data<float>(index, data);
+    }
+
+    // Runs each set of input shapes the given number of times on zeroed inputs, so that backend caches and arenas are
+    // primed before the first real run, and returns the timings of each set. The engine is left with the input shapes
+    // of the last set, all tensors bound to its own buffers and no registered buffer sets. Warm-up is left out of the
+    // engine stats.
+    virtual std::vector<WarmupTiming> warmup(const std::vector<std::vector<std::vector<size_t>>> &shape_sets, size_t iterations) = 0;
+
+    // Statistics of runs, reshapes and bindings, which must have been enabled in the engine options.
+    virtual EngineStats get_stats() const = 0;
+    virtual void reset_stats() = 0;
+
+    // Collects the timings of every operator run between the two calls, which must have been enabled in the engine
+    // options. See write_chrome_trace for saving them.
+    virtual void start_profiling() = 0;
+    virtual ProfileTrace stop_profiling() = 0;
+
+    // A frame loop that keeps its shapes and binds buffers or reads data pointers between runs allocates nothing
+    // outside of run itself, where the backend may still allocate.
     virtual void run() = 0;
+
+    // Starts a run without blocking the caller. The engine and its bound buffers must be left untouched
+    // until the callback is invoked; the callback is not invoked if run_async itself throws.
+    virtual void run_async(RunCallback callback) = 0;
+
+    std::future<void> run_async()
+    {
+        auto promise = std::make_shared<std::promise<void>>();
+        auto future = promise->get_future();
+
+        run_async([promise](std::exception_ptr error) {
+            if (error)
+            {
+                promise->set_exception(error);
+            }
+            else
+            {
+                promise->set_value();
+            }
+        });
+
+        return future;
+    }
+
+private:
+    static void check_element_type(ElementType expected, ElementType actual)
+    {
+        if (expected != actual)
+        {
+            throw std::runtime_error("element type mismatch");
+        }
+    }
 };
 } // namespace inference_engine
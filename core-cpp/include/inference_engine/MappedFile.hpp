@@ -0,0 +1,135 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <stdexcept>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace inference_engine
+{
+// Read-only shared mapping of a whole file. Pages come from the page cache, so processes mapping the same file share them.
+class MappedFile
+{
+public:
+    explicit MappedFile(const std::filesystem::path &path)
+    {
+#ifdef _WIN32
+        auto file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            throw std::runtime_error("failed to open file: " + path.string());
+        }
+
+        LARGE_INTEGER file_size;
+
+        if (!GetFileSizeEx(file, &file_size))
+        {
+            CloseHandle(file);
+            throw std::runtime_error("failed to get the size of file: " + path.string());
+        }
+
+        size_bytes = static_cast<size_t>(file_size.QuadPart);
+
+        if (size_bytes > 0)
+        {
+            auto mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            CloseHandle(file);
+
+            if (!mapping)
+            {
+                throw std::runtime_error("failed to map file: " + path.string());
+            }
+
+            address = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            CloseHandle(mapping);
+
+            if (!address)
+            {
+                throw std::runtime_error("failed to map file: " + path.string());
+            }
+        }
+        else
+        {
+            CloseHandle(file);
+        }
+#else
+        auto file = open(path.c_str(), O_RDONLY);
+
+        if (file < 0)
+        {
+            throw std::runtime_error("failed to open file: " + path.string());
+        }
+
+        struct stat file_status;
+
+        if (fstat(file, &file_status) != 0)
+        {
+            close(file);
+            throw std::runtime_error("failed to get the size of file: " + path.string());
+        }
+
+        size_bytes = static_cast<size_t>(file_status.st_size);
+
+        if (size_bytes > 0)
+        {
+            address = mmap(nullptr, size_bytes, PROT_READ, MAP_SHARED, file, 0);
+            close(file);
+
+            if (address == MAP_FAILED)
+            {
+                address = nullptr;
+                throw std::runtime_error("failed to map file: " + path.string());
+            }
+        }
+        else
+        {
+            close(file);
+        }
+#endif
+    }
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    ~MappedFile()
+    {
+        if (address)
+        {
+#ifdef _WIN32
+            UnmapViewOfFile(address);
+#else
+            munmap(address, size_bytes);
+#endif
+        }
+    }
+
+    const void *data() const
+    {
+        return address;
+    }
+
+    size_t size() const
+    {
+        return size_bytes;
+    }
+
+private:
+    void *address = nullptr;
+    size_t size_bytes = 0;
+};
+} // namespace inference_engine
@@ -0,0 +1,343 @@
+#pragma once
+
+#include "inference_engine/InferenceEngine.hpp"
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace inference_engine
+{
+// Maps model ids to loaders and keeps the engines loaded from them within a memory budget.
+// Engines are loaded on their first acquisition, after the least recently used engines that no handle refers to have
+// been destroyed to make room for them. They are loaded again when they are next acquired. Engines in use are never
+// destroyed, so the budget is exceeded while they do not fit.
+// Handles to the same model share one engine, which callers synchronize as any other engine. The registry must
+// outlive its handles.
+class ModelRegistry
+{
+private:
+    struct Entry;
+
+public:
+    using Loader = std::function<std::unique_ptr<InferenceEngine>()>;
+
+    // Keeps the engine of a model loaded while it or any of its copies exists.
+    class Handle
+    {
+    public:
+        Handle() = default;
+
+        Handle(const Handle &other)
+            : registry(other.registry)
+            , entry(other.entry)
+        {
+            if (entry)
+            {
+                registry->add_reference(*entry);
+            }
+        }
+
+        Handle(Handle &&other) noexcept
+            : registry(other.registry)
+            , entry(std::exchange(other.entry, nullptr))
+        {
+        }
+
+        Handle &operator=(Handle other) noexcept
+        {
+            std::swap(registry, other.registry);
+            std::swap(entry, other.entry);
+            return *this;
+        }
+
+        ~Handle()
+        {
+            release();
+        }
+
+        InferenceEngine &operator*() const
+        {
+            return *entry->engine;
+        }
+
+        InferenceEngine *operator->() const
+        {
+            return entry->engine.get();
+        }
+
+        InferenceEngine *get() const
+        {
+            return entry ? entry->engine.get() : nullptr;
+        }
+
+        explicit operator bool() const
+        {
+            return entry != nullptr;
+        }
+
+        void release()
+        {
+            if (entry)
+            {
+                registry->release(*std::exchange(entry, nullptr));
+            }
+        }
+
+    private:
+        friend class ModelRegistry;
+
+        Handle(ModelRegistry &registry, Entry &entry)
+            : registry(&registry)
+            , entry(&entry)
+        {
+        }
+
+        ModelRegistry *registry = nullptr;
+        Entry *entry = nullptr;
+    };
+
+    explicit ModelRegistry(size_t memory_budget)
+        : memory_budget(memory_budget)
+    {
+    }
+
+    ModelRegistry(const ModelRegistry &) = delete;
+    ModelRegistry &operator=(const ModelRegistry &) = delete;
+
+    // The engine of the model is accounted for with the given footprint in bytes. A footprint of 0 takes the one the
+    // engine reports once loaded, so that room is only made for it before loads after the first one.
+    void register_model(const std::string &id, Loader loader, size_t footprint = 0)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        if (!entries.try_emplace(id, std::move(loader), footprint).second)
+        {
+            throw std::runtime_error("model id is already registered: " + id);
+        }
+    }
+
+    void unregister_model(const std::string &id)
+    {
+        std::unique_ptr<InferenceEngine> engine;
+        std::lock_guard<std::mutex> lock(mutex);
+
+        auto &entry = get_entry(id);
+
+        if (entry.reference_count > 0)
+        {
+            throw std::runtime_error("model is in use: " + id);
+        }
+
+        if (entry.engine)
+        {
+            remove_idle(entry);
+            memory_usage -= entry.footprint;
+            engine = std::move(entry.engine);
+        }
+
+        entries.erase(id);
+    }
+
+    // Loads the engine of the model unless it is loaded already. Concurrent acquisitions of a model that is being
+    // loaded wait for its engine.
+    Handle acquire(const std::string &id)
+    {
+        std::vector<std::unique_ptr<InferenceEngine>> evicted_engines;
+        std::unique_lock<std::mutex> lock(mutex);
+
+        auto &entry = get_entry(id);
+
+        // The reference keeps the entry registered and its engine loaded from here on.
+        entry.reference_count++;
+        condition.wait(lock, [&entry] { return !entry.is_loading; });
+
+        if (entry.engine)
+        {
+            remove_idle(entry);
+            return Handle(*this, entry);
+        }
+
+        // The expected footprint is accounted for while loading, so that concurrent loads make room for each other.
+        entry.is_loading = true;
+        entry.footprint = entry.declared_footprint > 0 ? entry.declared_footprint : entry.reported_footprint;
+        memory_usage += entry.footprint;
+        evicted_engines = evict();
+        lock.unlock();
+
+        std::unique_ptr<InferenceEngine> engine;
+
+        try
+        {
+            evicted_engines.clear();
+            engine = entry.loader();
+
+            if (!engine)
+            {
+                throw std::runtime_error("model loader returned no engine");
+            }
+
+            if (entry.declared_footprint == 0)
+            {
+                entry.reported_footprint = engine->get_memory_footprint();
+            }
+        }
+        catch (...)
+        {
+            lock.lock();
+            memory_usage -= entry.footprint;
+            entry.footprint = 0;
+            entry.is_loading = false;
+            entry.reference_count--;
+            condition.notify_all();
+            throw;
+        }
+
+        lock.lock();
+        memory_usage -= entry.footprint;
+        entry.footprint = entry.declared_footprint > 0 ? entry.declared_footprint : entry.reported_footprint;
+        memory_usage += entry.footprint;
+        entry.engine = std::move(engine);
+        entry.is_loading = false;
+        evicted_engines = evict();
+        condition.notify_all();
+
+        return Handle(*this, entry);
+    }
+
+    bool is_loaded(const std::string &id) const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = entries.find(id);
+        return it != entries.end() && it->second.engine;
+    }
+
+    // Sum of the footprints of the loaded engines.
+    size_t get_memory_usage() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return memory_usage;
+    }
+
+    size_t get_memory_budget() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return memory_budget;
+    }
+
+    void set_memory_budget(size_t memory_budget)
+    {
+        std::vector<std::unique_ptr<InferenceEngine>> evicted_engines;
+        std::lock_guard<std::mutex> lock(mutex);
+
+        this->memory_budget = memory_budget;
+        evicted_engines = evict();
+    }
+
+private:
+    struct Entry
+    {
+        Entry(Loader loader, size_t declared_footprint)
+            : loader(std::move(loader))
+            , declared_footprint(declared_footprint)
+        {
+        }
+
+        const Loader loader;
+        const size_t declared_footprint;
+
+        // Footprint the engine reported when it was last loaded, for models without a declared one.
+        size_t reported_footprint = 0;
+
+        std::unique_ptr<InferenceEngine> engine;
+
+        // Footprint accounted for in the memory usage while the engine is loaded or loading.
+        size_t footprint = 0;
+        size_t reference_count = 0;
+        bool is_loading = false;
+
+        // Whether the engine is loaded and unreferenced, and its position in the idle entries then.
+        bool is_idle = false;
+        std::list<Entry *>::iterator idle_position;
+    };
+
+    Entry &get_entry(const std::string &id)
+    {
+        auto it = entries.find(id);
+
+        if (it == entries.end())
+        {
+            throw std::runtime_error("unknown model id: " + id);
+        }
+
+        return it->second;
+    }
+
+    void remove_idle(Entry &entry)
+    {
+        if (entry.is_idle)
+        {
+            idle_entries.erase(entry.idle_position);
+            entry.is_idle = false;
+        }
+    }
+
+    void add_reference(Entry &entry)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        entry.reference_count++;
+    }
+
+    void release(Entry &entry)
+    {
+        std::vector<std::unique_ptr<InferenceEngine>> evicted_engines;
+        std::lock_guard<std::mutex> lock(mutex);
+
+        if (--entry.reference_count == 0)
+        {
+            entry.idle_position = idle_entries.insert(idle_entries.begin(), &entry);
+            entry.is_idle = true;
+            evicted_engines = evict();
+        }
+    }
+
+    // Unloads idle engines, least recently used first, until the loaded ones fit the budget. The engines are returned
+    // so that they are destroyed after the lock is released.
+    std::vector<std::unique_ptr<InferenceEngine>> evict()
+    {
+        std::vector<std::unique_ptr<InferenceEngine>> evicted_engines;
+
+        while (memory_usage > memory_budget && !idle_entries.empty())
+        {
+            auto entry = idle_entries.back();
+            idle_entries.pop_back();
+            entry->is_idle = false;
+
+            memory_usage -= entry->footprint;
+            entry->footprint = 0;
+            evicted_engines.push_back(std::move(entry->engine));
+        }
+
+        return evicted_engines;
+    }
+
+    mutable std::mutex mutex;
+    std::condition_variable condition;
+
+    std::unordered_map<std::string, Entry> entries;
+
+    // Loaded engines without references, most recently used first.
+    std::list<Entry *> idle_entries;
+
+    size_t memory_budget;
+    size_t memory_usage = 0;
+};
+} // namespace inference_engine
@@ -0,0 +1,234 @@
+#pragma once
+
+#include "inference_engine/BufferSetBinding.hpp"
+#include "inference_engine/InferenceEngine.hpp"
+#include "inference_engine/Simd.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace inference_engine
+{
+namespace detail
+{
+inline void overlap_add_scalar(const float *frame, const float *window, float *output, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        output[i] += window[i] * frame[i];
+    }
+}
+
+#if defined(INFERENCE_ENGINE_AVX2_TARGET)
+INFERENCE_ENGINE_AVX2_TARGET inline size_t overlap_add_avx2(const float *frame, const float *window, float *output, size_t count)
+{
+    size_t i = 0;
+
+    for (; i + 8 <= count; i += 8)
+    {
+        auto product = _mm256_mul_ps(_mm256_loadu_ps(window + i), _mm256_loadu_ps(frame + i));
+        _mm256_storeu_ps(output + i, _mm256_add_ps(_mm256_loadu_ps(output + i), product));
+    }
+
+    return i;
+}
+#endif
+
+#if defined(INFERENCE_ENGINE_NEON)
+inline size_t overlap_add_neon(const float *frame, const float *window, float *output, size_t count)
+{
+    size_t i = 0;
+
+    for (; i + 4 <= count; i += 4)
+    {
+        vst1q_f32(output + i, vfmaq_f32(vld1q_f32(output + i), vld1q_f32(window + i), vld1q_f32(frame + i)));
+    }
+
+    return i;
+}
+#endif
+
+// output += window * frame
+inline void overlap_add(const float *frame, const float *window, float *output, size_t count)
+{
+    size_t i = 0;
+
+#if defined(INFERENCE_ENGINE_AVX2_TARGET)
+    if (has_avx2())
+    {
+        i = overlap_add_avx2(frame, window, output, count);
+    }
+#elif defined(INFERENCE_ENGINE_NEON)
+    i = overlap_add_neon(frame, window, output, count);
+#endif
+
+    overlap_add_scalar(frame + i, window + i, output + i, count - i);
+}
+} // namespace detail
+
+struct OverlapAddStreamOptions
+{
+    // Number of output samples of each run.
+    size_t window_size = 0;
+
+    // Number of samples between the starts of consecutive windows.
+    size_t hop_size = 0;
+
+    // Number of samples after each window that the model sees without producing output for them.
+    size_t lookahead = 0;
+
+    // Weights applied to each output window before it is overlap-added. Leave empty to add outputs unweighted.
+    std::vector<float> synthesis_window;
+};
+
+// Runs a model on overlapping windows of a sample stream and overlap-adds its outputs.
+// The model reads window_size + lookahead samples from float input 0 and writes window_size samples to float output 0.
+// Pushed samples are kept contiguous so that every window is bound as the engine input in place, through one buffer
+// set per window position. Destroying the stream releases those sets and selects the engine's own buffer set again.
+class OverlapAddStream
+{
+public:
+    // Receives finished output samples, hop_size of them per run.
+    using OutputCallback = std::function<void(const float *data, size_t size)>;
+
+    OverlapAddStream(InferenceEngine &engine, const OverlapAddStreamOptions &options, OutputCallback on_output)
+        : engine(engine)
+        , window_size(options.window_size)
+        , hop_size(options.hop_size)
+        , input_size(options.window_size + options.lookahead)
+        , synthesis_window(options.synthesis_window)
+        , on_output(std::move(on_output))
+    {
+        if (hop_size == 0 || hop_size > window_size)
+        {
+            throw std::runtime_error("hop size must be between 1 and the window size");
+        }
+
+        if (synthesis_window.empty())
+        {
+            synthesis_window.assign(window_size, 1);
+        }
+        else if (synthesis_window.size() != window_size)
+        {
+            throw std::runtime_error("synthesis window size does not match the window size");
+        }
+
+        if (engine.get_input_element_type(0) != ElementType::Float32 || engine.get_output_element_type(0) != ElementType::Float32)
+        {
+            throw std::runtime_error("element type mismatch");
+        }
+
+        if (count_elements(engine.get_input_shape(0)) != input_size || count_elements(engine.get_output_shape(0)) != window_size)
+        {
+            throw std::runtime_error("engine shapes do not match the window and lookahead sizes");
+        }
+
+        // Buffers hold several hops beyond one window, so that they are compacted only once every few runs.
+        input.resize(input_size + 8 * hop_size);
+        output.resize(window_size + 8 * hop_size);
+
+        // Windows start at multiples of the hop size, as the input is compacted to its first unconsumed window.
+        window_buffer_sets.resize((input.size() - input_size) / hop_size + 1);
+
+        for (size_t i = 0; i < window_buffer_sets.size(); i++)
+        {
+            window_buffer_sets[i].set_input(0, input.data() + i * hop_size);
+        }
+    }
+
+    OverlapAddStream(const OverlapAddStream &) = delete;
+    OverlapAddStream &operator=(const OverlapAddStream &) = delete;
+
+    ~OverlapAddStream()
+    {
+        window_buffer_sets.clear();
+        engine.select_buffer_set(0);
+    }
+
+    // Appends samples, running the model on every window they complete.
+    void push(const float *data, size_t size)
+    {
+        while (size > 0)
+        {
+            if (input_end == input.size())
+            {
+                std::copy(input.begin() + input_start, input.end(), input.begin());
+                input_end -= input_start;
+                input_start = 0;
+            }
+
+            auto count = std::min(size, input.size() - input_end);
+            std::copy(data, data + count, input.begin() + input_end);
+            input_end += count;
+            data += count;
+            size -= count;
+
+            while (input_end - input_start >= input_size)
+            {
+                run();
+            }
+        }
+    }
+
+    // Emits the overlap still pending from the last windows and starts a new stream.
+    void flush()
+    {
+        on_output(output.data() + output_start, window_size - hop_size);
+        reset();
+    }
+
+    // Drops all buffered samples and pending overlap.
+    void reset()
+    {
+        std::fill(output.begin(), output.end(), 0.0f);
+        input_start = 0;
+        input_end = 0;
+        output_start = 0;
+    }
+
+private:
+    void run()
+    {
+        window_buffer_sets[input_start / hop_size].select(engine);
+        engine.run();
+
+        if (output_start + window_size > output.size())
+        {
+            auto overlap = output.begin() + output_start;
+            std::copy(overlap, overlap + window_size - hop_size, output.begin());
+            std::fill(output.begin() + window_size - hop_size, output.end(), 0.0f);
+            output_start = 0;
+        }
+
+        detail::overlap_add(engine.get_output_data(0), synthesis_window.data(), output.data() + output_start, window_size);
+        on_output(output.data() + output_start, hop_size);
+
+        input_start += hop_size;
+        output_start += hop_size;
+    }
+
+    InferenceEngine &engine;
+
+    const size_t window_size;
+    const size_t hop_size;
+    const size_t input_size;
+
+    std::vector<float> synthesis_window;
+    OutputCallback on_output;
+
+    // Samples from input_start to input_end have not been consumed by a run yet.
+    std::vector<float> input;
+    size_t input_start = 0;
+    size_t input_end = 0;
+
+    // Overlap-added output still pending starts at output_start.
+    std::vector<float> output;
+    size_t output_start = 0;
+
+    std::vector<BufferSetBinding> window_buffer_sets;
+};
+} // namespace inference_engine
@@ -0,0 +1,301 @@
+#pragma once
+
+#include "inference_engine/BufferArena.hpp"
+#include "inference_engine/BufferSetBinding.hpp"
+#include "inference_engine/InferenceEngine.hpp"
+#include "inference_engine/Worker.hpp"
+
+#include <array>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace inference_engine
+{
+// An output of the previous stage that is bound directly as an input of the next one.
+struct PipelineLink
+{
+    size_t output_index;
+    size_t input_index;
+};
+
+struct PipelineStage
+{
+    InferenceEngine *engine = nullptr;
+
+    // Outputs of the previous stage feeding this one. Must be empty for the first stage.
+    std::vector<PipelineLink> links;
+
+    // Called on construction and after linked input shapes changed, for shapes the engine cannot infer itself, such
+    // as the other inputs or dynamic ORT outputs.
+    std::function<void(InferenceEngine &engine)> reshape;
+};
+
+// Runs a chain of engines, each on its own thread, over a sequence of chunks.
+// Linked tensors are handed off through two buffers per link, so that a stage can run the next chunk while the
+// following stage still reads the previous one. Shapes of linked outputs are propagated to the inputs they feed.
+// Each engine binds the two buffers of its links through two buffer sets, which keep the other tensors bound as the
+// callbacks bound them. Destroying the pipeline releases those sets and selects the engines' own buffer sets again.
+class Pipeline
+{
+public:
+    using Callback = std::function<void(InferenceEngine &engine)>;
+
+    explicit Pipeline(std::vector<PipelineStage> stages)
+        : stages(std::move(stages))
+    {
+        if (this->stages.empty())
+        {
+            throw std::runtime_error("pipeline has no stages");
+        }
+
+        if (!this->stages[0].links.empty())
+        {
+            throw std::runtime_error("first pipeline stage cannot have links");
+        }
+
+        for (auto i = 1; i < this->stages.size(); i++)
+        {
+            const auto &upstream = *this->stages[i - 1].engine;
+            const auto &stage = this->stages[i];
+
+            for (const auto &link : stage.links)
+            {
+                if (upstream.get_output_element_type(link.output_index) != stage.engine->get_input_element_type(link.input_index))
+                {
+                    throw std::runtime_error("linked output and input element types do not match");
+                }
+            }
+
+            if (stage.reshape)
+            {
+                stage.reshape(*stage.engine);
+            }
+
+            links.push_back(std::make_unique<Link>());
+        }
+
+        buffer_sets.resize(this->stages.size());
+
+        for (auto i = 0; i < this->stages.size(); i++)
+        {
+            workers.push_back(std::make_unique<Worker>());
+        }
+    }
+
+    Pipeline(const Pipeline &) = delete;
+    Pipeline &operator=(const Pipeline &) = delete;
+
+    // Waits for all submitted chunks to finish.
+    ~Pipeline()
+    {
+        // Upstream stages post to downstream ones, so they are drained first.
+        for (auto &worker : workers)
+        {
+            worker.reset();
+        }
+
+        for (auto &stage : stages)
+        {
+            stage.engine->select_buffer_set(0);
+        }
+    }
+
+    // Feeds one chunk through the pipeline. `prepare` sets the shapes and inputs of the first engine right before it
+    // runs, and `finish` reads the outputs of the last engine right after it ran. Both run on stage threads.
+    std::future<void> submit(Callback prepare, Callback finish)
+    {
+        auto chunk = std::make_shared<Chunk>();
+        chunk->slot = next_slot;
+        chunk->prepare = std::move(prepare);
+        chunk->finish = std::move(finish);
+        next_slot ^= 1;
+
+        auto future = chunk->promise.get_future();
+        workers[0]->post([this, chunk] { run_stage(0, chunk); });
+
+        return future;
+    }
+
+private:
+    struct Chunk
+    {
+        size_t slot;
+        Callback prepare;
+        Callback finish;
+        std::promise<void> promise;
+    };
+
+    struct Slot
+    {
+        BufferArena arena;
+        std::vector<std::byte *> buffers;
+        std::vector<std::vector<size_t>> shapes;
+        bool is_busy = false;
+    };
+
+    struct Link
+    {
+        Slot slots[2];
+        std::mutex mutex;
+        std::condition_variable condition;
+    };
+
+    void run_stage(size_t index, const std::shared_ptr<Chunk> &chunk)
+    {
+        auto &stage = stages[index];
+        auto &engine = *stage.engine;
+        auto *input_link = index > 0 ? links[index - 1].get() : nullptr;
+        auto *output_link = index < links.size() ? links[index].get() : nullptr;
+        auto &buffer_set = buffer_sets[index][chunk->slot];
+        auto is_output_acquired = false;
+
+        try
+        {
+            // Tensors the callbacks bind go into the set of the chunk.
+            buffer_set.try_select(engine);
+
+            if (input_link)
+            {
+                bind_inputs(stage, input_link->slots[chunk->slot], buffer_set);
+            }
+            else
+            {
+                chunk->prepare(engine);
+            }
+
+            if (output_link)
+            {
+                acquire(*output_link, chunk->slot);
+                is_output_acquired = true;
+                bind_outputs(engine, stages[index + 1].links, output_link->slots[chunk->slot], buffer_set);
+            }
+
+            buffer_set.select(engine);
+            engine.run();
+
+            if (input_link)
+            {
+                release(*input_link, chunk->slot);
+                input_link = nullptr;
+            }
+
+            if (output_link)
+            {
+                workers[index + 1]->post([this, index, chunk] { run_stage(index + 1, chunk); });
+            }
+            else
+            {
+                chunk->finish(engine);
+                chunk->promise.set_value();
+            }
+        }
+        catch (...)
+        {
+            if (input_link)
+            {
+                release(*input_link, chunk->slot);
+            }
+
+            if (is_output_acquired)
+            {
+                release(*output_link, chunk->slot);
+            }
+
+            chunk->promise.set_exception(std::current_exception());
+        }
+    }
+
+    static void bind_inputs(PipelineStage &stage, const Slot &slot, BufferSetBinding &buffer_set)
+    {
+        auto &engine = *stage.engine;
+        std::vector<std::vector<size_t>> shapes;
+        auto is_reshaped = false;
+
+        for (auto i = 0; i < engine.get_input_count(); i++)
+        {
+            shapes.push_back(engine.get_input_shape(i));
+        }
+
+        for (auto i = 0; i < stage.links.size(); i++)
+        {
+            auto &shape = shapes[stage.links[i].input_index];
+
+            if (shape != slot.shapes[i])
+            {
+                shape = slot.shapes[i];
+                is_reshaped = true;
+            }
+        }
+
+        if (is_reshaped)
+        {
+            engine.set_input_shapes(shapes);
+
+            if (stage.reshape)
+            {
+                stage.reshape(engine);
+            }
+        }
+
+        for (size_t i = 0; i < stage.links.size(); i++)
+        {
+            buffer_set.set_input(stage.links[i].input_index, slot.buffers[i]);
+        }
+    }
+
+    static void bind_outputs(InferenceEngine &engine, const std::vector<PipelineLink> &links, Slot &slot, BufferSetBinding &buffer_set)
+    {
+        std::vector<size_t> sizes;
+        slot.shapes.clear();
+
+        for (const auto &link : links)
+        {
+            const auto &shape = engine.get_output_shape(link.output_index);
+            sizes.push_back(count_elements(shape) * get_element_size(engine.get_output_element_type(link.output_index)));
+            slot.shapes.push_back(shape);
+        }
+
+        slot.arena.allocate(sizes, slot.buffers);
+
+        for (size_t i = 0; i < links.size(); i++)
+        {
+            buffer_set.set_output(links[i].output_index, slot.buffers[i]);
+        }
+    }
+
+    // Waits until the next stage has released the slot from the chunk two steps back.
+    static void acquire(Link &link, size_t slot)
+    {
+        std::unique_lock<std::mutex> lock(link.mutex);
+        link.condition.wait(lock, [&link, slot] { return !link.slots[slot].is_busy; });
+        link.slots[slot].is_busy = true;
+    }
+
+    static void release(Link &link, size_t slot)
+    {
+        {
+            std::lock_guard<std::mutex> lock(link.mutex);
+            link.slots[slot].is_busy = false;
+        }
+
+        link.condition.notify_one();
+    }
+
+    std::vector<PipelineStage> stages;
+    std::vector<std::unique_ptr<Link>> links;
+    size_t next_slot = 0;
+
+    // One buffer set per stage and slot, only used from the thread of the stage.
+    std::vector<std::array<BufferSetBinding, 2>> buffer_sets;
+
+    std::vector<std::unique_ptr<Worker>> workers;
+};
+} // namespace inference_engine
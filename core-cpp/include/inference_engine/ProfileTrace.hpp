@@ -0,0 +1,120 @@
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace inference_engine
+{
+// One operator execution collected while profiling.
+struct ProfileEvent
+{
+    // Name of the first output tensor of the node, as TFLite nodes have no names, or else of the node.
+    std::string name;
+    std::string op_type;
+
+    // Relative to the first event of the trace.
+    std::chrono::microseconds start{0};
+    std::chrono::microseconds duration{0};
+};
+
+// Operator executions of one engine between starting and stopping profiling.
+struct ProfileTrace
+{
+    // Backend name, such as "onnxruntime" or "tflite".
+    std::string engine;
+
+    // File name of the model, or empty for models created from memory.
+    std::string model;
+
+    std::vector<ProfileEvent> events;
+};
+
+namespace detail
+{
+inline void write_json_string(std::ostream &os, const std::string &value)
+{
+    os << '"';
+
+    for (auto c : value)
+    {
+        switch (c)
+        {
+        case '"':
+            os << "\\\"";
+            break;
+        case '\\':
+            os << "\\\\";
+            break;
+        case '\n':
+            os << "\\n";
+            break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20)
+            {
+                char escaped[7];
+                std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                os << escaped;
+            }
+            else
+            {
+                os << c;
+            }
+        }
+    }
+
+    os << '"';
+}
+} // namespace detail
+
+// Writes traces in the Chrome trace event format, which chrome://tracing and Perfetto open. Each trace becomes one
+// process labelled with its engine and model, so that traces of different backends line up for comparison.
+inline void write_chrome_trace(std::ostream &os, const std::vector<ProfileTrace> &traces)
+{
+    os << "{\"traceEvents\": [";
+
+    for (auto i = 0; i < traces.size(); i++)
+    {
+        const auto &trace = traces[i];
+        auto pid = i + 1;
+        auto label = trace.model.empty() ? trace.engine : trace.engine + ": " + trace.model;
+
+        os << (i > 0 ? ",\n" : "\n");
+        os << "{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": " << pid << ", \"args\": {\"name\": ";
+        detail::write_json_string(os, label);
+        os << "}}";
+
+        for (const auto &event : trace.events)
+        {
+            os << ",\n{\"name\": ";
+            detail::write_json_string(os, event.name);
+            os << ", \"cat\": ";
+            detail::write_json_string(os, event.op_type);
+            os << ", \"ph\": \"X\", \"pid\": " << pid << ", \"tid\": 1";
+            os << ", \"ts\": " << event.start.count() << ", \"dur\": " << event.duration.count();
+            os << ", \"args\": {\"op_type\": ";
+            detail::write_json_string(os, event.op_type);
+            os << "}}";
+        }
+    }
+
+    os << "\n]}\n";
+}
+
+inline void write_chrome_trace(const std::filesystem::path &file_path, const std::vector<ProfileTrace> &traces)
+{
+    std::ofstream ofs(file_path);
+
+    if (!ofs)
+    {
+        throw std::runtime_error("failed to open file: " + file_path.string());
+    }
+
+    write_chrome_trace(ofs, traces);
+}
+} // namespace inference_engine
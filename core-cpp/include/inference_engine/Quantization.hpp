@@ -0,0 +1,221 @@
+#pragma once
+
+#include "inference_engine/Simd.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+namespace inference_engine
+{
+// Affine quantization of a tensor: real_value = scale * (quantized_value - zero_point).
+// A scale of zero means that the tensor is not quantized.
+struct QuantizationParams
+{
+    float scale = 0;
+    int32_t zero_point = 0;
+};
+
+namespace detail
+{
+template <typename T>
+void quantize_scalar(const float *input, T *output, size_t count, float inverse_scale, int32_t zero_point)
+{
+    const auto low = static_cast<float>(std::numeric_limits<T>::min() - zero_point);
+    const auto high = static_cast<float>(std::numeric_limits<T>::max() - zero_point);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        auto value = std::min(high, std::max(low, input[i] * inverse_scale));
+        output[i] = static_cast<T>(static_cast<int32_t>(std::nearbyint(value)) + zero_point);
+    }
+}
+
+template <typename T>
+void dequantize_scalar(const T *input, float *output, size_t count, float scale, int32_t zero_point)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        output[i] = scale * static_cast<float>(static_cast<int32_t>(input[i]) - zero_point);
+    }
+}
+
+#if defined(INFERENCE_ENGINE_AVX2_TARGET)
+template <typename T>
+INFERENCE_ENGINE_AVX2_TARGET size_t quantize_avx2(const float *input, T *output, size_t count, float inverse_scale, int32_t zero_point)
+{
+    const auto scale = _mm256_set1_ps(inverse_scale);
+    const auto low = _mm256_set1_ps(static_cast<float>(std::numeric_limits<T>::min() - zero_point));
+    const auto high = _mm256_set1_ps(static_cast<float>(std::numeric_limits<T>::max() - zero_point));
+    const auto zero = _mm256_set1_epi32(zero_point);
+    const auto permutation = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+
+    size_t i = 0;
+
+    for (; i + 32 <= count; i += 32)
+    {
+        __m256i values[4];
+
+        for (auto j = 0; j < 4; j++)
+        {
+            auto value = _mm256_mul_ps(_mm256_loadu_ps(input + i + 8 * j), scale);
+            value = _mm256_min_ps(_mm256_max_ps(value, low), high);
+            values[j] = _mm256_add_epi32(_mm256_cvtps_epi32(value), zero);
+        }
+
+        auto low_words = _mm256_packs_epi32(values[0], values[1]);
+        auto high_words = _mm256_packs_epi32(values[2], values[3]);
+        auto bytes = std::is_signed_v<T> ? _mm256_packs_epi16(low_words, high_words) : _mm256_packus_epi16(low_words, high_words);
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(output + i), _mm256_permutevar8x32_epi32(bytes, permutation));
+    }
+
+    return i;
+}
+
+template <typename T>
+INFERENCE_ENGINE_AVX2_TARGET size_t dequantize_avx2(const T *input, float *output, size_t count, float scale, int32_t zero_point)
+{
+    const auto scales = _mm256_set1_ps(scale);
+    const auto zero = _mm256_set1_epi32(zero_point);
+
+    size_t i = 0;
+
+    for (; i + 8 <= count; i += 8)
+    {
+        auto bytes = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(input + i));
+        auto values = std::is_signed_v<T> ? _mm256_cvtepi8_epi32(bytes) : _mm256_cvtepu8_epi32(bytes);
+        auto value = _mm256_cvtepi32_ps(_mm256_sub_epi32(values, zero));
+        _mm256_storeu_ps(output + i, _mm256_mul_ps(value, scales));
+    }
+
+    return i;
+}
+#endif
+
+#if defined(INFERENCE_ENGINE_NEON)
+template <typename T>
+size_t quantize_neon(const float *input, T *output, size_t count, float inverse_scale, int32_t zero_point)
+{
+    const auto scale = vdupq_n_f32(inverse_scale);
+    const auto low = vdupq_n_f32(static_cast<float>(std::numeric_limits<T>::min() - zero_point));
+    const auto high = vdupq_n_f32(static_cast<float>(std::numeric_limits<T>::max() - zero_point));
+    const auto zero = vdupq_n_s32(zero_point);
+
+    size_t i = 0;
+
+    for (; i + 16 <= count; i += 16)
+    {
+        int32x4_t values[4];
+
+        for (auto j = 0; j < 4; j++)
+        {
+            auto value = vmulq_f32(vld1q_f32(input + i + 4 * j), scale);
+            value = vminq_f32(vmaxq_f32(value, low), high);
+            values[j] = vaddq_s32(vcvtnq_s32_f32(value), zero);
+        }
+
+        auto low_words = vcombine_s16(vqmovn_s32(values[0]), vqmovn_s32(values[1]));
+        auto high_words = vcombine_s16(vqmovn_s32(values[2]), vqmovn_s32(values[3]));
+
+        if constexpr (std::is_signed_v<T>)
+        {
+            vst1q_s8(reinterpret_cast<int8_t *>(output + i), vcombine_s8(vqmovn_s16(low_words), vqmovn_s16(high_words)));
+        }
+        else
+        {
+            vst1q_u8(reinterpret_cast<uint8_t *>(output + i), vcombine_u8(vqmovun_s16(low_words), vqmovun_s16(high_words)));
+        }
+    }
+
+    return i;
+}
+
+template <typename T>
+size_t dequantize_neon(const T *input, float *output, size_t count, float scale, int32_t zero_point)
+{
+    const auto scales = vdupq_n_f32(scale);
+    const auto zero = vdupq_n_s32(zero_point);
+
+    size_t i = 0;
+
+    for (; i + 16 <= count; i += 16)
+    {
+        int16x8_t low_words;
+        int16x8_t high_words;
+
+        if constexpr (std::is_signed_v<T>)
+        {
+            auto bytes = vld1q_s8(reinterpret_cast<const int8_t *>(input + i));
+            low_words = vmovl_s8(vget_low_s8(bytes));
+            high_words = vmovl_s8(vget_high_s8(bytes));
+        }
+        else
+        {
+            auto bytes = vld1q_u8(reinterpret_cast<const uint8_t *>(input + i));
+            low_words = vreinterpretq_s16_u16(vmovl_u8(vget_low_u8(bytes)));
+            high_words = vreinterpretq_s16_u16(vmovl_u8(vget_high_u8(bytes)));
+        }
+
+        int32x4_t values[4]{
+            vmovl_s16(vget_low_s16(low_words)),
+            vmovl_s16(vget_high_s16(low_words)),
+            vmovl_s16(vget_low_s16(high_words)),
+            vmovl_s16(vget_high_s16(high_words)),
+        };
+
+        for (auto j = 0; j < 4; j++)
+        {
+            auto value = vcvtq_f32_s32(vsubq_s32(values[j], zero));
+            vst1q_f32(output + i + 4 * j, vmulq_f32(value, scales));
+        }
+    }
+
+    return i;
+}
+#endif
+} // namespace detail
+
+// Converts floats to int8 or uint8 values, rounding to nearest and saturating to the range of the type.
+template <typename T>
+void quantize(const float *input, T *output, size_t count, const QuantizationParams &params)
+{
+    static_assert(std::is_same_v<T, int8_t> || std::is_same_v<T, uint8_t>, "only 8-bit quantization is supported");
+
+    const auto inverse_scale = 1.0f / params.scale;
+    size_t i = 0;
+
+#if defined(INFERENCE_ENGINE_AVX2_TARGET)
+    if (detail::has_avx2())
+    {
+        i = detail::quantize_avx2(input, output, count, inverse_scale, params.zero_point);
+    }
+#elif defined(INFERENCE_ENGINE_NEON)
+    i = detail::quantize_neon(input, output, count, inverse_scale, params.zero_point);
+#endif
+
+    detail::quantize_scalar(input + i, output + i, count - i, inverse_scale, params.zero_point);
+}
+
+template <typename T>
+void dequantize(const T *input, float *output, size_t count, const QuantizationParams &params)
+{
+    static_assert(std::is_same_v<T, int8_t> || std::is_same_v<T, uint8_t>, "only 8-bit quantization is supported");
+
+    size_t i = 0;
+
+#if defined(INFERENCE_ENGINE_AVX2_TARGET)
+    if (detail::has_avx2())
+    {
+        i = detail::dequantize_avx2(input, output, count, params.scale, params.zero_point);
+    }
+#elif defined(INFERENCE_ENGINE_NEON)
+    i = detail::dequantize_neon(input, output, count, params.scale, params.zero_point);
+#endif
+
+    detail::dequantize_scalar(input + i, output + i, count - i, params.scale, params.zero_point);
+}
+} // namespace inference_engine
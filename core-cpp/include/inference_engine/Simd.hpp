@@ -0,0 +1,33 @@
+#pragma once
+
+// Vector kernels are compiled for AVX2 on x86, dispatched at run time unless the whole build targets AVX2, and for
+// NEON on AArch64. Other targets use the scalar kernels only.
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#include <immintrin.h>
+#if defined(__AVX2__)
+#define INFERENCE_ENGINE_AVX2_TARGET
+#elif defined(__GNUC__)
+#define INFERENCE_ENGINE_AVX2_TARGET __attribute__((target("avx2")))
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define INFERENCE_ENGINE_NEON
+#endif
+
+namespace inference_engine
+{
+namespace detail
+{
+#if defined(INFERENCE_ENGINE_AVX2_TARGET)
+inline bool has_avx2()
+{
+#if defined(__AVX2__)
+    return true;
+#else
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+#endif
+}
+#endif
+} // namespace detail
+} // namespace inference_engine
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace inference_engine
+{
+// Non-owning view of contiguous elements, standing in for std::span until the project moves to C++20. Shapes are
+// passed as spans so that callers holding them in other storage, such as the C ABI, need not copy them.
+template <typename T>
+class Span
+{
+public:
+    using element_type = T;
+    using value_type = std::remove_cv_t<T>;
+    using iterator = T *;
+
+    Span() = default;
+
+    Span(T *data, size_t size)
+        : data_(data)
+        , size_(size)
+    {
+    }
+
+    // Views any contiguous container, such as vectors and other spans, which must outlive the span.
+    template <typename Container, typename = std::enable_if_t<std::is_convertible_v<decltype(std::data(std::declval<Container &>())), T *>>>
+    Span(Container &&values)
+        : data_(std::data(values))
+        , size_(std::size(values))
+    {
+    }
+
+    T *data() const
+    {
+        return data_;
+    }
+
+    size_t size() const
+    {
+        return size_;
+    }
+
+    bool empty() const
+    {
+        return size_ == 0;
+    }
+
+    iterator begin() const
+    {
+        return data_;
+    }
+
+    iterator end() const
+    {
+        return data_ + size_;
+    }
+
+    T &operator[](size_t index) const
+    {
+        return data_[index];
+    }
+
+    friend bool operator==(Span a, Span b)
+    {
+        return std::equal(a.begin(), a.end(), b.begin(), b.end());
+    }
+
+    friend bool operator!=(Span a, Span b)
+    {
+        return !(a == b);
+    }
+
+private:
+    T *data_ = nullptr;
+    size_t size_ = 0;
+};
+
+// Views of the given vectors, for passing nested vectors where nested spans are expected.
+template <typename T>
+std::vector<Span<const T>> get_spans(const std::vector<std::vector<T>> &values)
+{
+    return {values.begin(), values.end()};
+}
+} // namespace inference_engine
@@ -0,0 +1,139 @@
+#pragma once
+
+#include "inference_engine/BufferSetBinding.hpp"
+#include "inference_engine/InferenceEngine.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace inference_engine
+{
+// An output of a stateful model that is fed back into an input on the next run.
+struct StatePair
+{
+    size_t output_index;
+    size_t input_index;
+};
+
+// Recurrent state of one stream. Each state pair has two buffers, one read by the next run and one written by it,
+// which swap roles after every run so that state is fed back without copying. Both arrangements of the buffers are
+// bound through a buffer set of their own, so that a run only selects one. Destroying a state releases its buffer sets,
+// so it must not outlive the engine.
+// Copying a state snapshots it, and assigning the copy back restores it.
+class StreamState
+{
+public:
+    // Sets all state to zero, as at the start of a stream.
+    void reset()
+    {
+        for (auto &buffer : buffers)
+        {
+            std::fill(buffer.begin(), buffer.end(), std::byte{0});
+        }
+    }
+
+    // State as the next run will read it, which may be written to start a stream from a state other than zero.
+    void *get_data(size_t pair_index)
+    {
+        return buffers[2 * pair_index + current].data();
+    }
+
+    const void *get_data(size_t pair_index) const
+    {
+        return buffers[2 * pair_index + current].data();
+    }
+
+private:
+    friend class StatefulSession;
+
+    std::vector<std::vector<std::byte>> buffers;
+    size_t current = 0;
+    BufferSetBinding buffer_sets[2];
+};
+
+// Runs a model whose state outputs feed its state inputs, for any number of independent streams.
+// Non-state inputs and outputs are bound on the engine as usual, before the first run of a stream, after which they
+// keep those bindings in its buffer sets. The engine stays on a buffer set of the stream that ran last, until buffer
+// set 0 is selected again.
+class StatefulSession
+{
+public:
+    StatefulSession(InferenceEngine &engine, std::vector<StatePair> pairs)
+        : engine(engine)
+        , pairs(std::move(pairs))
+    {
+        for (const auto &pair : this->pairs)
+        {
+            if (engine.get_input_element_type(pair.input_index) != engine.get_output_element_type(pair.output_index))
+            {
+                throw std::runtime_error("state input and output element types do not match");
+            }
+        }
+    }
+
+    StatefulSession(const StatefulSession &) = delete;
+    StatefulSession &operator=(const StatefulSession &) = delete;
+
+    // Creates zeroed state sized by the current shapes of the state inputs.
+    StreamState create_state() const
+    {
+        StreamState state;
+
+        for (const auto &pair : pairs)
+        {
+            auto byte_count = get_input_byte_count(pair.input_index);
+            state.buffers.emplace_back(byte_count);
+            state.buffers.emplace_back(byte_count);
+        }
+
+        return state;
+    }
+
+    // Selects the buffer set binding the state of the stream, runs the engine and swaps the state buffers for the
+    // next run.
+    void run(StreamState &state)
+    {
+        if (state.buffers.size() != 2 * pairs.size())
+        {
+            throw std::runtime_error("state does not belong to this session");
+        }
+
+        auto &buffer_set = state.buffer_sets[state.current];
+
+        for (size_t i = 0; i < pairs.size(); i++)
+        {
+            auto &input = state.buffers[2 * i + state.current];
+            auto &output = state.buffers[2 * i + (state.current ^ 1)];
+
+            if (input.size() != get_input_byte_count(pairs[i].input_index) || output.size() != get_output_byte_count(pairs[i].output_index))
+            {
+                throw std::runtime_error("state size does not match the engine shapes");
+            }
+
+            buffer_set.set_input(pairs[i].input_index, input.data());
+            buffer_set.set_output(pairs[i].output_index, output.data());
+        }
+
+        buffer_set.select(engine);
+        engine.run();
+        state.current ^= 1;
+    }
+
+private:
+    size_t get_input_byte_count(size_t index) const
+    {
+        return count_elements(engine.get_input_shape(index)) * get_element_size(engine.get_input_element_type(index));
+    }
+
+    size_t get_output_byte_count(size_t index) const
+    {
+        return count_elements(engine.get_output_shape(index)) * get_element_size(engine.get_output_element_type(index));
+    }
+
+    InferenceEngine &engine;
+    const std::vector<StatePair> pairs;
+};
+} // namespace inference_engine
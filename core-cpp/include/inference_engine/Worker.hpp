@@ -0,0 +1,81 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace inference_engine
+{
+// Runs posted tasks in order on a single background thread that is started on first use.
+// Pending tasks are drained before destruction, which must not happen on the worker thread itself.
+class Worker
+{
+public:
+    Worker() = default;
+
+    Worker(const Worker &) = delete;
+    Worker &operator=(const Worker &) = delete;
+
+    ~Worker()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+
+        condition.notify_one();
+
+        if (thread.joinable())
+        {
+            thread.join();
+        }
+    }
+
+    void post(std::function<void()> task)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            tasks.push_back(std::move(task));
+
+            if (!thread.joinable())
+            {
+                thread = std::thread(&Worker::work, this);
+            }
+        }
+
+        condition.notify_one();
+    }
+
+private:
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::deque<std::function<void()>> tasks;
+    bool stopping = false;
+
+    std::thread thread;
+
+    void work()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+
+        while (true)
+        {
+            condition.wait(lock, [this] { return stopping || !tasks.empty(); });
+
+            if (tasks.empty())
+            {
+                return;
+            }
+
+            auto task = std::move(tasks.front());
+            tasks.pop_front();
+
+            lock.unlock();
+            task();
+            lock.lock();
+        }
+    }
+};
+} // namespace inference_engine
@@ -1,3 +1,11 @@
+use std::fmt::Write;
+use std::future::Future;
+use std::marker::PhantomData;
+use std::path::{Path, PathBuf};
+use std::pin::Pin;
+use std::sync::{Arc, Condvar, Mutex};
+use std::task::{Context, Poll, Waker};
+use std::time::Duration;
 use thiserror::Error;
 
 pub trait InferenceEngine {
@@ -5,10 +13,14 @@ pub trait InferenceEngine {
     fn output_count(&self) -> usize;
 
     fn input_shape(&self, index: usize) -> &[usize];
-    fn input_shapes(&self) -> Vec<&[usize]>;
+    fn input_shapes(&self) -> impl ExactSizeIterator<Item = &[usize]>
+    where
+        Self: Sized;
 
     fn output_shape(&self, index: usize) -> &[usize];
-    fn output_shapes(&self) -> Vec<&[usize]>;
+    fn output_shapes(&self) -> impl ExactSizeIterator<Item = &[usize]>
+    where
+        Self: Sized;
 
     fn set_input_shape(&mut self, index: usize, shape: &[usize]) -> Result<(), Error>;
     fn set_input_shapes(&mut self, shapes: &[&[usize]]) -> Result<(), Error>;
@@ -16,19 +28,411 @@ pub trait InferenceEngine {
     fn set_output_shape(&mut self, index: usize, shape: &[usize]) -> Result<(), Error>;
     fn set_output_shapes(&mut self, shapes: &[&[usize]]) -> Result<(), Error>;
 
-    fn input_data(&mut self, index: usize) -> &mut [f32];
-    fn input_data_all(&mut self) -> Vec<&mut [f32]>;
+    /// Data of 32-bit float tensors. Other element types are read through [`InferenceEngine::typed_input_data`].
+    fn input_data(&mut self, index: usize) -> Result<&mut [f32], Error>;
+    fn input_data_all(&mut self) -> Result<impl ExactSizeIterator<Item = &mut [f32]>, Error>
+    where
+        Self: Sized;
 
-    fn output_data(&self, index: usize) -> &[f32];
-    fn output_data_all(&self) -> Vec<&[f32]>;
+    fn output_data(&self, index: usize) -> Result<&[f32], Error>;
+    fn output_data_all(&self) -> Result<impl ExactSizeIterator<Item = &[f32]>, Error>
+    where
+        Self: Sized;
 
+    /// Buffers of all inputs for models with `N` inputs, which a frame loop can destructure without allocating.
+    fn input_data_array<const N: usize>(&mut self) -> Result<[&mut [f32]; N], Error>
+    where
+        Self: Sized;
+    fn output_data_array<const N: usize>(&self) -> Result<[&[f32]; N], Error>
+    where
+        Self: Sized;
+
+    /// Binds an input to caller data. With XNNPACK, TFLite may read up to 16 bytes past the end of the slice, so
+    /// the memory after it must be readable, as when the slice is part of a larger allocation.
     fn set_input_data(&mut self, index: usize, data: &[f32]) -> Result<(), Error>;
     fn set_input_data_all(&mut self, data: &[&[f32]]) -> Result<(), Error>;
 
     fn set_output_data(&mut self, index: usize, data: &mut [f32]) -> Result<(), Error>;
     fn set_output_data_all(&mut self, data: &mut [&mut [f32]]) -> Result<(), Error>;
 
+    fn input_element_type(&self, index: usize) -> ElementType;
+    fn output_element_type(&self, index: usize) -> ElementType;
+
+    fn typed_input_data<T: Element>(&mut self, index: usize) -> Result<&mut [T], Error>
+    where
+        Self: Sized;
+    fn typed_output_data<T: Element>(&self, index: usize) -> Result<&[T], Error>
+    where
+        Self: Sized;
+
+    /// Input slices need the readable padding described at [`InferenceEngine::set_input_data`].
+    fn set_typed_input_data<T: Element>(&mut self, index: usize, data: &[T]) -> Result<(), Error>
+    where
+        Self: Sized;
+    fn set_typed_output_data<T: Element>(
+        &mut self,
+        index: usize,
+        data: &mut [T],
+    ) -> Result<(), Error>
+    where
+        Self: Sized;
+
+    /// Registers buffers for all inputs and outputs up front and returns the id that selects them for the
+    /// following runs. The engine's own buffers are set 0. Reshaping drops all registered sets. Input buffers need
+    /// the readable padding described at [`InferenceEngine::set_input_data`].
+    ///
+    /// # Safety
+    ///
+    /// The engine keeps pointers to the buffers beyond their borrow. They must stay valid, and must not be accessed
+    /// while a run with the set selected may touch them, until the set is unregistered, reshaping drops it or the
+    /// engine is dropped.
+    unsafe fn register_buffer_set(
+        &mut self,
+        inputs: &[&[f32]],
+        outputs: &mut [&mut [f32]],
+    ) -> Result<usize, Error>;
+    fn select_buffer_set(&mut self, id: usize) -> Result<(), Error>;
+
+    /// Releases a registered buffer set, whose id later registrations may hand out again. Selecting a released id,
+    /// like releasing the selected set, selects set 0.
+    fn unregister_buffer_set(&mut self, id: usize) -> Result<(), Error>;
+
+    /// Runs each set of input shapes `iterations` times on zeroed inputs, so that backend caches and arenas are
+    /// primed before the first real run. The engine is left with the input shapes of the last set, all tensors bound
+    /// to its own buffers and no registered buffer sets.
+    fn warmup(
+        &mut self,
+        shape_sets: &[&[&[usize]]],
+        iterations: usize,
+    ) -> Result<Vec<WarmupTiming>, Error>;
+
+    fn stats(&self) -> Result<EngineStats, Error>;
+    fn reset_stats(&mut self) -> Result<(), Error>;
+
+    fn start_profiling(&mut self) -> Result<(), Error>;
+    fn stop_profiling(&mut self) -> Result<ProfileTrace, Error>;
+
     fn run(&mut self) -> Result<(), Error>;
+
+    /// Starts a run that finishes in the background.
+    ///
+    /// # Safety
+    ///
+    /// The future must be dropped or polled to completion, not leaked with `mem::forget`. The run keeps using the
+    /// engine and its bound buffers until it finishes, and only the future's drop waits for that.
+    unsafe fn run_async(&mut self) -> RunFuture<'_>;
+}
+
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum ElementType {
+    Float32,
+    Float16,
+    Int8,
+    Uint8,
+    Int16,
+    Int32,
+    Int64,
+    Bool,
+}
+
+/// IEEE 754 half-precision value kept as its raw bits.
+#[repr(transparent)]
+#[derive(Debug, Default, Clone, Copy, PartialEq, Eq)]
+pub struct Float16(pub u16);
+
+pub trait Element: Copy {
+    const ELEMENT_TYPE: ElementType;
+}
+
+impl Element for f32 {
+    const ELEMENT_TYPE: ElementType = ElementType::Float32;
+}
+
+impl Element for Float16 {
+    const ELEMENT_TYPE: ElementType = ElementType::Float16;
+}
+
+impl Element for i8 {
+    const ELEMENT_TYPE: ElementType = ElementType::Int8;
+}
+
+impl Element for u8 {
+    const ELEMENT_TYPE: ElementType = ElementType::Uint8;
+}
+
+impl Element for i16 {
+    const ELEMENT_TYPE: ElementType = ElementType::Int16;
+}
+
+impl Element for i32 {
+    const ELEMENT_TYPE: ElementType = ElementType::Int32;
+}
+
+impl Element for i64 {
+    const ELEMENT_TYPE: ElementType = ElementType::Int64;
+}
+
+impl Element for bool {
+    const ELEMENT_TYPE: ElementType = ElementType::Bool;
+}
+
+/// Affine quantization of a tensor: `real_value = scale * (quantized_value - zero_point)`.
+///
+/// A scale of zero means that the tensor is not quantized.
+#[derive(Debug, Default, Clone, Copy, PartialEq)]
+pub struct QuantizationParams {
+    pub scale: f32,
+    pub zero_point: i32,
+}
+
+/// Durations of warming up one set of input shapes.
+#[derive(Debug, Default, Clone, Copy, PartialEq, Eq)]
+pub struct WarmupTiming {
+    pub reshape: Duration,
+    pub first_run: Duration,
+    pub last_run: Duration,
+}
+
+/// Runtime statistics of an engine since it was created or its statistics were last reset.
+/// Percentiles are estimated from a histogram and are within 1/8 of the actual run latency.
+#[derive(Debug, Default, Clone, Copy, PartialEq, Eq)]
+pub struct EngineStats {
+    pub run_count: u64,
+    pub run_time_total: Duration,
+    pub run_time_min: Duration,
+    pub run_time_max: Duration,
+    pub run_time_p50: Duration,
+    pub run_time_p99: Duration,
+    pub reshape_count: u64,
+    pub reshape_time_total: Duration,
+    pub bytes_bound: u64,
+}
+
+/// One operator execution collected while profiling.
+#[derive(Debug, Default, Clone, PartialEq, Eq)]
+pub struct ProfileEvent {
+    /// Name of the node, or of its first output tensor for backends without node names.
+    pub name: String,
+    pub op_type: String,
+    /// Relative to the first event of the trace.
+    pub start: Duration,
+    pub duration: Duration,
+}
+
+/// Operator executions of one engine between starting and stopping profiling.
+#[derive(Debug, Default, Clone, PartialEq, Eq)]
+pub struct ProfileTrace {
+    /// Backend name, such as "onnxruntime" or "tflite".
+    pub engine: String,
+    /// File name of the model, or empty for models created from memory.
+    pub model: String,
+    pub events: Vec<ProfileEvent>,
+}
+
+fn write_json_string(json: &mut String, value: &str) {
+    json.push('"');
+
+    for c in value.chars() {
+        match c {
+            '"' => json.push_str("\\\""),
+            '\\' => json.push_str("\\\\"),
+            '\n' => json.push_str("\\n"),
+            c if (c as u32) < 0x20 => write!(json, "\\u{:04x}", c as u32).unwrap(),
+            c => json.push(c),
+        }
+    }
+
+    json.push('"');
+}
+
+/// Writes traces in the Chrome trace event format, which chrome://tracing and Perfetto open. Each trace becomes one
+/// process labelled with its engine and model, so that traces of different backends line up for comparison.
+pub fn write_chrome_trace(
+    file_path: impl AsRef<Path>,
+    traces: &[ProfileTrace],
+) -> Result<(), Error> {
+    let mut json = String::from("{\"traceEvents\": [");
+
+    for (i, trace) in traces.iter().enumerate() {
+        let pid = i + 1;
+        let label = if trace.model.is_empty() {
+            trace.engine.clone()
+        } else {
+            format!("{}: {}", trace.engine, trace.model)
+        };
+
+        json.push_str(if i > 0 { ",\n" } else { "\n" });
+        write!(
+            json,
+            "{{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": {pid}, \"args\": {{\"name\": "
+        )
+        .unwrap();
+        write_json_string(&mut json, &label);
+        json.push_str("}}");
+
+        for event in &trace.events {
+            json.push_str(",\n{\"name\": ");
+            write_json_string(&mut json, &event.name);
+            json.push_str(", \"cat\": ");
+            write_json_string(&mut json, &event.op_type);
+            write!(
+                json,
+                ", \"ph\": \"X\", \"pid\": {pid}, \"tid\": 1, \"ts\": {}, \"dur\": {}, \"args\": {{\"op_type\": ",
+                event.start.as_micros(),
+                event.duration.as_micros()
+            )
+            .unwrap();
+            write_json_string(&mut json, &event.op_type);
+            json.push_str("}}");
+        }
+    }
+
+    json.push_str("\n]}\n");
+    std::fs::write(file_path, json).map_err(|e| Error::Unknown(Box::new(e)))
+}
+
+enum RunState {
+    Pending(Option<Waker>),
+    Completed(Result<(), String>),
+    Taken,
+}
+
+type SharedRunState = Arc<(Mutex<RunState>, Condvar)>;
+
+/// Resolves when a run started by [`InferenceEngine::run_async`] finishes.
+///
+/// The engine stays mutably borrowed until then; dropping the future early blocks until the run has finished.
+pub struct RunFuture<'a> {
+    state: SharedRunState,
+    engine: PhantomData<&'a mut ()>,
+}
+
+/// Completes the paired [`RunFuture`], possibly from another thread.
+pub struct RunCompletion {
+    state: SharedRunState,
+}
+
+impl RunFuture<'_> {
+    /// Pairs a future with the completion that resolves it, for engine implementations.
+    ///
+    /// # Safety
+    ///
+    /// The lifetime must be that of the borrow of everything the run uses, and the completion must be called once
+    /// the run can no longer touch any of it.
+    #[doc(hidden)]
+    pub unsafe fn new() -> (Self, RunCompletion) {
+        let state = Arc::new((Mutex::new(RunState::Pending(None)), Condvar::new()));
+
+        (
+            Self {
+                state: state.clone(),
+                engine: PhantomData,
+            },
+            RunCompletion { state },
+        )
+    }
+}
+
+impl Future for RunFuture<'_> {
+    type Output = Result<(), Error>;
+
+    fn poll(self: Pin<&mut Self>, cx: &mut Context<'_>) -> Poll<Self::Output> {
+        let mut state = self.state.0.lock().unwrap();
+
+        match std::mem::replace(&mut *state, RunState::Taken) {
+            RunState::Pending(_) => {
+                *state = RunState::Pending(Some(cx.waker().clone()));
+                Poll::Pending
+            }
+            RunState::Completed(result) => Poll::Ready(result.map_err(Error::SysError)),
+            RunState::Taken => panic!("`RunFuture` polled after completion"),
+        }
+    }
+}
+
+impl Drop for RunFuture<'_> {
+    fn drop(&mut self) {
+        let (state, condvar) = &*self.state;
+        let _state = condvar
+            .wait_while(state.lock().unwrap(), |state| {
+                matches!(state, RunState::Pending(_))
+            })
+            .unwrap();
+    }
+}
+
+impl RunCompletion {
+    pub fn complete(self, result: Result<(), Error>) {
+        let (state, condvar) = &*self.state;
+        let previous = std::mem::replace(
+            &mut *state.lock().unwrap(),
+            RunState::Completed(result.map_err(|e| e.to_string())),
+        );
+        condvar.notify_all();
+
+        if let RunState::Pending(Some(waker)) = previous {
+            waker.wake();
+        }
+    }
+}
+
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum ExecutionMode {
+    Sequential,
+    Parallel,
+}
+
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum OptimizationLevel {
+    Disabled,
+    Basic,
+    Extended,
+    All,
+}
+
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub struct EngineOptions {
+    pub intra_op_num_threads: usize,
+    pub inter_op_num_threads: usize,
+    pub execution_mode: ExecutionMode,
+    pub use_global_thread_pool: bool,
+    pub use_float_io: bool,
+    pub shape_cache_capacity: usize,
+    pub enable_stats: bool,
+    pub enable_profiling: bool,
+    pub optimization_level: OptimizationLevel,
+    pub optimized_model_cache_dir: Option<PathBuf>,
+    pub use_xnnpack: bool,
+    pub xnnpack_num_threads: usize,
+    pub xnnpack_enable_quantized: bool,
+    pub xnnpack_force_fp16: bool,
+    pub intra_op_thread_affinities: Vec<Vec<usize>>,
+    pub numa_node: Option<u32>,
+    pub allow_spinning: bool,
+}
+
+impl Default for EngineOptions {
+    fn default() -> Self {
+        Self {
+            intra_op_num_threads: 1,
+            inter_op_num_threads: 0,
+            execution_mode: ExecutionMode::Sequential,
+            use_global_thread_pool: false,
+            use_float_io: false,
+            shape_cache_capacity: 1,
+            enable_stats: false,
+            enable_profiling: false,
+            optimization_level: OptimizationLevel::All,
+            optimized_model_cache_dir: None,
+            use_xnnpack: false,
+            xnnpack_num_threads: 0,
+            xnnpack_enable_quantized: true,
+            xnnpack_force_fp16: false,
+            intra_op_thread_affinities: Vec::new(),
+            numa_node: None,
+            allow_spinning: true,
+        }
+    }
 }
 
 #[derive(Error, Debug)]
@@ -36,6 +440,12 @@ pub enum Error {
     #[error("{0}")]
     SysError(String),
 
+    #[error("element type mismatch: expected {expected:?}, found {found:?}")]
+    ElementTypeMismatch {
+        expected: ElementType,
+        found: ElementType,
+    },
+
     #[error("{0}")]
     Unknown(#[from] Box<dyn std::error::Error>),
 }
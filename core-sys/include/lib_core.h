@@ -1,6 +1,8 @@
 #pragma once
 
+#include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 
 #ifdef __cplusplus
 extern "C"
@@ -12,9 +14,96 @@ extern "C"
         Error = -1,
     } InferenceEngineResultCode;
 
+    typedef enum
+    {
+        Sequential = 0,
+        Parallel = 1,
+    } InferenceEngineExecutionMode;
+
+    typedef enum
+    {
+        Disabled = 0,
+        Basic = 1,
+        Extended = 2,
+        All = 3,
+    } InferenceEngineOptimizationLevel;
+
+    typedef enum
+    {
+        Float32 = 0,
+        Float16 = 1,
+        Int8 = 2,
+        Uint8 = 3,
+        Int16 = 4,
+        Int32 = 5,
+        Int64 = 6,
+        Bool = 7,
+    } InferenceEngineElementType;
+
+    // Zeroed options differ from the defaults, for instance pinning to NUMA node 0 and disabling optimizations, so
+    // options start from inference_engine__get_default_options.
+    typedef struct
+    {
+        size_t intra_op_num_threads;
+        size_t inter_op_num_threads;
+        InferenceEngineExecutionMode execution_mode;
+        bool use_global_thread_pool;
+        bool use_float_io;
+        size_t shape_cache_capacity;
+        bool enable_stats;
+        bool enable_profiling;
+        InferenceEngineOptimizationLevel optimization_level;
+        const char *optimized_model_cache_dir;
+        bool use_xnnpack;
+        size_t xnnpack_num_threads;
+        bool xnnpack_enable_quantized;
+        bool xnnpack_force_fp16;
+        // Cores of all intra-op threads back to back, with the number of cores of each thread.
+        const size_t *intra_op_thread_cores;
+        const size_t *intra_op_thread_core_counts;
+        size_t intra_op_thread_affinity_count;
+        int32_t numa_node;
+        bool allow_spinning;
+    } InferenceEngineOptions;
+
+    typedef struct
+    {
+        uint64_t reshape_ns;
+        uint64_t first_run_ns;
+        uint64_t last_run_ns;
+    } InferenceEngineWarmupTiming;
+
+    typedef struct
+    {
+        uint64_t run_count;
+        uint64_t run_total_ns;
+        uint64_t run_min_ns;
+        uint64_t run_max_ns;
+        uint64_t run_p50_ns;
+        uint64_t run_p99_ns;
+        uint64_t reshape_count;
+        uint64_t reshape_total_ns;
+        uint64_t bytes_bound;
+    } InferenceEngineStats;
+
+    typedef struct
+    {
+        const char *name;
+        const char *op_type;
+        uint64_t start_us;
+        uint64_t duration_us;
+    } InferenceEngineProfileEvent;
+
+    typedef void (*InferenceEngineRunCallback)(void *user_data, InferenceEngineResultCode result_code, const char *error_message);
+
+    // Creates an engine with one of the create functions of the backends and passes its ownership to the registry.
+    typedef InferenceEngineResultCode (*InferenceEngineModelLoader)(void *user_data, void **engine);
+
     void inference_engine__update_last_error_message(const char *message);
     const char *inference_engine__get_last_error_message();
 
+    void inference_engine__get_default_options(InferenceEngineOptions *options);
+
     InferenceEngineResultCode inference_engine__destroy_inference_engine(void *engine);
 
     size_t inference_engine__get_input_count(const void *engine);
@@ -23,16 +112,73 @@ extern "C"
     void inference_engine__get_input_shape(const void *engine, size_t index, const size_t **shape_data, size_t *shape_size);
     void inference_engine__get_output_shape(const void *engine, size_t index, const size_t **shape_data, size_t *shape_size);
 
+    // Shapes are read in place and not retained. Setting the current shapes again allocates nothing.
     InferenceEngineResultCode inference_engine__set_input_shape(void *engine, size_t index, const size_t *shape_data, size_t shape_size);
+    InferenceEngineResultCode inference_engine__set_input_shapes(void *engine, const size_t *const *shape_data, const size_t *shape_sizes, size_t shape_count);
     InferenceEngineResultCode inference_engine__set_output_shape(void *engine, size_t index, const size_t *shape_data, size_t shape_size);
 
+    InferenceEngineElementType inference_engine__get_input_element_type(const void *engine, size_t index);
+    InferenceEngineElementType inference_engine__get_output_element_type(const void *engine, size_t index);
+
+    void *inference_engine__get_input_raw_data(void *engine, size_t index);
+    const void *inference_engine__get_output_raw_data(const void *engine, size_t index);
+
+    // With XNNPACK, TFLite may read up to 16 bytes past the end of input buffers, which must be readable.
+    InferenceEngineResultCode inference_engine__set_input_raw_data(void *engine, size_t index, const void *data);
+    InferenceEngineResultCode inference_engine__set_output_raw_data(void *engine, size_t index, void *data);
+
+    // Null, with the last error message set, unless the tensor holds 32-bit floats.
     float *inference_engine__get_input_data(void *engine, size_t index);
     const float *inference_engine__get_output_data(const void *engine, size_t index);
 
+    // Input buffers need the same readable padding as for inference_engine__set_input_raw_data.
     InferenceEngineResultCode inference_engine__set_input_data(void *engine, size_t index, const float *data);
     InferenceEngineResultCode inference_engine__set_output_data(void *engine, size_t index, float *data);
 
+    InferenceEngineResultCode inference_engine__register_buffer_set(void *engine, const void *const *input_data, size_t input_count, void *const *output_data, size_t output_count, size_t *id);
+    InferenceEngineResultCode inference_engine__select_buffer_set(void *engine, size_t id);
+    InferenceEngineResultCode inference_engine__unregister_buffer_set(void *engine, size_t id);
+
+    // shape_data and shape_sizes hold the input shapes of all sets, one set after another, and timings receives one
+    // entry per set.
+    InferenceEngineResultCode inference_engine__warmup(void *engine, const size_t *const *shape_data, const size_t *shape_sizes, size_t shape_set_count, size_t iterations, InferenceEngineWarmupTiming *timings);
+
+    InferenceEngineResultCode inference_engine__get_stats(const void *engine, InferenceEngineStats *stats);
+    InferenceEngineResultCode inference_engine__reset_stats(void *engine);
+
+    InferenceEngineResultCode inference_engine__start_profiling(void *engine);
+
+    // trace receives the collected events, which are read with the functions below and freed with
+    // inference_engine__destroy_profile_trace. Strings stay valid until then.
+    InferenceEngineResultCode inference_engine__stop_profiling(void *engine, void **trace);
+    void inference_engine__destroy_profile_trace(void *trace);
+
+    void inference_engine__get_profile_trace_labels(const void *trace, const char **engine_label, const char **model_label);
+    size_t inference_engine__get_profile_event_count(const void *trace);
+    void inference_engine__get_profile_event(const void *trace, size_t index, InferenceEngineProfileEvent *event);
+
+    // Setting the current shapes again, binding buffers and reading data pointers between runs allocates nothing, while
+    // the backend may still allocate inside the run.
     InferenceEngineResultCode inference_engine__run(void *engine);
+    InferenceEngineResultCode inference_engine__run_async(void *engine, InferenceEngineRunCallback callback, void *user_data);
+
+    InferenceEngineResultCode inference_engine__create_model_registry(size_t memory_budget, void **registry);
+    InferenceEngineResultCode inference_engine__destroy_model_registry(void *registry);
+
+    // user_data must stay valid until the model is unregistered or the registry is destroyed. A footprint of 0 takes
+    // the one the engine reports once loaded.
+    InferenceEngineResultCode inference_engine__register_model(void *registry, const char *model_id, InferenceEngineModelLoader loader, void *user_data, size_t footprint);
+    InferenceEngineResultCode inference_engine__unregister_model(void *registry, const char *model_id);
+
+    // handle keeps engine loaded until it is passed to inference_engine__release_model. engine can be passed to the
+    // other functions but must not be destroyed.
+    InferenceEngineResultCode inference_engine__acquire_model(void *registry, const char *model_id, void **handle, void **engine);
+    // The handle is destroyed even if releasing it fails.
+    InferenceEngineResultCode inference_engine__release_model(void *handle);
+
+    InferenceEngineResultCode inference_engine__is_model_loaded(const void *registry, const char *model_id, bool *is_loaded);
+    InferenceEngineResultCode inference_engine__get_model_registry_memory_usage(const void *registry, size_t *memory_usage);
+    InferenceEngineResultCode inference_engine__set_model_registry_memory_budget(void *registry, size_t memory_budget);
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "lib_core.h"
+
+#include <inference_engine/EngineOptions.hpp>
+
+namespace inference_engine
+{
+inline EngineOptions to_engine_options(const InferenceEngineOptions *options)
+{
+    EngineOptions engine_options;
+
+    if (options)
+    {
+        engine_options.intra_op_num_threads = options->intra_op_num_threads;
+        engine_options.inter_op_num_threads = options->inter_op_num_threads;
+        engine_options.execution_mode = options->execution_mode == InferenceEngineExecutionMode::Parallel ? ExecutionMode::Parallel : ExecutionMode::Sequential;
+        engine_options.use_global_thread_pool = options->use_global_thread_pool;
+        engine_options.use_float_io = options->use_float_io;
+        engine_options.shape_cache_capacity = options->shape_cache_capacity;
+        engine_options.enable_stats = options->enable_stats;
+        engine_options.enable_profiling = options->enable_profiling;
+        engine_options.optimization_level = static_cast<OptimizationLevel>(options->optimization_level);
+
+        if (options->optimized_model_cache_dir)
+        {
+            engine_options.optimized_model_cache_dir = std::filesystem::u8path(options->optimized_model_cache_dir);
+        }
+
+        engine_options.use_xnnpack = options->use_xnnpack;
+        engine_options.xnnpack_num_threads = options->xnnpack_num_threads;
+        engine_options.xnnpack_enable_quantized = options->xnnpack_enable_quantized;
+        engine_options.xnnpack_force_fp16 = options->xnnpack_force_fp16;
+
+        for (size_t i = 0, offset = 0; i < options->intra_op_thread_affinity_count; i++)
+        {
+            auto cores = options->intra_op_thread_cores + offset;
+            auto core_count = options->intra_op_thread_core_counts[i];
+            engine_options.intra_op_thread_affinities.emplace_back(cores, cores + core_count);
+            offset += core_count;
+        }
+
+        engine_options.numa_node = options->numa_node;
+        engine_options.allow_spinning = options->allow_spinning;
+    }
+
+    return engine_options;
+}
+} // namespace inference_engine
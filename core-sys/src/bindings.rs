@@ -6,12 +6,520 @@ pub enum InferenceEngineResultCode {
     Ok = 0,
     Error = -1,
 }
+#[repr(u32)]
+#[derive(Debug, Copy, Clone, Hash, PartialEq, Eq)]
+pub enum InferenceEngineExecutionMode {
+    Sequential = 0,
+    Parallel = 1,
+}
+#[repr(u32)]
+#[derive(Debug, Copy, Clone, Hash, PartialEq, Eq)]
+pub enum InferenceEngineOptimizationLevel {
+    Disabled = 0,
+    Basic = 1,
+    Extended = 2,
+    All = 3,
+}
+#[repr(u32)]
+#[derive(Debug, Copy, Clone, Hash, PartialEq, Eq)]
+pub enum InferenceEngineElementType {
+    Float32 = 0,
+    Float16 = 1,
+    Int8 = 2,
+    Uint8 = 3,
+    Int16 = 4,
+    Int32 = 5,
+    Int64 = 6,
+    Bool = 7,
+}
+#[repr(C)]
+#[derive(Debug, Copy, Clone)]
+pub struct InferenceEngineOptions {
+    pub intra_op_num_threads: usize,
+    pub inter_op_num_threads: usize,
+    pub execution_mode: InferenceEngineExecutionMode,
+    pub use_global_thread_pool: bool,
+    pub use_float_io: bool,
+    pub shape_cache_capacity: usize,
+    pub enable_stats: bool,
+    pub enable_profiling: bool,
+    pub optimization_level: InferenceEngineOptimizationLevel,
+    pub optimized_model_cache_dir: *const ::std::os::raw::c_char,
+    pub use_xnnpack: bool,
+    pub xnnpack_num_threads: usize,
+    pub xnnpack_enable_quantized: bool,
+    pub xnnpack_force_fp16: bool,
+    pub intra_op_thread_cores: *const usize,
+    pub intra_op_thread_core_counts: *const usize,
+    pub intra_op_thread_affinity_count: usize,
+    pub numa_node: i32,
+    pub allow_spinning: bool,
+}
+#[test]
+fn bindgen_test_layout_InferenceEngineOptions() {
+    const UNINIT: ::std::mem::MaybeUninit<InferenceEngineOptions> =
+        ::std::mem::MaybeUninit::uninit();
+    let ptr = UNINIT.as_ptr();
+    assert_eq!(
+        ::std::mem::size_of::<InferenceEngineOptions>(),
+        104usize,
+        concat!("Size of: ", stringify!(InferenceEngineOptions))
+    );
+    assert_eq!(
+        ::std::mem::align_of::<InferenceEngineOptions>(),
+        8usize,
+        concat!("Alignment of ", stringify!(InferenceEngineOptions))
+    );
+    assert_eq!(
+        unsafe { ::std::ptr::addr_of!((*ptr).intra_op_num_threads) as usize - ptr as usize },
+        0usize,
+        concat!(
+            "Offset of field: ",
+            stringify!(InferenceEngineOptions),
+            "::",
+            stringify!(intra_op_num_threads)
+        )
+    );
+    assert_eq!(
+        unsafe { ::std::ptr::addr_of!((*ptr).inter_op_num_threads) as usize - ptr as usize },
+        8usize,
+        concat!(
+            "Offset of field: ",
+            stringify!(InferenceEngineOptions),
+            "::",
+            stringify!(inter_op_num_threads)
+        )
+    );
+    assert_eq!(
+        unsafe { ::std::ptr::addr_of!((*ptr).execution_mode) as usize - ptr as usize },
+        16usize,
+        concat!(
+            "Offset of field: ",
+            stringify!(InferenceEngineOptions),
+            "::",
+            stringify!(execution_mode)
+        )
+    );
+    assert_eq!(
+        unsafe { ::std::ptr::addr_of!((*ptr).use_global_thread_pool) as usize - ptr as usize },
+        20usize,
+        concat!(
+            "Offset of field: ",
+            stringify!(InferenceEngineOptions),
+            "::",
+            stringify!(use_global_thread_pool)
+        )
+    );
+    assert_eq!(
+        unsafe { ::std::ptr::addr_of!((*ptr).use_float_io) as usize - ptr as usize },
+        21usize,
+        concat!(
+            "Offset of field: ",
+            stringify!(InferenceEngineOptions),
+            "::",
+            stringify!(use_float_io)
+        )
+    );
+    assert_eq!(
+        unsafe { ::std::ptr::addr_of!((*ptr).shape_cache_capacity) as usize - ptr as usize },
+        24usize,
+        concat!(
+            "Offset of field: ",
+            stringify!(InferenceEngineOptions),
+            "::",
+            stringify!(shape_cache_capacity)
+        )
+    );
+    assert_eq!(
+        unsafe { ::std::ptr::addr_of!((*ptr).enable_stats) as usize - ptr as usize },
+        32usize,
+        concat!(
+            "Offset of field: ",
+            stringify!(InferenceEngineOptions),
+            "::",
+            stringify!(enable_stats)
+        )
+    );
+    assert_eq!(
+        unsafe { ::std::ptr::addr_of!((*ptr).enable_profiling) as usize - ptr as usize },
+        33usize,
+        concat!(
+            "Offset of field: ",
+            stringify!(InferenceEngineOptions),
+            "::",
+            stringify!(enable_profiling)
+        )
+    );
+    assert_eq!(
+        unsafe { ::std::ptr::addr_of!((*ptr).optimization_level) as usize - ptr as usize },
+        36usize,
+        concat!(
+            "Offset of field: ",
+            stringify!(InferenceEngineOptions),
+            "::",
+            stringify!(optimization_level)
+        )
+    );
+    assert_eq!(
+        unsafe { ::std::ptr::addr_of!((*ptr).optimized_model_cache_dir) as usize - ptr as usize },
+        40usize,
+        concat!(
+            "Offset of field: ",
+            stringify!(InferenceEngineOptions),
+            "::",
+            stringify!(optimized_model_cache_dir)
+        )
+    );
+    assert_eq!(
+        unsafe { ::std::ptr::addr_of!((*ptr).use_xnnpack) as usize - ptr as usize },
+        48usize,
+        concat!(
+            "Offset of field: ",
+            stringify!(InferenceEngineOptions),
+            "::",
+            stringify!(use_xnnpack)
+        )
+    );
+    assert_eq!(
+        unsafe { ::std::ptr::addr_of!((*ptr).xnnpack_num_threads) as usize - ptr as usize },
+        56usize,
+        concat!(
+            "Offset of field: ",
+            stringify!(InferenceEngineOptions),
+            "::",
+            stringify!(xnnpack_num_threads)
+        )
+    );
+    assert_eq!(
+        unsafe { ::std::ptr::addr_of!((*ptr).xnnpack_enable_quantized) as usize - ptr as usize },
+        64usize,
+        concat!(
+            "Offset of field: ",
+            stringify!(InferenceEngineOptions),
+            "::",
+            stringify!(xnnpack_enable_quantized)
+        )
+    );
+    assert_eq!(
+        unsafe { ::std::ptr::addr_of!((*ptr).xnnpack_force_fp16) as usize - ptr as usize },
+        65usize,
+        concat!(
+            "Offset of field: ",
+            stringify!(InferenceEngineOptions),
+            "::",
+            stringify!(xnnpack_force_fp16)
+        )
+    );
+    assert_eq!(
+        unsafe { ::std::ptr::addr_of!((*ptr).intra_op_thread_cores) as usize - ptr as usize },
+        72usize,
+        concat!(
+            "Offset of field: ",
+            stringify!(InferenceEngineOptions),
+            "::",
+            stringify!(intra_op_thread_cores)
+        )
+    );
+    assert_eq!(
+        unsafe { ::std::ptr::addr_of!((*ptr).intra_op_thread_core_counts) as usize - ptr as usize },
+        80usize,
+        concat!(
+            "Offset of field: ",
+            stringify!(InferenceEngineOptions),
+            "::",
+            stringify!(intra_op_thread_core_counts)
+        )
+    );
+    assert_eq!(
+        unsafe {
+            ::std::ptr::addr_of!((*ptr).intra_op_thread_affinity_count) as usize - ptr as usize
+        },
+        88usize,
+        concat!(
+            "Offset of field: ",
+            stringify!(InferenceEngineOptions),
+            "::",
+            stringify!(intra_op_thread_affinity_count)
+        )
+    );
+    assert_eq!(
+        unsafe { ::std::ptr::addr_of!((*ptr).numa_node) as usize - ptr as usize },
+        96usize,
+        concat!(
+            "Offset of field: ",
+            stringify!(InferenceEngineOptions),
+            "::",
+            stringify!(numa_node)
+        )
+    );
+    assert_eq!(
+        unsafe { ::std::ptr::addr_of!((*ptr).allow_spinning) as usize - ptr as usize },
+        100usize,
+        concat!(
+            "Offset of field: ",
+            stringify!(InferenceEngineOptions),
+            "::",
+            stringify!(allow_spinning)
+        )
+    );
+}
+#[repr(C)]
+#[derive(Debug, Copy, Clone)]
+pub struct InferenceEngineWarmupTiming {
+    pub reshape_ns: u64,
+    pub first_run_ns: u64,
+    pub last_run_ns: u64,
+}
+#[test]
+fn bindgen_test_layout_InferenceEngineWarmupTiming() {
+    const UNINIT: ::std::mem::MaybeUninit<InferenceEngineWarmupTiming> =
+        ::std::mem::MaybeUninit::uninit();
+    let ptr = UNINIT.as_ptr();
+    assert_eq!(
+        ::std::mem::size_of::<InferenceEngineWarmupTiming>(),
+        24usize,
+        concat!("Size of: ", stringify!(InferenceEngineWarmupTiming))
+    );
+    assert_eq!(
+        ::std::mem::align_of::<InferenceEngineWarmupTiming>(),
+        8usize,
+        concat!("Alignment of ", stringify!(InferenceEngineWarmupTiming))
+    );
+    assert_eq!(
+        unsafe { ::std::ptr::addr_of!((*ptr).reshape_ns) as usize - ptr as usize },
+        0usize,
+        concat!(
+            "Offset of field: ",
+            stringify!(InferenceEngineWarmupTiming),
+            "::",
+            stringify!(reshape_ns)
+        )
+    );
+    assert_eq!(
+        unsafe { ::std::ptr::addr_of!((*ptr).first_run_ns) as usize - ptr as usize },
+        8usize,
+        concat!(
+            "Offset of field: ",
+            stringify!(InferenceEngineWarmupTiming),
+            "::",
+            stringify!(first_run_ns)
+        )
+    );
+    assert_eq!(
+        unsafe { ::std::ptr::addr_of!((*ptr).last_run_ns) as usize - ptr as usize },
+        16usize,
+        concat!(
+            "Offset of field: ",
+            stringify!(InferenceEngineWarmupTiming),
+            "::",
+            stringify!(last_run_ns)
+        )
+    );
+}
+#[repr(C)]
+#[derive(Debug, Copy, Clone)]
+pub struct InferenceEngineStats {
+    pub run_count: u64,
+    pub run_total_ns: u64,
+    pub run_min_ns: u64,
+    pub run_max_ns: u64,
+    pub run_p50_ns: u64,
+    pub run_p99_ns: u64,
+    pub reshape_count: u64,
+    pub reshape_total_ns: u64,
+    pub bytes_bound: u64,
+}
+#[test]
+fn bindgen_test_layout_InferenceEngineStats() {
+    const UNINIT: ::std::mem::MaybeUninit<InferenceEngineStats> = ::std::mem::MaybeUninit::uninit();
+    let ptr = UNINIT.as_ptr();
+    assert_eq!(
+        ::std::mem::size_of::<InferenceEngineStats>(),
+        72usize,
+        concat!("Size of: ", stringify!(InferenceEngineStats))
+    );
+    assert_eq!(
+        ::std::mem::align_of::<InferenceEngineStats>(),
+        8usize,
+        concat!("Alignment of ", stringify!(InferenceEngineStats))
+    );
+    assert_eq!(
+        unsafe { ::std::ptr::addr_of!((*ptr).run_count) as usize - ptr as usize },
+        0usize,
+        concat!(
+            "Offset of field: ",
+            stringify!(InferenceEngineStats),
+            "::",
+            stringify!(run_count)
+        )
+    );
+    assert_eq!(
+        unsafe { ::std::ptr::addr_of!((*ptr).run_total_ns) as usize - ptr as usize },
+        8usize,
+        concat!(
+            "Offset of field: ",
+            stringify!(InferenceEngineStats),
+            "::",
+            stringify!(run_total_ns)
+        )
+    );
+    assert_eq!(
+        unsafe { ::std::ptr::addr_of!((*ptr).run_min_ns) as usize - ptr as usize },
+        16usize,
+        concat!(
+            "Offset of field: ",
+            stringify!(InferenceEngineStats),
+            "::",
+            stringify!(run_min_ns)
+        )
+    );
+    assert_eq!(
+        unsafe { ::std::ptr::addr_of!((*ptr).run_max_ns) as usize - ptr as usize },
+        24usize,
+        concat!(
+            "Offset of field: ",
+            stringify!(InferenceEngineStats),
+            "::",
+            stringify!(run_max_ns)
+        )
+    );
+    assert_eq!(
+        unsafe { ::std::ptr::addr_of!((*ptr).run_p50_ns) as usize - ptr as usize },
+        32usize,
+        concat!(
+            "Offset of field: ",
+            stringify!(InferenceEngineStats),
+            "::",
+            stringify!(run_p50_ns)
+        )
+    );
+    assert_eq!(
+        unsafe { ::std::ptr::addr_of!((*ptr).run_p99_ns) as usize - ptr as usize },
+        40usize,
+        concat!(
+            "Offset of field: ",
+            stringify!(InferenceEngineStats),
+            "::",
+            stringify!(run_p99_ns)
+        )
+    );
+    assert_eq!(
+        unsafe { ::std::ptr::addr_of!((*ptr).reshape_count) as usize - ptr as usize },
+        48usize,
+        concat!(
+            "Offset of field: ",
+            stringify!(InferenceEngineStats),
+            "::",
+            stringify!(reshape_count)
+        )
+    );
+    assert_eq!(
+        unsafe { ::std::ptr::addr_of!((*ptr).reshape_total_ns) as usize - ptr as usize },
+        56usize,
+        concat!(
+            "Offset of field: ",
+            stringify!(InferenceEngineStats),
+            "::",
+            stringify!(reshape_total_ns)
+        )
+    );
+    assert_eq!(
+        unsafe { ::std::ptr::addr_of!((*ptr).bytes_bound) as usize - ptr as usize },
+        64usize,
+        concat!(
+            "Offset of field: ",
+            stringify!(InferenceEngineStats),
+            "::",
+            stringify!(bytes_bound)
+        )
+    );
+}
+#[repr(C)]
+#[derive(Debug, Copy, Clone)]
+pub struct InferenceEngineProfileEvent {
+    pub name: *const ::std::os::raw::c_char,
+    pub op_type: *const ::std::os::raw::c_char,
+    pub start_us: u64,
+    pub duration_us: u64,
+}
+#[test]
+fn bindgen_test_layout_InferenceEngineProfileEvent() {
+    const UNINIT: ::std::mem::MaybeUninit<InferenceEngineProfileEvent> =
+        ::std::mem::MaybeUninit::uninit();
+    let ptr = UNINIT.as_ptr();
+    assert_eq!(
+        ::std::mem::size_of::<InferenceEngineProfileEvent>(),
+        32usize,
+        concat!("Size of: ", stringify!(InferenceEngineProfileEvent))
+    );
+    assert_eq!(
+        ::std::mem::align_of::<InferenceEngineProfileEvent>(),
+        8usize,
+        concat!("Alignment of ", stringify!(InferenceEngineProfileEvent))
+    );
+    assert_eq!(
+        unsafe { ::std::ptr::addr_of!((*ptr).name) as usize - ptr as usize },
+        0usize,
+        concat!(
+            "Offset of field: ",
+            stringify!(InferenceEngineProfileEvent),
+            "::",
+            stringify!(name)
+        )
+    );
+    assert_eq!(
+        unsafe { ::std::ptr::addr_of!((*ptr).op_type) as usize - ptr as usize },
+        8usize,
+        concat!(
+            "Offset of field: ",
+            stringify!(InferenceEngineProfileEvent),
+            "::",
+            stringify!(op_type)
+        )
+    );
+    assert_eq!(
+        unsafe { ::std::ptr::addr_of!((*ptr).start_us) as usize - ptr as usize },
+        16usize,
+        concat!(
+            "Offset of field: ",
+            stringify!(InferenceEngineProfileEvent),
+            "::",
+            stringify!(start_us)
+        )
+    );
+    assert_eq!(
+        unsafe { ::std::ptr::addr_of!((*ptr).duration_us) as usize - ptr as usize },
+        24usize,
+        concat!(
+            "Offset of field: ",
+            stringify!(InferenceEngineProfileEvent),
+            "::",
+            stringify!(duration_us)
+        )
+    );
+}
+pub type InferenceEngineRunCallback = ::std::option::Option<
+    unsafe extern "C" fn(
+        user_data: *mut ::std::os::raw::c_void,
+        result_code: InferenceEngineResultCode,
+        error_message: *const ::std::os::raw::c_char,
+    ),
+>;
+pub type InferenceEngineModelLoader = ::std::option::Option<
+    unsafe extern "C" fn(
+        user_data: *mut ::std::os::raw::c_void,
+        engine: *mut *mut ::std::os::raw::c_void,
+    ) -> InferenceEngineResultCode,
+>;
 extern "C" {
     pub fn inference_engine__update_last_error_message(message: *const ::std::os::raw::c_char);
 }
 extern "C" {
     pub fn inference_engine__get_last_error_message() -> *const ::std::os::raw::c_char;
 }
+extern "C" {
+    pub fn inference_engine__get_default_options(options: *mut InferenceEngineOptions);
+}
 extern "C" {
     pub fn inference_engine__destroy_inference_engine(
         engine: *mut ::std::os::raw::c_void,
@@ -47,6 +555,14 @@ extern "C" {
         shape_size: usize,
     ) -> InferenceEngineResultCode;
 }
+extern "C" {
+    pub fn inference_engine__set_input_shapes(
+        engine: *mut ::std::os::raw::c_void,
+        shape_data: *const *const usize,
+        shape_sizes: *const usize,
+        shape_count: usize,
+    ) -> InferenceEngineResultCode;
+}
 extern "C" {
     pub fn inference_engine__set_output_shape(
         engine: *mut ::std::os::raw::c_void,
@@ -55,6 +571,44 @@ extern "C" {
         shape_size: usize,
     ) -> InferenceEngineResultCode;
 }
+extern "C" {
+    pub fn inference_engine__get_input_element_type(
+        engine: *const ::std::os::raw::c_void,
+        index: usize,
+    ) -> InferenceEngineElementType;
+}
+extern "C" {
+    pub fn inference_engine__get_output_element_type(
+        engine: *const ::std::os::raw::c_void,
+        index: usize,
+    ) -> InferenceEngineElementType;
+}
+extern "C" {
+    pub fn inference_engine__get_input_raw_data(
+        engine: *mut ::std::os::raw::c_void,
+        index: usize,
+    ) -> *mut ::std::os::raw::c_void;
+}
+extern "C" {
+    pub fn inference_engine__get_output_raw_data(
+        engine: *const ::std::os::raw::c_void,
+        index: usize,
+    ) -> *const ::std::os::raw::c_void;
+}
+extern "C" {
+    pub fn inference_engine__set_input_raw_data(
+        engine: *mut ::std::os::raw::c_void,
+        index: usize,
+        data: *const ::std::os::raw::c_void,
+    ) -> InferenceEngineResultCode;
+}
+extern "C" {
+    pub fn inference_engine__set_output_raw_data(
+        engine: *mut ::std::os::raw::c_void,
+        index: usize,
+        data: *mut ::std::os::raw::c_void,
+    ) -> InferenceEngineResultCode;
+}
 extern "C" {
     pub fn inference_engine__get_input_data(
         engine: *mut ::std::os::raw::c_void,
@@ -81,6 +635,146 @@ extern "C" {
         data: *mut f32,
     ) -> InferenceEngineResultCode;
 }
+extern "C" {
+    pub fn inference_engine__register_buffer_set(
+        engine: *mut ::std::os::raw::c_void,
+        input_data: *const *const ::std::os::raw::c_void,
+        input_count: usize,
+        output_data: *const *mut ::std::os::raw::c_void,
+        output_count: usize,
+        id: *mut usize,
+    ) -> InferenceEngineResultCode;
+}
+extern "C" {
+    pub fn inference_engine__select_buffer_set(
+        engine: *mut ::std::os::raw::c_void,
+        id: usize,
+    ) -> InferenceEngineResultCode;
+}
+extern "C" {
+    pub fn inference_engine__unregister_buffer_set(
+        engine: *mut ::std::os::raw::c_void,
+        id: usize,
+    ) -> InferenceEngineResultCode;
+}
+extern "C" {
+    pub fn inference_engine__warmup(
+        engine: *mut ::std::os::raw::c_void,
+        shape_data: *const *const usize,
+        shape_sizes: *const usize,
+        shape_set_count: usize,
+        iterations: usize,
+        timings: *mut InferenceEngineWarmupTiming,
+    ) -> InferenceEngineResultCode;
+}
+extern "C" {
+    pub fn inference_engine__get_stats(
+        engine: *const ::std::os::raw::c_void,
+        stats: *mut InferenceEngineStats,
+    ) -> InferenceEngineResultCode;
+}
+extern "C" {
+    pub fn inference_engine__reset_stats(
+        engine: *mut ::std::os::raw::c_void,
+    ) -> InferenceEngineResultCode;
+}
+extern "C" {
+    pub fn inference_engine__start_profiling(
+        engine: *mut ::std::os::raw::c_void,
+    ) -> InferenceEngineResultCode;
+}
+extern "C" {
+    pub fn inference_engine__stop_profiling(
+        engine: *mut ::std::os::raw::c_void,
+        trace: *mut *mut ::std::os::raw::c_void,
+    ) -> InferenceEngineResultCode;
+}
+extern "C" {
+    pub fn inference_engine__destroy_profile_trace(trace: *mut ::std::os::raw::c_void);
+}
+extern "C" {
+    pub fn inference_engine__get_profile_trace_labels(
+        trace: *const ::std::os::raw::c_void,
+        engine_label: *mut *const ::std::os::raw::c_char,
+        model_label: *mut *const ::std::os::raw::c_char,
+    );
+}
+extern "C" {
+    pub fn inference_engine__get_profile_event_count(trace: *const ::std::os::raw::c_void)
+        -> usize;
+}
+extern "C" {
+    pub fn inference_engine__get_profile_event(
+        trace: *const ::std::os::raw::c_void,
+        index: usize,
+        event: *mut InferenceEngineProfileEvent,
+    );
+}
 extern "C" {
     pub fn inference_engine__run(engine: *mut ::std::os::raw::c_void) -> InferenceEngineResultCode;
 }
+extern "C" {
+    pub fn inference_engine__run_async(
+        engine: *mut ::std::os::raw::c_void,
+        callback: InferenceEngineRunCallback,
+        user_data: *mut ::std::os::raw::c_void,
+    ) -> InferenceEngineResultCode;
+}
+extern "C" {
+    pub fn inference_engine__create_model_registry(
+        memory_budget: usize,
+        registry: *mut *mut ::std::os::raw::c_void,
+    ) -> InferenceEngineResultCode;
+}
+extern "C" {
+    pub fn inference_engine__destroy_model_registry(
+        registry: *mut ::std::os::raw::c_void,
+    ) -> InferenceEngineResultCode;
+}
+extern "C" {
+    pub fn inference_engine__register_model(
+        registry: *mut ::std::os::raw::c_void,
+        model_id: *const ::std::os::raw::c_char,
+        loader: InferenceEngineModelLoader,
+        user_data: *mut ::std::os::raw::c_void,
+        footprint: usize,
+    ) -> InferenceEngineResultCode;
+}
+extern "C" {
+    pub fn inference_engine__unregister_model(
+        registry: *mut ::std::os::raw::c_void,
+        model_id: *const ::std::os::raw::c_char,
+    ) -> InferenceEngineResultCode;
+}
+extern "C" {
+    pub fn inference_engine__acquire_model(
+        registry: *mut ::std::os::raw::c_void,
+        model_id: *const ::std::os::raw::c_char,
+        handle: *mut *mut ::std::os::raw::c_void,
+        engine: *mut *mut ::std::os::raw::c_void,
+    ) -> InferenceEngineResultCode;
+}
+extern "C" {
+    pub fn inference_engine__release_model(
+        handle: *mut ::std::os::raw::c_void,
+    ) -> InferenceEngineResultCode;
+}
+extern "C" {
+    pub fn inference_engine__is_model_loaded(
+        registry: *const ::std::os::raw::c_void,
+        model_id: *const ::std::os::raw::c_char,
+        is_loaded: *mut bool,
+    ) -> InferenceEngineResultCode;
+}
+extern "C" {
+    pub fn inference_engine__get_model_registry_memory_usage(
+        registry: *const ::std::os::raw::c_void,
+        memory_usage: *mut usize,
+    ) -> InferenceEngineResultCode;
+}
+extern "C" {
+    pub fn inference_engine__set_model_registry_memory_budget(
+        registry: *mut ::std::os::raw::c_void,
+        memory_budget: usize,
+    ) -> InferenceEngineResultCode;
+}
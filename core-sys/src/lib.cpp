@@ -1,12 +1,23 @@
 #include "lib_core.h"
 
+#include <inference_engine/EngineOptions.hpp>
 #include <inference_engine/InferenceEngine.hpp>
+#include <inference_engine/ModelRegistry.hpp>
+#include <memory>
+#include <stdexcept>
 #include <string>
+#include <vector>
 
 using InferenceEngine = inference_engine::InferenceEngine;
+using ModelRegistry = inference_engine::ModelRegistry;
+using ProfileTrace = inference_engine::ProfileTrace;
+using ShapeSpan = inference_engine::Span<const size_t>;
 
 thread_local std::string inference_engine__last_error_message;
 
+// Views of the shapes passed to inference_engine__set_input_shapes, kept so that their storage is reused across calls.
+thread_local std::vector<ShapeSpan> inference_engine__input_shape_spans;
+
 void inference_engine__update_last_error_message(const char *message)
 {
     inference_engine__last_error_message = message;
@@ -17,6 +28,28 @@ const char *inference_engine__get_last_error_message()
     return inference_engine__last_error_message.c_str();
 }
 
+void inference_engine__get_default_options(InferenceEngineOptions *options)
+{
+    inference_engine::EngineOptions defaults;
+
+    *options = {};
+    options->intra_op_num_threads = defaults.intra_op_num_threads;
+    options->inter_op_num_threads = defaults.inter_op_num_threads;
+    options->execution_mode = static_cast<InferenceEngineExecutionMode>(defaults.execution_mode);
+    options->use_global_thread_pool = defaults.use_global_thread_pool;
+    options->use_float_io = defaults.use_float_io;
+    options->shape_cache_capacity = defaults.shape_cache_capacity;
+    options->enable_stats = defaults.enable_stats;
+    options->enable_profiling = defaults.enable_profiling;
+    options->optimization_level = static_cast<InferenceEngineOptimizationLevel>(defaults.optimization_level);
+    options->use_xnnpack = defaults.use_xnnpack;
+    options->xnnpack_num_threads = defaults.xnnpack_num_threads;
+    options->xnnpack_enable_quantized = defaults.xnnpack_enable_quantized;
+    options->xnnpack_force_fp16 = defaults.xnnpack_force_fp16;
+    options->numa_node = defaults.numa_node;
+    options->allow_spinning = defaults.allow_spinning;
+}
+
 InferenceEngineResultCode inference_engine__destroy_inference_engine(void *engine)
 {
     try
@@ -59,7 +92,29 @@ InferenceEngineResultCode inference_engine__set_input_shape(void *engine, size_t
 {
     try
     {
-        static_cast<InferenceEngine *>(engine)->set_input_shape(index, {shape_data, shape_data + shape_size});
+        static_cast<InferenceEngine *>(engine)->set_input_shape(index, ShapeSpan(shape_data, shape_size));
+        return InferenceEngineResultCode::Ok;
+    }
+    catch (const std::exception &e)
+    {
+        inference_engine__update_last_error_message(e.what());
+        return InferenceEngineResultCode::Error;
+    }
+}
+
+InferenceEngineResultCode inference_engine__set_input_shapes(void *engine, const size_t *const *shape_data, const size_t *shape_sizes, size_t shape_count)
+{
+    try
+    {
+        auto &shapes = inference_engine__input_shape_spans;
+        shapes.clear();
+
+        for (auto i = 0; i < shape_count; i++)
+        {
+            shapes.emplace_back(shape_data[i], shape_sizes[i]);
+        }
+
+        static_cast<InferenceEngine *>(engine)->set_input_shapes(shapes);
         return InferenceEngineResultCode::Ok;
     }
     catch (const std::exception &e)
@@ -73,7 +128,55 @@ InferenceEngineResultCode inference_engine__set_output_shape(void *engine, size_
 {
     try
     {
-        static_cast<InferenceEngine *>(engine)->set_output_shape(index, {shape_data, shape_data + shape_size});
+        static_cast<InferenceEngine *>(engine)->set_output_shape(index, ShapeSpan(shape_data, shape_size));
+        return InferenceEngineResultCode::Ok;
+    }
+    catch (const std::exception &e)
+    {
+        inference_engine__update_last_error_message(e.what());
+        return InferenceEngineResultCode::Error;
+    }
+}
+
+InferenceEngineElementType inference_engine__get_input_element_type(const void *engine, size_t index)
+{
+    return static_cast<InferenceEngineElementType>(static_cast<const InferenceEngine *>(engine)->get_input_element_type(index));
+}
+
+InferenceEngineElementType inference_engine__get_output_element_type(const void *engine, size_t index)
+{
+    return static_cast<InferenceEngineElementType>(static_cast<const InferenceEngine *>(engine)->get_output_element_type(index));
+}
+
+void *inference_engine__get_input_raw_data(void *engine, size_t index)
+{
+    return static_cast<InferenceEngine *>(engine)->get_input_raw_data(index);
+}
+
+const void *inference_engine__get_output_raw_data(const void *engine, size_t index)
+{
+    return static_cast<const InferenceEngine *>(engine)->get_output_raw_data(index);
+}
+
+InferenceEngineResultCode inference_engine__set_input_raw_data(void *engine, size_t index, const void *data)
+{
+    try
+    {
+        static_cast<InferenceEngine *>(engine)->set_input_raw_data(index, data);
+        return InferenceEngineResultCode::Ok;
+    }
+    catch (const std::exception &e)
+    {
+        inference_engine__update_last_error_message(e.what());
+        return InferenceEngineResultCode::Error;
+    }
+}
+
+InferenceEngineResultCode inference_engine__set_output_raw_data(void *engine, size_t index, void *data)
+{
+    try
+    {
+        static_cast<InferenceEngine *>(engine)->set_output_raw_data(index, data);
         return InferenceEngineResultCode::Ok;
     }
     catch (const std::exception &e)
@@ -85,12 +188,28 @@ InferenceEngineResultCode inference_engine__set_output_shape(void *engine, size_
 
 float *inference_engine__get_input_data(void *engine, size_t index)
 {
-    return static_cast<InferenceEngine *>(engine)->get_input_data(index);
+    try
+    {
+        return static_cast<InferenceEngine *>(engine)->get_input_data(index);
+    }
+    catch (const std::exception &e)
+    {
+        inference_engine__update_last_error_message(e.what());
+        return nullptr;
+    }
 }
 
 const float *inference_engine__get_output_data(const void *engine, size_t index)
 {
-    return static_cast<const InferenceEngine *>(engine)->get_output_data(index);
+    try
+    {
+        return static_cast<const InferenceEngine *>(engine)->get_output_data(index);
+    }
+    catch (const std::exception &e)
+    {
+        inference_engine__update_last_error_message(e.what());
+        return nullptr;
+    }
 }
 
 InferenceEngineResultCode inference_engine__set_input_data(void *engine, size_t index, const float *data)
@@ -121,6 +240,173 @@ InferenceEngineResultCode inference_engine__set_output_data(void *engine, size_t
     }
 }
 
+InferenceEngineResultCode inference_engine__register_buffer_set(void *engine, const void *const *input_data, size_t input_count, void *const *output_data, size_t output_count, size_t *id)
+{
+    try
+    {
+        *id = static_cast<InferenceEngine *>(engine)->register_buffer_set(
+            {input_data, input_data + input_count},
+            {output_data, output_data + output_count}
+        );
+        return InferenceEngineResultCode::Ok;
+    }
+    catch (const std::exception &e)
+    {
+        inference_engine__update_last_error_message(e.what());
+        return InferenceEngineResultCode::Error;
+    }
+}
+
+InferenceEngineResultCode inference_engine__select_buffer_set(void *engine, size_t id)
+{
+    try
+    {
+        static_cast<InferenceEngine *>(engine)->select_buffer_set(id);
+        return InferenceEngineResultCode::Ok;
+    }
+    catch (const std::exception &e)
+    {
+        inference_engine__update_last_error_message(e.what());
+        return InferenceEngineResultCode::Error;
+    }
+}
+
+InferenceEngineResultCode inference_engine__unregister_buffer_set(void *engine, size_t id)
+{
+    try
+    {
+        static_cast<InferenceEngine *>(engine)->unregister_buffer_set(id);
+        return InferenceEngineResultCode::Ok;
+    }
+    catch (const std::exception &e)
+    {
+        inference_engine__update_last_error_message(e.what());
+        return InferenceEngineResultCode::Error;
+    }
+}
+
+InferenceEngineResultCode inference_engine__warmup(void *engine, const size_t *const *shape_data, const size_t *shape_sizes, size_t shape_set_count, size_t iterations, InferenceEngineWarmupTiming *timings)
+{
+    try
+    {
+        auto inference_engine = static_cast<InferenceEngine *>(engine);
+        auto input_count = inference_engine->get_input_count();
+        std::vector<std::vector<std::vector<size_t>>> shape_sets(shape_set_count);
+
+        for (auto i = 0; i < shape_set_count * input_count; i++)
+        {
+            shape_sets[i / input_count].emplace_back(shape_data[i], shape_data[i] + shape_sizes[i]);
+        }
+
+        auto engine_timings = inference_engine->warmup(shape_sets, iterations);
+
+        for (auto i = 0; i < engine_timings.size(); i++)
+        {
+            timings[i].reshape_ns = engine_timings[i].reshape.count();
+            timings[i].first_run_ns = engine_timings[i].first_run.count();
+            timings[i].last_run_ns = engine_timings[i].last_run.count();
+        }
+
+        return InferenceEngineResultCode::Ok;
+    }
+    catch (const std::exception &e)
+    {
+        inference_engine__update_last_error_message(e.what());
+        return InferenceEngineResultCode::Error;
+    }
+}
+
+InferenceEngineResultCode inference_engine__get_stats(const void *engine, InferenceEngineStats *stats)
+{
+    try
+    {
+        auto engine_stats = static_cast<const InferenceEngine *>(engine)->get_stats();
+        stats->run_count = engine_stats.run_count;
+        stats->run_total_ns = engine_stats.run_time_total.count();
+        stats->run_min_ns = engine_stats.run_time_min.count();
+        stats->run_max_ns = engine_stats.run_time_max.count();
+        stats->run_p50_ns = engine_stats.run_time_p50.count();
+        stats->run_p99_ns = engine_stats.run_time_p99.count();
+        stats->reshape_count = engine_stats.reshape_count;
+        stats->reshape_total_ns = engine_stats.reshape_time_total.count();
+        stats->bytes_bound = engine_stats.bytes_bound;
+        return InferenceEngineResultCode::Ok;
+    }
+    catch (const std::exception &e)
+    {
+        inference_engine__update_last_error_message(e.what());
+        return InferenceEngineResultCode::Error;
+    }
+}
+
+InferenceEngineResultCode inference_engine__reset_stats(void *engine)
+{
+    try
+    {
+        static_cast<InferenceEngine *>(engine)->reset_stats();
+        return InferenceEngineResultCode::Ok;
+    }
+    catch (const std::exception &e)
+    {
+        inference_engine__update_last_error_message(e.what());
+        return InferenceEngineResultCode::Error;
+    }
+}
+
+InferenceEngineResultCode inference_engine__start_profiling(void *engine)
+{
+    try
+    {
+        static_cast<InferenceEngine *>(engine)->start_profiling();
+        return InferenceEngineResultCode::Ok;
+    }
+    catch (const std::exception &e)
+    {
+        inference_engine__update_last_error_message(e.what());
+        return InferenceEngineResultCode::Error;
+    }
+}
+
+InferenceEngineResultCode inference_engine__stop_profiling(void *engine, void **trace)
+{
+    try
+    {
+        *trace = new ProfileTrace(static_cast<InferenceEngine *>(engine)->stop_profiling());
+        return InferenceEngineResultCode::Ok;
+    }
+    catch (const std::exception &e)
+    {
+        inference_engine__update_last_error_message(e.what());
+        return InferenceEngineResultCode::Error;
+    }
+}
+
+void inference_engine__destroy_profile_trace(void *trace)
+{
+    delete static_cast<ProfileTrace *>(trace);
+}
+
+void inference_engine__get_profile_trace_labels(const void *trace, const char **engine_label, const char **model_label)
+{
+    auto profile_trace = static_cast<const ProfileTrace *>(trace);
+    *engine_label = profile_trace->engine.c_str();
+    *model_label = profile_trace->model.c_str();
+}
+
+size_t inference_engine__get_profile_event_count(const void *trace)
+{
+    return static_cast<const ProfileTrace *>(trace)->events.size();
+}
+
+void inference_engine__get_profile_event(const void *trace, size_t index, InferenceEngineProfileEvent *event)
+{
+    const auto &profile_event = static_cast<const ProfileTrace *>(trace)->events[index];
+    event->name = profile_event.name.c_str();
+    event->op_type = profile_event.op_type.c_str();
+    event->start_us = profile_event.start.count();
+    event->duration_us = profile_event.duration.count();
+}
+
 InferenceEngineResultCode inference_engine__run(void *engine)
 {
     try
@@ -134,3 +420,181 @@ InferenceEngineResultCode inference_engine__run(void *engine)
         return InferenceEngineResultCode::Error;
     }
 }
+
+InferenceEngineResultCode inference_engine__run_async(void *engine, InferenceEngineRunCallback callback, void *user_data)
+{
+    try
+    {
+        static_cast<InferenceEngine *>(engine)->run_async([callback, user_data](std::exception_ptr error) {
+            if (!error)
+            {
+                callback(user_data, InferenceEngineResultCode::Ok, nullptr);
+                return;
+            }
+
+            try
+            {
+                std::rethrow_exception(error);
+            }
+            catch (const std::exception &e)
+            {
+                inference_engine__update_last_error_message(e.what());
+                callback(user_data, InferenceEngineResultCode::Error, e.what());
+            }
+            catch (...)
+            {
+                // The callback must run for every run, or the caller waits forever.
+                inference_engine__update_last_error_message("unknown error");
+                callback(user_data, InferenceEngineResultCode::Error, "unknown error");
+            }
+        });
+        return InferenceEngineResultCode::Ok;
+    }
+    catch (const std::exception &e)
+    {
+        inference_engine__update_last_error_message(e.what());
+        return InferenceEngineResultCode::Error;
+    }
+}
+
+InferenceEngineResultCode inference_engine__create_model_registry(size_t memory_budget, void **registry)
+{
+    try
+    {
+        *registry = new ModelRegistry(memory_budget);
+        return InferenceEngineResultCode::Ok;
+    }
+    catch (const std::exception &e)
+    {
+        inference_engine__update_last_error_message(e.what());
+        return InferenceEngineResultCode::Error;
+    }
+}
+
+InferenceEngineResultCode inference_engine__destroy_model_registry(void *registry)
+{
+    try
+    {
+        delete static_cast<ModelRegistry *>(registry);
+        return InferenceEngineResultCode::Ok;
+    }
+    catch (const std::exception &e)
+    {
+        inference_engine__update_last_error_message(e.what());
+        return InferenceEngineResultCode::Error;
+    }
+}
+
+InferenceEngineResultCode inference_engine__register_model(void *registry, const char *model_id, InferenceEngineModelLoader loader, void *user_data, size_t footprint)
+{
+    try
+    {
+        auto load = [loader, user_data] {
+            void *engine = nullptr;
+
+            if (loader(user_data, &engine) != InferenceEngineResultCode::Ok)
+            {
+                throw std::runtime_error(inference_engine__get_last_error_message());
+            }
+
+            return std::unique_ptr<InferenceEngine>(static_cast<InferenceEngine *>(engine));
+        };
+
+        static_cast<ModelRegistry *>(registry)->register_model(model_id, load, footprint);
+        return InferenceEngineResultCode::Ok;
+    }
+    catch (const std::exception &e)
+    {
+        inference_engine__update_last_error_message(e.what());
+        return InferenceEngineResultCode::Error;
+    }
+}
+
+InferenceEngineResultCode inference_engine__unregister_model(void *registry, const char *model_id)
+{
+    try
+    {
+        static_cast<ModelRegistry *>(registry)->unregister_model(model_id);
+        return InferenceEngineResultCode::Ok;
+    }
+    catch (const std::exception &e)
+    {
+        inference_engine__update_last_error_message(e.what());
+        return InferenceEngineResultCode::Error;
+    }
+}
+
+InferenceEngineResultCode inference_engine__acquire_model(void *registry, const char *model_id, void **handle, void **engine)
+{
+    try
+    {
+        auto model_handle = new ModelRegistry::Handle(static_cast<ModelRegistry *>(registry)->acquire(model_id));
+        *handle = model_handle;
+        *engine = model_handle->get();
+        return InferenceEngineResultCode::Ok;
+    }
+    catch (const std::exception &e)
+    {
+        inference_engine__update_last_error_message(e.what());
+        return InferenceEngineResultCode::Error;
+    }
+}
+
+// Releasing before deleting keeps errors of the release out of the destructor.
+InferenceEngineResultCode inference_engine__release_model(void *handle)
+{
+    std::unique_ptr<ModelRegistry::Handle> model_handle(static_cast<ModelRegistry::Handle *>(handle));
+
+    try
+    {
+        model_handle->release();
+        return InferenceEngineResultCode::Ok;
+    }
+    catch (const std::exception &e)
+    {
+        inference_engine__update_last_error_message(e.what());
+        return InferenceEngineResultCode::Error;
+    }
+}
+
+InferenceEngineResultCode inference_engine__is_model_loaded(const void *registry, const char *model_id, bool *is_loaded)
+{
+    try
+    {
+        *is_loaded = static_cast<const ModelRegistry *>(registry)->is_loaded(model_id);
+        return InferenceEngineResultCode::Ok;
+    }
+    catch (const std::exception &e)
+    {
+        inference_engine__update_last_error_message(e.what());
+        return InferenceEngineResultCode::Error;
+    }
+}
+
+InferenceEngineResultCode inference_engine__get_model_registry_memory_usage(const void *registry, size_t *memory_usage)
+{
+    try
+    {
+        *memory_usage = static_cast<const ModelRegistry *>(registry)->get_memory_usage();
+        return InferenceEngineResultCode::Ok;
+    }
+    catch (const std::exception &e)
+    {
+        inference_engine__update_last_error_message(e.what());
+        return InferenceEngineResultCode::Error;
+    }
+}
+
+InferenceEngineResultCode inference_engine__set_model_registry_memory_budget(void *registry, size_t memory_budget)
+{
+    try
+    {
+        static_cast<ModelRegistry *>(registry)->set_memory_budget(memory_budget);
+        return InferenceEngineResultCode::Ok;
+    }
+    catch (const std::exception &e)
+    {
+        inference_engine__update_last_error_message(e.what());
+        return InferenceEngineResultCode::Error;
+    }
+}
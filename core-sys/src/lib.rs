@@ -1,4 +1,10 @@
-include!("bindings.rs");
+// Generated layout tests are named after the C types.
+#[allow(non_snake_case)]
+mod bindings {
+    include!("bindings.rs");
+}
+
+pub use bindings::*;
 
 impl From<InferenceEngineResultCode> for Result<(), inference_engine_core::Error> {
     fn from(code: InferenceEngineResultCode) -> Self {
@@ -15,15 +21,220 @@ impl From<InferenceEngineResultCode> for Result<(), inference_engine_core::Error
     }
 }
 
+// Options passed to the sys crates, together with the C strings and arrays they point to.
+pub struct RawEngineOptions {
+    options: InferenceEngineOptions,
+    _optimized_model_cache_dir: Option<std::ffi::CString>,
+    _intra_op_thread_cores: Vec<usize>,
+    _intra_op_thread_core_counts: Vec<usize>,
+}
+
+impl RawEngineOptions {
+    pub fn as_ptr(&self) -> *const InferenceEngineOptions {
+        &self.options
+    }
+}
+
+impl TryFrom<&inference_engine_core::EngineOptions> for RawEngineOptions {
+    type Error = inference_engine_core::Error;
+
+    fn try_from(options: &inference_engine_core::EngineOptions) -> Result<Self, Self::Error> {
+        let optimized_model_cache_dir = options
+            .optimized_model_cache_dir
+            .as_ref()
+            .map(|dir| std::ffi::CString::new(dir.to_string_lossy().as_bytes()))
+            .transpose()
+            .map_err(|e| inference_engine_core::Error::Unknown(Box::new(e)))?;
+        let intra_op_thread_cores: Vec<usize> = options.intra_op_thread_affinities.concat();
+        let intra_op_thread_core_counts: Vec<usize> = options
+            .intra_op_thread_affinities
+            .iter()
+            .map(|cores| cores.len())
+            .collect();
+        let numa_node = match options.numa_node {
+            Some(node) => i32::try_from(node)
+                .map_err(|e| inference_engine_core::Error::Unknown(Box::new(e)))?,
+            None => -1,
+        };
+
+        Ok(Self {
+            options: InferenceEngineOptions {
+                intra_op_num_threads: options.intra_op_num_threads,
+                inter_op_num_threads: options.inter_op_num_threads,
+                execution_mode: match options.execution_mode {
+                    inference_engine_core::ExecutionMode::Sequential => {
+                        InferenceEngineExecutionMode::Sequential
+                    }
+                    inference_engine_core::ExecutionMode::Parallel => {
+                        InferenceEngineExecutionMode::Parallel
+                    }
+                },
+                use_global_thread_pool: options.use_global_thread_pool,
+                use_float_io: options.use_float_io,
+                shape_cache_capacity: options.shape_cache_capacity,
+                enable_stats: options.enable_stats,
+                enable_profiling: options.enable_profiling,
+                optimization_level: match options.optimization_level {
+                    inference_engine_core::OptimizationLevel::Disabled => {
+                        InferenceEngineOptimizationLevel::Disabled
+                    }
+                    inference_engine_core::OptimizationLevel::Basic => {
+                        InferenceEngineOptimizationLevel::Basic
+                    }
+                    inference_engine_core::OptimizationLevel::Extended => {
+                        InferenceEngineOptimizationLevel::Extended
+                    }
+                    inference_engine_core::OptimizationLevel::All => {
+                        InferenceEngineOptimizationLevel::All
+                    }
+                },
+                optimized_model_cache_dir: optimized_model_cache_dir
+                    .as_ref()
+                    .map_or(std::ptr::null(), |dir| dir.as_ptr()),
+                use_xnnpack: options.use_xnnpack,
+                xnnpack_num_threads: options.xnnpack_num_threads,
+                xnnpack_enable_quantized: options.xnnpack_enable_quantized,
+                xnnpack_force_fp16: options.xnnpack_force_fp16,
+                intra_op_thread_cores: intra_op_thread_cores.as_ptr(),
+                intra_op_thread_core_counts: intra_op_thread_core_counts.as_ptr(),
+                intra_op_thread_affinity_count: intra_op_thread_core_counts.len(),
+                numa_node,
+                allow_spinning: options.allow_spinning,
+            },
+            _optimized_model_cache_dir: optimized_model_cache_dir,
+            _intra_op_thread_cores: intra_op_thread_cores,
+            _intra_op_thread_core_counts: intra_op_thread_core_counts,
+        })
+    }
+}
+
+impl From<InferenceEngineElementType> for inference_engine_core::ElementType {
+    fn from(element_type: InferenceEngineElementType) -> Self {
+        match element_type {
+            InferenceEngineElementType::Float32 => Self::Float32,
+            InferenceEngineElementType::Float16 => Self::Float16,
+            InferenceEngineElementType::Int8 => Self::Int8,
+            InferenceEngineElementType::Uint8 => Self::Uint8,
+            InferenceEngineElementType::Int16 => Self::Int16,
+            InferenceEngineElementType::Int32 => Self::Int32,
+            InferenceEngineElementType::Int64 => Self::Int64,
+            InferenceEngineElementType::Bool => Self::Bool,
+        }
+    }
+}
+
+impl From<InferenceEngineWarmupTiming> for inference_engine_core::WarmupTiming {
+    fn from(timing: InferenceEngineWarmupTiming) -> Self {
+        Self {
+            reshape: std::time::Duration::from_nanos(timing.reshape_ns),
+            first_run: std::time::Duration::from_nanos(timing.first_run_ns),
+            last_run: std::time::Duration::from_nanos(timing.last_run_ns),
+        }
+    }
+}
+
+impl From<InferenceEngineStats> for inference_engine_core::EngineStats {
+    fn from(stats: InferenceEngineStats) -> Self {
+        Self {
+            run_count: stats.run_count,
+            run_time_total: std::time::Duration::from_nanos(stats.run_total_ns),
+            run_time_min: std::time::Duration::from_nanos(stats.run_min_ns),
+            run_time_max: std::time::Duration::from_nanos(stats.run_max_ns),
+            run_time_p50: std::time::Duration::from_nanos(stats.run_p50_ns),
+            run_time_p99: std::time::Duration::from_nanos(stats.run_p99_ns),
+            reshape_count: stats.reshape_count,
+            reshape_time_total: std::time::Duration::from_nanos(stats.reshape_total_ns),
+            bytes_bound: stats.bytes_bound,
+        }
+    }
+}
+
 #[macro_export]
 macro_rules! impl_inference_engine {
     ($target:ty) => {
         mod r#impl {
             use super::*;
-            use inference_engine_core::{Error, InferenceEngine};
+            use inference_engine_core::{
+                Element, ElementType, EngineStats, Error, InferenceEngine, ProfileEvent,
+                ProfileTrace, RunCompletion, RunFuture, WarmupTiming,
+            };
             use inference_engine_core_sys as sys;
+            use std::ffi::{c_char, c_void, CStr};
             use std::ptr::null;
 
+            /// Shape counts up to which shapes are passed to the C ABI without allocating.
+            const MAX_STACK_SHAPE_COUNT: usize = 8;
+
+            fn check_element_type(expected: ElementType, found: ElementType) -> Result<(), Error> {
+                if expected == found {
+                    Ok(())
+                } else {
+                    Err(Error::ElementTypeMismatch { expected, found })
+                }
+            }
+
+            fn with_shape_pointers<R>(
+                shapes: &[&[usize]],
+                f: impl FnOnce(&[*const usize], &[usize]) -> R,
+            ) -> R {
+                if shapes.len() <= MAX_STACK_SHAPE_COUNT {
+                    let mut data = [null(); MAX_STACK_SHAPE_COUNT];
+                    let mut sizes = [0; MAX_STACK_SHAPE_COUNT];
+
+                    for (i, shape) in shapes.iter().enumerate() {
+                        data[i] = shape.as_ptr();
+                        sizes[i] = shape.len();
+                    }
+
+                    f(&data[..shapes.len()], &sizes[..shapes.len()])
+                } else {
+                    let data: Vec<_> = shapes.iter().map(|shape| shape.as_ptr()).collect();
+                    let sizes: Vec<_> = shapes.iter().map(|shape| shape.len()).collect();
+                    f(&data, &sizes)
+                }
+            }
+
+            unsafe fn get_input_shape<'a>(raw: *const c_void, index: usize) -> &'a [usize] {
+                let mut data = null();
+                let mut size = 0;
+                sys::inference_engine__get_input_shape(raw, index, &mut data, &mut size);
+                std::slice::from_raw_parts(data, size)
+            }
+
+            unsafe fn get_output_shape<'a>(raw: *const c_void, index: usize) -> &'a [usize] {
+                let mut data = null();
+                let mut size = 0;
+                sys::inference_engine__get_output_shape(raw, index, &mut data, &mut size);
+                std::slice::from_raw_parts(data, size)
+            }
+
+            // The element type of the tensor must have been checked to be Float32.
+            unsafe fn get_input_data<'a>(raw: *mut c_void, index: usize) -> &'a mut [f32] {
+                let data = sys::inference_engine__get_input_data(raw, index);
+                let size = get_input_shape(raw, index).iter().product();
+                std::slice::from_raw_parts_mut(data, size)
+            }
+
+            unsafe fn get_output_data<'a>(raw: *const c_void, index: usize) -> &'a [f32] {
+                let data = sys::inference_engine__get_output_data(raw, index);
+                let size = get_output_shape(raw, index).iter().product();
+                std::slice::from_raw_parts(data, size)
+            }
+
+            unsafe extern "C" fn on_run_async_completed(
+                user_data: *mut c_void,
+                result_code: sys::InferenceEngineResultCode,
+                error_message: *const c_char,
+            ) {
+                let completion = Box::from_raw(user_data as *mut RunCompletion);
+                completion.complete(match result_code {
+                    sys::InferenceEngineResultCode::Ok => Ok(()),
+                    sys::InferenceEngineResultCode::Error => Err(Error::SysError(
+                        CStr::from_ptr(error_message).to_string_lossy().into(),
+                    )),
+                });
+            }
+
             impl Drop for $target {
                 fn drop(&mut self) {
                     unsafe {
@@ -43,37 +254,19 @@ macro_rules! impl_inference_engine {
                 }
 
                 fn input_shape(&self, index: usize) -> &[usize] {
-                    unsafe {
-                        let mut data = null();
-                        let mut size = 0;
-                        sys::inference_engine__get_input_shape(
-                            self.raw, index, &mut data, &mut size,
-                        );
-                        std::slice::from_raw_parts(data, size)
-                    }
+                    unsafe { get_input_shape(self.raw, index) }
                 }
 
-                fn input_shapes(&self) -> Vec<&[usize]> {
-                    (0..self.input_count())
-                        .map(|i| self.input_shape(i))
-                        .collect()
+                fn input_shapes(&self) -> impl ExactSizeIterator<Item = &[usize]> {
+                    (0..self.input_count()).map(|i| self.input_shape(i))
                 }
 
                 fn output_shape(&self, index: usize) -> &[usize] {
-                    unsafe {
-                        let mut data = null();
-                        let mut size = 0;
-                        sys::inference_engine__get_output_shape(
-                            self.raw, index, &mut data, &mut size,
-                        );
-                        std::slice::from_raw_parts(data, size)
-                    }
+                    unsafe { get_output_shape(self.raw, index) }
                 }
 
-                fn output_shapes(&self) -> Vec<&[usize]> {
-                    (0..self.output_count())
-                        .map(|i| self.output_shape(i))
-                        .collect()
+                fn output_shapes(&self) -> impl ExactSizeIterator<Item = &[usize]> {
+                    (0..self.output_count()).map(|i| self.output_shape(i))
                 }
 
                 fn set_input_shape(&mut self, index: usize, shape: &[usize]) -> Result<(), Error> {
@@ -88,10 +281,14 @@ macro_rules! impl_inference_engine {
                 }
 
                 fn set_input_shapes(&mut self, shapes: &[&[usize]]) -> Result<(), Error> {
-                    shapes
-                        .iter()
-                        .enumerate()
-                        .try_for_each(|(i, shape)| self.set_input_shape(i, shape))
+                    with_shape_pointers(shapes, |data, sizes| unsafe {
+                        Result::from(sys::inference_engine__set_input_shapes(
+                            self.raw,
+                            data.as_ptr(),
+                            sizes.as_ptr(),
+                            shapes.len(),
+                        ))
+                    })
                 }
 
                 fn set_output_shape(&mut self, index: usize, shape: &[usize]) -> Result<(), Error> {
@@ -112,35 +309,51 @@ macro_rules! impl_inference_engine {
                         .try_for_each(|(i, shape)| self.set_output_shape(i, shape))
                 }
 
-                fn input_data(&mut self, index: usize) -> &mut [f32] {
-                    unsafe {
-                        let data = sys::inference_engine__get_input_data(self.raw, index);
-                        let size = self.input_shape(index).iter().product();
-                        std::slice::from_raw_parts_mut(data, size)
-                    }
+                fn input_data(&mut self, index: usize) -> Result<&mut [f32], Error> {
+                    check_element_type(ElementType::Float32, self.input_element_type(index))?;
+                    unsafe { Ok(get_input_data(self.raw, index)) }
                 }
 
-                fn input_data_all(&mut self) -> Vec<&mut [f32]> {
-                    (0..self.input_count())
-                        .map(|i| unsafe {
-                            let data = self.input_data(i);
-                            std::slice::from_raw_parts_mut(data.as_mut_ptr(), data.len())
-                        })
-                        .collect()
+                fn input_data_all(
+                    &mut self,
+                ) -> Result<impl ExactSizeIterator<Item = &mut [f32]>, Error> {
+                    (0..self.input_count()).try_for_each(|i| {
+                        check_element_type(ElementType::Float32, self.input_element_type(i))
+                    })?;
+
+                    let raw = self.raw;
+                    Ok((0..self.input_count()).map(move |i| unsafe { get_input_data(raw, i) }))
                 }
 
-                fn output_data(&self, index: usize) -> &[f32] {
-                    unsafe {
-                        let data = sys::inference_engine__get_output_data(self.raw, index);
-                        let size = self.output_shape(index).iter().product();
-                        std::slice::from_raw_parts(data, size)
+                fn output_data(&self, index: usize) -> Result<&[f32], Error> {
+                    check_element_type(ElementType::Float32, self.output_element_type(index))?;
+                    unsafe { Ok(get_output_data(self.raw, index)) }
+                }
+
+                fn output_data_all(&self) -> Result<impl ExactSizeIterator<Item = &[f32]>, Error> {
+                    (0..self.output_count()).try_for_each(|i| {
+                        check_element_type(ElementType::Float32, self.output_element_type(i))
+                    })?;
+
+                    Ok((0..self.output_count()).map(|i| unsafe { get_output_data(self.raw, i) }))
+                }
+
+                fn input_data_array<const N: usize>(&mut self) -> Result<[&mut [f32]; N], Error> {
+                    if self.input_count() != N {
+                        return Err(Error::SysError("input count mismatch".into()));
                     }
+
+                    let mut data = self.input_data_all()?;
+                    Ok(std::array::from_fn(|_| data.next().unwrap()))
                 }
 
-                fn output_data_all(&self) -> Vec<&[f32]> {
-                    (0..self.output_count())
-                        .map(|i| self.output_data(i))
-                        .collect()
+                fn output_data_array<const N: usize>(&self) -> Result<[&[f32]; N], Error> {
+                    if self.output_count() != N {
+                        return Err(Error::SysError("output count mismatch".into()));
+                    }
+
+                    let mut data = self.output_data_all()?;
+                    Ok(std::array::from_fn(|_| data.next().unwrap()))
                 }
 
                 fn set_input_data(&mut self, index: usize, data: &[f32]) -> Result<(), Error> {
@@ -175,9 +388,235 @@ macro_rules! impl_inference_engine {
                         .try_for_each(|(i, data)| self.set_output_data(i, data))
                 }
 
+                fn input_element_type(&self, index: usize) -> ElementType {
+                    unsafe { sys::inference_engine__get_input_element_type(self.raw, index).into() }
+                }
+
+                fn output_element_type(&self, index: usize) -> ElementType {
+                    unsafe {
+                        sys::inference_engine__get_output_element_type(self.raw, index).into()
+                    }
+                }
+
+                fn typed_input_data<T: Element>(
+                    &mut self,
+                    index: usize,
+                ) -> Result<&mut [T], Error> {
+                    check_element_type(T::ELEMENT_TYPE, self.input_element_type(index))?;
+
+                    unsafe {
+                        let data = sys::inference_engine__get_input_raw_data(self.raw, index);
+                        let size = self.input_shape(index).iter().product();
+                        Ok(std::slice::from_raw_parts_mut(data as _, size))
+                    }
+                }
+
+                fn typed_output_data<T: Element>(&self, index: usize) -> Result<&[T], Error> {
+                    check_element_type(T::ELEMENT_TYPE, self.output_element_type(index))?;
+
+                    unsafe {
+                        let data = sys::inference_engine__get_output_raw_data(self.raw, index);
+                        let size = self.output_shape(index).iter().product();
+                        Ok(std::slice::from_raw_parts(data as _, size))
+                    }
+                }
+
+                fn set_typed_input_data<T: Element>(
+                    &mut self,
+                    index: usize,
+                    data: &[T],
+                ) -> Result<(), Error> {
+                    check_element_type(T::ELEMENT_TYPE, self.input_element_type(index))?;
+
+                    unsafe {
+                        Result::from(sys::inference_engine__set_input_raw_data(
+                            self.raw,
+                            index,
+                            data.as_ptr() as _,
+                        ))
+                    }
+                }
+
+                fn set_typed_output_data<T: Element>(
+                    &mut self,
+                    index: usize,
+                    data: &mut [T],
+                ) -> Result<(), Error> {
+                    check_element_type(T::ELEMENT_TYPE, self.output_element_type(index))?;
+
+                    unsafe {
+                        Result::from(sys::inference_engine__set_output_raw_data(
+                            self.raw,
+                            index,
+                            data.as_mut_ptr() as _,
+                        ))
+                    }
+                }
+
+                unsafe fn register_buffer_set(
+                    &mut self,
+                    inputs: &[&[f32]],
+                    outputs: &mut [&mut [f32]],
+                ) -> Result<usize, Error> {
+                    let input_data: Vec<_> = inputs.iter().map(|data| data.as_ptr() as _).collect();
+                    let output_data: Vec<_> = outputs
+                        .iter_mut()
+                        .map(|data| data.as_mut_ptr() as _)
+                        .collect();
+                    let mut id = 0;
+
+                    unsafe {
+                        Result::from(sys::inference_engine__register_buffer_set(
+                            self.raw,
+                            input_data.as_ptr(),
+                            input_data.len(),
+                            output_data.as_ptr(),
+                            output_data.len(),
+                            &mut id,
+                        ))?;
+                    }
+
+                    Ok(id)
+                }
+
+                fn select_buffer_set(&mut self, id: usize) -> Result<(), Error> {
+                    unsafe { Result::from(sys::inference_engine__select_buffer_set(self.raw, id)) }
+                }
+
+                fn unregister_buffer_set(&mut self, id: usize) -> Result<(), Error> {
+                    unsafe {
+                        Result::from(sys::inference_engine__unregister_buffer_set(self.raw, id))
+                    }
+                }
+
+                fn warmup(
+                    &mut self,
+                    shape_sets: &[&[&[usize]]],
+                    iterations: usize,
+                ) -> Result<Vec<WarmupTiming>, Error> {
+                    let input_count = self.input_count();
+
+                    if shape_sets.iter().any(|shapes| shapes.len() != input_count) {
+                        return Err(Error::SysError("input shape count mismatch".into()));
+                    }
+
+                    let shapes = shape_sets.iter().flat_map(|shapes| shapes.iter());
+                    let data: Vec<_> = shapes.clone().map(|shape| shape.as_ptr()).collect();
+                    let sizes: Vec<_> = shapes.map(|shape| shape.len()).collect();
+                    let mut timings = vec![
+                        sys::InferenceEngineWarmupTiming {
+                            reshape_ns: 0,
+                            first_run_ns: 0,
+                            last_run_ns: 0,
+                        };
+                        shape_sets.len()
+                    ];
+
+                    unsafe {
+                        Result::from(sys::inference_engine__warmup(
+                            self.raw,
+                            data.as_ptr(),
+                            sizes.as_ptr(),
+                            shape_sets.len(),
+                            iterations,
+                            timings.as_mut_ptr(),
+                        ))?;
+                    }
+
+                    Ok(timings.into_iter().map(WarmupTiming::from).collect())
+                }
+
+                fn stats(&self) -> Result<EngineStats, Error> {
+                    let mut stats = sys::InferenceEngineStats {
+                        run_count: 0,
+                        run_total_ns: 0,
+                        run_min_ns: 0,
+                        run_max_ns: 0,
+                        run_p50_ns: 0,
+                        run_p99_ns: 0,
+                        reshape_count: 0,
+                        reshape_total_ns: 0,
+                        bytes_bound: 0,
+                    };
+
+                    unsafe {
+                        Result::from(sys::inference_engine__get_stats(self.raw, &mut stats))?;
+                    }
+
+                    Ok(stats.into())
+                }
+
+                fn reset_stats(&mut self) -> Result<(), Error> {
+                    unsafe { Result::from(sys::inference_engine__reset_stats(self.raw)) }
+                }
+
+                fn start_profiling(&mut self) -> Result<(), Error> {
+                    unsafe { Result::from(sys::inference_engine__start_profiling(self.raw)) }
+                }
+
+                fn stop_profiling(&mut self) -> Result<ProfileTrace, Error> {
+                    unsafe {
+                        let mut trace = std::ptr::null_mut();
+                        Result::from(sys::inference_engine__stop_profiling(self.raw, &mut trace))?;
+
+                        let mut engine = null();
+                        let mut model = null();
+                        sys::inference_engine__get_profile_trace_labels(
+                            trace,
+                            &mut engine,
+                            &mut model,
+                        );
+
+                        let events = (0..sys::inference_engine__get_profile_event_count(trace))
+                            .map(|i| {
+                                let mut event = sys::InferenceEngineProfileEvent {
+                                    name: null(),
+                                    op_type: null(),
+                                    start_us: 0,
+                                    duration_us: 0,
+                                };
+                                sys::inference_engine__get_profile_event(trace, i, &mut event);
+
+                                ProfileEvent {
+                                    name: CStr::from_ptr(event.name).to_string_lossy().into(),
+                                    op_type: CStr::from_ptr(event.op_type).to_string_lossy().into(),
+                                    start: std::time::Duration::from_micros(event.start_us),
+                                    duration: std::time::Duration::from_micros(event.duration_us),
+                                }
+                            })
+                            .collect();
+
+                        let profile_trace = ProfileTrace {
+                            engine: CStr::from_ptr(engine).to_string_lossy().into(),
+                            model: CStr::from_ptr(model).to_string_lossy().into(),
+                            events,
+                        };
+                        sys::inference_engine__destroy_profile_trace(trace);
+
+                        Ok(profile_trace)
+                    }
+                }
+
                 fn run(&mut self) -> Result<(), Error> {
                     unsafe { Result::from(sys::inference_engine__run(self.raw)) }
                 }
+
+                unsafe fn run_async(&mut self) -> RunFuture<'_> {
+                    let (future, completion) = RunFuture::new();
+                    let user_data = Box::into_raw(Box::new(completion));
+
+                    unsafe {
+                        if let Err(e) = Result::from(sys::inference_engine__run_async(
+                            self.raw,
+                            Some(on_run_async_completed),
+                            user_data as _,
+                        )) {
+                            Box::from_raw(user_data).complete(Err(e));
+                        }
+                    }
+
+                    future
+                }
             }
         }
     };
@@ -1,7 +1,9 @@
 #pragma once
 
+#include "inference_engine/EngineOptions.hpp"
 #include "inference_engine/InferenceEngine.hpp"
 
+#include <filesystem>
 #include <memory>
 #include <vector>
 
@@ -10,7 +12,8 @@ namespace inference_engine
 class OrtInferenceEngine : public InferenceEngine
 {
 public:
-    OrtInferenceEngine(const void *model_data, size_t model_data_size_bytes);
+    OrtInferenceEngine(const void *model_data, size_t model_data_size_bytes, const EngineOptions &options = {});
+    OrtInferenceEngine(const std::filesystem::path &model_path, const EngineOptions &options = {});
 
     size_t get_input_count() const override;
     size_t get_output_count() const override;
@@ -18,19 +21,52 @@ public:
     const std::vector<size_t> &get_input_shape(size_t index) const override;
     const std::vector<size_t> &get_output_shape(size_t index) const override;
 
-    void set_input_shape(size_t index, const std::vector<size_t> &shape) override;
-    void set_output_shape(size_t index, const std::vector<size_t> &shape) override;
+    using InferenceEngine::set_input_shape;
+    using InferenceEngine::set_input_shapes;
+    using InferenceEngine::set_output_shape;
+    void set_input_shape(size_t index, Span<const size_t> shape) override;
+    void set_input_shapes(Span<const Span<const size_t>> shapes) override;
+    void set_output_shape(size_t index, Span<const size_t> shape) override;
 
-    float *get_input_data(size_t index) override;
-    const float *get_output_data(size_t index) const override;
+    ElementType get_input_element_type(size_t index) const override;
+    ElementType get_output_element_type(size_t index) const override;
 
-    void set_input_data(size_t index, const float *data) override;
-    void set_output_data(size_t index, float *data) override;
+    void *get_input_raw_data(size_t index) override;
+    const void *get_output_raw_data(size_t index) const override;
+
+    void set_input_raw_data(size_t index, const void *data) override;
+    void set_output_raw_data(size_t index, void *data) override;
+
+    size_t register_buffer_set(const std::vector<const void *> &inputs, const std::vector<void *> &outputs) override;
+    void select_buffer_set(size_t id) override;
+    void unregister_buffer_set(size_t id) override;
+    size_t get_buffer_set_count() const override;
+    size_t get_memory_footprint() const override;
+
+    std::vector<WarmupTiming> warmup(const std::vector<std::vector<std::vector<size_t>>> &shape_sets, size_t iterations) override;
+
+    EngineStats get_stats() const override;
+    void reset_stats() override;
+
+    void start_profiling() override;
+    ProfileTrace stop_profiling() override;
 
     void run() override;
 
+    using InferenceEngine::run_async;
+    void run_async(RunCallback callback) override;
+
 private:
+    friend class OrtEnginePool;
+
+    class Model;
     class Impl;
+
+    explicit OrtInferenceEngine(std::shared_ptr<Model> model);
+
+    static std::shared_ptr<Model> load_model(const void *model_data, size_t model_data_size_bytes, const EngineOptions &options);
+    static std::shared_ptr<Model> load_model(const std::filesystem::path &model_path, const EngineOptions &options);
+
     std::shared_ptr<Impl> impl;
 };
 } // namespace inference_engine
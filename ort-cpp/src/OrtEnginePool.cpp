@@ -0,0 +1,21 @@
+#include "inference_engine/OrtEnginePool.hpp"
+
+namespace inference_engine
+{
+OrtEnginePool::OrtEnginePool(const void *model_data, size_t model_data_size_bytes, const EngineOptions &options, size_t capacity)
+    : EnginePool(capacity)
+    , model(OrtInferenceEngine::load_model(model_data, model_data_size_bytes, options))
+{
+}
+
+OrtEnginePool::OrtEnginePool(const std::filesystem::path &model_path, const EngineOptions &options, size_t capacity)
+    : EnginePool(capacity)
+    , model(OrtInferenceEngine::load_model(model_path, options))
+{
+}
+
+std::unique_ptr<InferenceEngine> OrtEnginePool::create_engine()
+{
+    return std::unique_ptr<InferenceEngine>(new OrtInferenceEngine(model));
+}
+} // namespace inference_engine
@@ -1,6 +1,27 @@
 #include "inference_engine/OrtInferenceEngine.hpp"
 
+#include "inference_engine/BufferArena.hpp"
+#include "inference_engine/CpuPlacement.hpp"
+#include "inference_engine/EngineStats.hpp"
+#include "inference_engine/MappedFile.hpp"
+#include "inference_engine/Worker.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <mutex>
 #include <onnxruntime_cxx_api.h>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
 namespace inference_engine
@@ -18,10 +39,14 @@ public:
         element_count = count_elements(values);
     }
 
-    Shape &operator=(const std::vector<size_t> &values)
+    Shape &operator=(Span<const size_t> values)
     {
-        this->values = values;
-        element_count = count_elements(values);
+        if (values.data() != this->values.data())
+        {
+            this->values.assign(values.begin(), values.end());
+        }
+
+        element_count = count_elements(this->values);
         return *this;
     }
 
@@ -73,234 +98,1624 @@ private:
     }
 };
 
-class OrtInferenceEngine::Impl
+ElementType to_element_type(ONNXTensorElementDataType type)
+{
+    switch (type)
+    {
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT:
+        return ElementType::Float32;
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16:
+        return ElementType::Float16;
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT8:
+        return ElementType::Int8;
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT8:
+        return ElementType::Uint8;
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT16:
+        return ElementType::Int16;
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT32:
+        return ElementType::Int32;
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT64:
+        return ElementType::Int64;
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_BOOL:
+        return ElementType::Bool;
+    default:
+        throw std::runtime_error("unsupported tensor element type");
+    }
+}
+
+// Unique within the process and, through the clock, unlikely to repeat across processes.
+std::string get_unique_id()
+{
+    static std::atomic<size_t> count{0};
+    return std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()) + "_" + std::to_string(count++);
+}
+
+// FNV-1a over 64-bit words, folding high bits down after each step, so that large models are keyed quickly.
+uint64_t hash_bytes(const void *data, size_t size, uint64_t hash = 14695981039346656037ull)
+{
+    auto bytes = static_cast<const unsigned char *>(data);
+    size_t i = 0;
+
+    for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t))
+    {
+        uint64_t word;
+        std::memcpy(&word, bytes + i, sizeof(word));
+        hash = (hash ^ word) * 1099511628211ull;
+        hash ^= hash >> 32;
+    }
+
+    for (; i < size; i++)
+    {
+        hash = (hash ^ bytes[i]) * 1099511628211ull;
+    }
+
+    return hash;
+}
+
+// ORT-format models are flatbuffers with the "ORTM" file identifier.
+bool is_ort_format(const void *model_data, size_t model_data_size_bytes)
+{
+    return model_data_size_bytes >= 8 && std::memcmp(static_cast<const char *>(model_data) + 4, "ORTM", 4) == 0;
+}
+
+GraphOptimizationLevel to_graph_optimization_level(OptimizationLevel level)
+{
+    switch (level)
+    {
+    case OptimizationLevel::Disabled:
+        return ORT_DISABLE_ALL;
+    case OptimizationLevel::Basic:
+        return ORT_ENABLE_BASIC;
+    case OptimizationLevel::Extended:
+        return ORT_ENABLE_EXTENDED;
+    default:
+        return ORT_ENABLE_ALL;
+    }
+}
+
+// ORT numbers cores from 1 and separates the core sets of its threads with semicolons, such as "1,2;3,4".
+std::string to_thread_affinity_string(const EngineOptions &options)
+{
+    if (options.intra_op_thread_affinities.size() + 1 != options.intra_op_num_threads)
+    {
+        throw std::runtime_error("intra-op thread affinity count must be one less than the number of intra-op threads");
+    }
+
+    std::string affinities;
+
+    for (auto i = 0; i < options.intra_op_thread_affinities.size(); i++)
+    {
+        const auto &cores = options.intra_op_thread_affinities[i];
+
+        if (cores.empty())
+        {
+            throw std::runtime_error("intra-op thread affinity has no cores");
+        }
+
+        affinities += i > 0 ? ";" : "";
+
+        for (auto j = 0; j < cores.size(); j++)
+        {
+            affinities += (j > 0 ? "," : "") + std::to_string(cores[j] + 1);
+        }
+    }
+
+    return affinities;
+}
+
+// Fields of one event of an ORT profile, as raw text with strings unescaped. Fields of nested objects are prefixed
+// with the name of the object, as in "args.op_name".
+using OrtProfileRecord = std::unordered_map<std::string, std::string>;
+
+// Reads the JSON array of events that ORT writes when a session stops profiling.
+class OrtProfileParser
 {
 public:
-    Impl(const void *model_data, size_t model_data_size_bytes)
-        : env()
-        , session(
-              env,
-              model_data,
-              model_data_size_bytes,
-              static_cast<Ort::SessionOptions &>(
-                  Ort::SessionOptions().SetIntraOpNumThreads(1)
-              )
-          )
-        , io_binding(session)
-        , allocator()
-        , memory_info(Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeCPU))
-        , run_options(nullptr)
-        , input_count(session.GetInputCount())
-        , output_count(session.GetOutputCount())
+    explicit OrtProfileParser(const std::filesystem::path &file_path)
     {
-        for (auto i = 0; i < input_count; i++)
+        std::ifstream ifs(file_path, std::ios::binary);
+
+        if (!ifs)
         {
-            input_names.push_back(session.GetInputNameAllocated(i, allocator));
-            input_shapes.push_back(session.GetInputTypeInfo(i).GetTensorTypeAndShapeInfo().GetShape());
-            input_values.push_back(Ort::Value::CreateTensor<float>(
-                allocator,
-                reinterpret_cast<const int64_t *>(input_shapes[i].data()),
-                input_shapes[i].size()
-            ));
-            io_binding.BindInput(input_names[i].get(), input_values[i]);
+            throw std::runtime_error("failed to open file: " + file_path.string());
         }
 
-        for (auto i = 0; i < output_count; i++)
+        text.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+    }
+
+    std::vector<OrtProfileRecord> parse()
+    {
+        std::vector<OrtProfileRecord> records;
+        expect('[');
+
+        if (consume(']'))
         {
-            output_names.push_back(session.GetOutputNameAllocated(i, allocator));
-            output_shapes.push_back(session.GetOutputTypeInfo(i).GetTensorTypeAndShapeInfo().GetShape());
-            output_values.push_back(Ort::Value::CreateTensor<float>(
-                allocator,
-                reinterpret_cast<const int64_t *>(output_shapes[i].data()),
-                output_shapes[i].size()
-            ));
-            io_binding.BindOutput(output_names[i].get(), output_values[i]);
+            return records;
         }
+
+        do
+        {
+            records.emplace_back();
+            parse_object(records.back(), "");
+        } while (consume(','));
+
+        expect(']');
+        return records;
     }
 
-    size_t get_input_count() const
+private:
+    void parse_object(OrtProfileRecord &record, const std::string &prefix)
     {
-        return input_count;
+        expect('{');
+
+        if (consume('}'))
+        {
+            return;
+        }
+
+        do
+        {
+            auto key = prefix + parse_string();
+            expect(':');
+            parse_value(record, key);
+        } while (consume(','));
+
+        expect('}');
     }
 
-    size_t get_output_count() const
+    void parse_value(OrtProfileRecord &record, const std::string &key)
     {
-        return output_count;
+        skip_space();
+
+        if (pos < text.size() && text[pos] == '{')
+        {
+            parse_object(record, key + ".");
+        }
+        else if (pos < text.size() && text[pos] == '[')
+        {
+            skip_array();
+        }
+        else if (pos < text.size() && text[pos] == '"')
+        {
+            record[key] = parse_string();
+        }
+        else
+        {
+            auto start = pos;
+
+            while (pos < text.size() && std::strchr(",]} \t\r\n", text[pos]) == nullptr)
+            {
+                pos++;
+            }
+
+            record[key] = text.substr(start, pos - start);
+        }
     }
 
-    const std::vector<size_t> &get_input_shape(size_t index) const
+    void skip_array()
     {
-        return input_shapes[index];
+        OrtProfileRecord ignored;
+        expect('[');
+
+        if (consume(']'))
+        {
+            return;
+        }
+
+        do
+        {
+            parse_value(ignored, "");
+        } while (consume(','));
+
+        expect(']');
     }
 
-    const std::vector<size_t> &get_output_shape(size_t index) const
+    std::string parse_string()
     {
-        return output_shapes[index];
+        expect('"');
+        std::string value;
+
+        while (pos < text.size() && text[pos] != '"')
+        {
+            auto c = text[pos++];
+
+            if (c == '\\' && pos < text.size())
+            {
+                c = text[pos++];
+
+                if (c == 'n')
+                {
+                    c = '\n';
+                }
+                else if (c == 't')
+                {
+                    c = '\t';
+                }
+                else if (c == 'u')
+                {
+                    // Node names are ASCII in practice, so other code points are not decoded.
+                    auto code = pos + 4 <= text.size() ? std::stoul(text.substr(pos, 4), nullptr, 16) : 0;
+                    c = code < 0x80 ? static_cast<char>(code) : '?';
+                    pos += 4;
+                }
+            }
+
+            value += c;
+        }
+
+        expect('"');
+        return value;
     }
 
-    void set_input_shape(size_t index, const std::vector<size_t> &shape)
+    void skip_space()
     {
-        input_shapes[index] = shape;
-        input_values[index] = Ort::Value::CreateTensor<float>(
-            allocator,
-            reinterpret_cast<const int64_t *>(input_shapes[index].data()),
-            input_shapes[index].size()
-        );
-        io_binding.BindInput(input_names[index].get(), input_values[index]);
+        while (pos < text.size() && std::isspace(static_cast<unsigned char>(text[pos])))
+        {
+            pos++;
+        }
     }
 
-    void set_output_shape(size_t index, const std::vector<size_t> &shape)
+    bool consume(char c)
+    {
+        skip_space();
+
+        if (pos < text.size() && text[pos] == c)
+        {
+            pos++;
+            return true;
+        }
+
+        return false;
+    }
+
+    void expect(char c)
+    {
+        if (!consume(c))
+        {
+            throw std::runtime_error("failed to parse the ORT profile");
+        }
+    }
+
+    std::string text;
+    size_t pos = 0;
+};
+
+// Reads the first outputs of the nodes of the main graph of an ONNX model from its protobuf encoding, in the order
+// ORT indexes the nodes.
+class OnnxGraphReader
+{
+public:
+    OnnxGraphReader(const void *data, size_t size)
+        : data(static_cast<const uint8_t *>(data))
+        , size(size)
     {
-        output_shapes[index] = shape;
-        output_values[index] = Ort::Value::CreateTensor<float>(
-            allocator,
-            reinterpret_cast<const int64_t *>(output_shapes[index].data()),
-            output_shapes[index].size()
-        );
-        io_binding.BindOutput(output_names[index].get(), output_values[index]);
     }
 
-    float *get_input_data(size_t index)
+    std::vector<std::string> read_node_outputs()
     {
-        return input_values[index].GetTensorMutableData<float>();
+        std::vector<std::string> outputs;
+
+        for_each_field(0, size, [&](uint64_t field, size_t begin, size_t end) {
+            if (field == model_graph_field)
+            {
+                for_each_field(begin, end, [&](uint64_t field, size_t begin, size_t end) {
+                    if (field == graph_node_field)
+                    {
+                        outputs.push_back(read_node_output(begin, end));
+                    }
+                });
+            }
+        });
+
+        return outputs;
     }
 
-    const float *get_output_data(size_t index) const
+private:
+    static constexpr uint64_t model_graph_field = 7;
+    static constexpr uint64_t graph_node_field = 1;
+    static constexpr uint64_t node_output_field = 2;
+
+    std::string read_node_output(size_t begin, size_t end)
     {
-        return output_values[index].GetTensorData<float>();
+        std::string output;
+        bool has_output = false;
+
+        for_each_field(begin, end, [&](uint64_t field, size_t begin, size_t end) {
+            if (field == node_output_field && !has_output)
+            {
+                output.assign(reinterpret_cast<const char *>(data + begin), end - begin);
+                has_output = true;
+            }
+        });
+
+        return output;
     }
 
-    void set_input_data(size_t index, const float *data)
+    // Calls the callback with the number and the bounds of every length-delimited field, skipping the others.
+    template <typename Callback>
+    void for_each_field(size_t begin, size_t end, Callback callback)
     {
-        if (data)
+        pos = begin;
+
+        while (pos < end)
         {
-            input_values[index] = Ort::Value::CreateTensor<float>(
-                memory_info,
-                const_cast<float *>(data),
-                input_shapes[index].get_element_count(),
-                reinterpret_cast<const int64_t *>(input_shapes[index].data()),
-                input_shapes[index].size()
-            );
+            auto key = read_varint(end);
+            auto wire_type = key & 7;
+
+            if (wire_type == 0)
+            {
+                read_varint(end);
+            }
+            else if (wire_type == 1 || wire_type == 5)
+            {
+                skip(wire_type == 1 ? 8 : 4, end);
+            }
+            else if (wire_type == 2)
+            {
+                auto length = read_varint(end);
+                auto field_begin = pos;
+                skip(length, end);
+                callback(key >> 3, field_begin, pos);
+                pos = field_begin + length;
+            }
+            else
+            {
+                throw std::runtime_error("failed to parse the ONNX model");
+            }
         }
-        else
+    }
+
+    uint64_t read_varint(size_t end)
+    {
+        uint64_t value = 0;
+
+        for (auto shift = 0; shift < 64; shift += 7)
         {
-            input_values[index] = Ort::Value::CreateTensor<float>(
-                allocator,
-                reinterpret_cast<const int64_t *>(input_shapes[index].data()),
-                input_shapes[index].size()
-            );
+            if (pos >= end)
+            {
+                break;
+            }
+
+            auto byte = data[pos++];
+            value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+
+            if (!(byte & 0x80))
+            {
+                return value;
+            }
         }
 
-        io_binding.BindInput(input_names[index].get(), input_values[index]);
+        throw std::runtime_error("failed to parse the ONNX model");
     }
 
-    void set_output_data(size_t index, float *data)
+    void skip(uint64_t length, size_t end)
     {
-        if (data)
+        if (length > end - pos)
         {
-            output_values[index] = Ort::Value::CreateTensor<float>(
-                memory_info,
-                data,
-                output_shapes[index].get_element_count(),
-                reinterpret_cast<const int64_t *>(output_shapes[index].data()),
-                output_shapes[index].size()
-            );
+            throw std::runtime_error("failed to parse the ONNX model");
         }
-        else
+
+        pos += length;
+    }
+
+    const uint8_t *data;
+    size_t size;
+    size_t pos = 0;
+};
+
+class SharedEnv
+{
+public:
+    static std::shared_ptr<Ort::Env> acquire(const EngineOptions &options)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        auto env = weak_env.lock();
+
+        if (!env)
         {
-            output_values[index] = Ort::Value::CreateTensor<float>(
-                allocator,
-                reinterpret_cast<const int64_t *>(output_shapes[index].data()),
-                output_shapes[index].size()
-            );
+            if (options.use_global_thread_pool)
+            {
+                Ort::ThreadingOptions threading_options;
+                threading_options.SetGlobalIntraOpNumThreads(static_cast<int>(options.intra_op_num_threads));
+                threading_options.SetGlobalInterOpNumThreads(static_cast<int>(options.inter_op_num_threads));
+                threading_options.SetGlobalSpinControl(options.allow_spinning);
+
+                if (!options.intra_op_thread_affinities.empty())
+                {
+                    Ort::ThrowOnError(Ort::GetApi().SetGlobalIntraOpThreadAffinity(threading_options, to_thread_affinity_string(options).c_str()));
+                }
+
+                env = std::make_shared<Ort::Env>(threading_options);
+            }
+            else
+            {
+                env = std::make_shared<Ort::Env>();
+            }
+
+            weak_env = env;
+            has_global_thread_pool = options.use_global_thread_pool;
+            global_intra_op_num_threads = options.intra_op_num_threads;
+        }
+        else if (options.use_global_thread_pool && !has_global_thread_pool)
+        {
+            throw std::runtime_error("the shared environment was created without a global thread pool");
         }
 
-        io_binding.BindOutput(output_names[index].get(), output_values[index]);
+        return env;
     }
 
-    void run()
+    // Intra-op threads of the global thread pool, as requested by the engine that created the environment.
+    static size_t get_global_intra_op_num_threads()
     {
-        session.Run(run_options, io_binding);
+        std::lock_guard<std::mutex> lock(mutex);
+        return global_intra_op_num_threads;
     }
 
 private:
-    Ort::Env env;
+    static inline std::mutex mutex;
+    static inline std::weak_ptr<Ort::Env> weak_env;
+    static inline bool has_global_thread_pool = false;
+    static inline size_t global_intra_op_num_threads = 0;
+};
+
+class OrtInferenceEngine::Model
+{
+public:
+    Model(const void *model_data, size_t model_data_size_bytes, const EngineOptions &options)
+        : Model(nullptr, model_data, model_data_size_bytes, options)
+    {
+    }
+
+    Model(const std::filesystem::path &model_path, const EngineOptions &options)
+        : Model(std::make_shared<MappedFile>(model_path), options)
+    {
+        name = model_path.filename().string();
+    }
+
+    Model(std::shared_ptr<const MappedFile> mapped_file, const EngineOptions &options)
+        : Model(mapped_file, mapped_file->data(), mapped_file->size(), options)
+    {
+    }
+
+    Model(std::shared_ptr<const MappedFile> mapped_file, const void *model_data, size_t model_data_size_bytes, const EngineOptions &options)
+        : mapped_file(mapped_file)
+        , env(SharedEnv::acquire(options))
+        , session(create_session(*env, this->mapped_file, model_data, model_data_size_bytes, options))
+        , allocator()
+        , input_count(session.GetInputCount())
+        , output_count(session.GetOutputCount())
+        , supports_run_async(get_intra_op_num_threads(options) > 1)
+        , enable_stats(options.enable_stats)
+        , enable_profiling(options.enable_profiling)
+        , numa_node(options.numa_node)
+        , options(options)
+    {
+        // Moves the pages read in before the session was created, such as by other engines of the model.
+        if (numa_node >= 0 && this->mapped_file)
+        {
+            bind_to_numa_node(this->mapped_file->data(), this->mapped_file->size(), numa_node);
+        }
+
+        data_size = this->mapped_file ? this->mapped_file->size() : model_data_size_bytes;
+
+        // Profiling sessions are created from the model data later on, which callers need not keep.
+        if (enable_profiling && !this->mapped_file)
+        {
+            auto bytes = static_cast<const uint8_t *>(model_data);
+            model_bytes.assign(bytes, bytes + model_data_size_bytes);
+        }
+
+        if (enable_profiling && !is_ort_format(model_data, model_data_size_bytes))
+        {
+            try
+            {
+                node_outputs = OnnxGraphReader(model_data, model_data_size_bytes).read_node_outputs();
+            }
+            catch (const std::exception &)
+            {
+                // Profile events keep the names ORT gives them.
+            }
+        }
+
+        for (auto i = 0; i < input_count; i++)
+        {
+            auto tensor_info = session.GetInputTypeInfo(i).GetTensorTypeAndShapeInfo();
+            input_names.push_back(session.GetInputNameAllocated(i, allocator));
+            input_shapes.push_back(tensor_info.GetShape());
+            input_types.push_back(tensor_info.GetElementType());
+        }
+
+        for (auto i = 0; i < output_count; i++)
+        {
+            auto tensor_info = session.GetOutputTypeInfo(i).GetTensorTypeAndShapeInfo();
+            output_names.push_back(session.GetOutputNameAllocated(i, allocator));
+            output_shapes.push_back(tensor_info.GetShape());
+            output_types.push_back(tensor_info.GetElementType());
+        }
+    }
+
+    std::shared_ptr<const MappedFile> mapped_file;
+    std::shared_ptr<Ort::Env> env;
     Ort::Session session;
-    Ort::IoBinding io_binding;
     Ort::AllocatorWithDefaultOptions allocator;
-    Ort::MemoryInfo memory_info;
-    Ort::RunOptions run_options;
 
     const size_t input_count;
     const size_t output_count;
 
+    // ORT runs asynchronous sessions on the intra-op thread pool, which needs at least two threads.
+    const bool supports_run_async;
+    const bool enable_stats;
+    const bool enable_profiling;
+    const int numa_node;
+
+    const EngineOptions options;
+
+    // Size of the data the session was created from, which is the optimized copy for cached models.
+    size_t data_size;
+
+    // File name of the model, empty when created from memory.
+    std::string name;
+
     std::vector<Ort::AllocatedStringPtr> input_names;
     std::vector<Ort::AllocatedStringPtr> output_names;
 
     std::vector<Shape> input_shapes;
     std::vector<Shape> output_shapes;
 
-    std::vector<Ort::Value> input_values;
-    std::vector<Ort::Value> output_values;
-};
+    std::vector<ONNXTensorElementDataType> input_types;
+    std::vector<ONNXTensorElementDataType> output_types;
 
-OrtInferenceEngine::OrtInferenceEngine(const void *model_data, size_t model_data_size_bytes)
-    : impl(new Impl(model_data, model_data_size_bytes))
-{
-}
+    // First outputs of the nodes of the ONNX model by ORT node index, only read when profiling is enabled.
+    std::vector<std::string> node_outputs;
 
-size_t OrtInferenceEngine::get_input_count() const
-{
-    return impl->get_input_count();
-}
+    // ORT profiles a session from its creation until it ends the profiler, which it cannot restart and which stops
+    // recording at a million events, so that every profiling of an engine gets a session of its own. Creating it
+    // from the optimized copy of a cached model skips the optimization.
+    Ort::Session create_profiling_session() const
+    {
+        NumaNodeScope numa_scope(numa_node);
 
-size_t OrtInferenceEngine::get_output_count() const
-{
-    return impl->get_output_count();
-}
+        auto session_options = create_session_options(options, true);
+        session_options.EnableProfiling(get_profile_file_prefix().c_str());
 
-const std::vector<size_t> &OrtInferenceEngine::get_input_shape(size_t index) const
-{
-    return impl->get_input_shape(index);
-}
+        if (mapped_file)
+        {
+            return Ort::Session(*env, mapped_file->data(), mapped_file->size(), session_options);
+        }
+
+        return Ort::Session(*env, model_bytes.data(), model_bytes.size(), session_options);
+    }
+
+private:
+    // Copy of the model data for profiling sessions when there is no mapped file.
+    std::vector<uint8_t> model_bytes;
+
+    // Loads the optimized copy of the model from the cache, or optimizes the model and adds the copy to the cache.
+    // The mapped file is replaced by the one of the cached copy, which the session keeps reading from.
+    static Ort::Session create_session(Ort::Env &env, std::shared_ptr<const MappedFile> &mapped_file, const void *model_data, size_t model_data_size_bytes, const EngineOptions &options)
+    {
+        NumaNodeScope numa_scope(options.numa_node);
+
+        // ORT-format models are already optimized, so there is nothing to cache.
+        if (options.optimized_model_cache_dir.empty() || is_ort_format(model_data, model_data_size_bytes))
+        {
+            return Ort::Session(env, model_data, model_data_size_bytes, create_session_options(options, mapped_file != nullptr));
+        }
+
+        auto cache_path = options.optimized_model_cache_dir / get_cache_key(model_data, model_data_size_bytes, options);
+        std::error_code error;
+
+        if (std::filesystem::exists(cache_path, error))
+        {
+            try
+            {
+                auto cached_file = std::make_shared<MappedFile>(cache_path);
+                auto session = Ort::Session(env, cached_file->data(), cached_file->size(), create_session_options(options, true));
+                mapped_file = cached_file;
+                return session;
+            }
+            catch (const std::exception &)
+            {
+                // A copy that cannot be loaded is replaced below.
+            }
+        }
+
+        // The copy is written under a unique name and renamed into place, so that other processes never load it
+        // partially written.
+        auto temp_path = cache_path;
+        temp_path += "." + get_unique_id() + ".tmp";
+
+        // The cache only saves time, so that a directory that cannot be written leaves the model uncached. Creating
+        // the copy up front tells so before the model is optimized.
+        std::filesystem::create_directories(options.optimized_model_cache_dir, error);
+
+        if (error || !std::ofstream(temp_path))
+        {
+            return Ort::Session(env, model_data, model_data_size_bytes, create_session_options(options, mapped_file != nullptr));
+        }
+
+        auto session_options = create_session_options(options, mapped_file != nullptr);
+        session_options.SetOptimizedModelFilePath(temp_path.c_str());
+        session_options.AddConfigEntry("session.save_model_format", "ORT");
+
+        try
+        {
+            auto session = Ort::Session(env, model_data, model_data_size_bytes, session_options);
+            std::filesystem::rename(temp_path, cache_path, error);
+
+            if (error)
+            {
+                std::filesystem::remove(temp_path, error);
+            }
+
+            return session;
+        }
+        catch (...)
+        {
+            std::filesystem::remove(temp_path, error);
+            throw;
+        }
+    }
+
+    static std::string get_cache_key(const void *model_data, size_t model_data_size_bytes, const EngineOptions &options)
+    {
+        auto version = Ort::GetVersionString();
+        auto level = static_cast<int>(options.optimization_level);
+
+        auto hash = hash_bytes(version.data(), version.size());
+        hash = hash_bytes(&level, sizeof(level), hash);
+        hash = hash_bytes(&model_data_size_bytes, sizeof(model_data_size_bytes), hash);
+        hash = hash_bytes(model_data, model_data_size_bytes, hash);
+
+        char key[21];
+        std::snprintf(key, sizeof(key), "%016llx.ort", static_cast<unsigned long long>(hash));
+        return key;
+    }
+
+    // Sessions on the global thread pool run on the pool the environment was created with, whatever their options ask.
+    static size_t get_intra_op_num_threads(const EngineOptions &options)
+    {
+        auto num_threads = options.use_global_thread_pool ? SharedEnv::get_global_intra_op_num_threads() : options.intra_op_num_threads;
+        return num_threads > 0 ? num_threads : std::thread::hardware_concurrency();
+    }
+
+    static Ort::SessionOptions create_session_options(const EngineOptions &options, bool is_model_data_persistent)
+    {
+        Ort::SessionOptions session_options;
+
+        if (is_model_data_persistent)
+        {
+            session_options.AddConfigEntry("session.use_ort_model_bytes_directly", "1");
+            session_options.AddConfigEntry("session.use_ort_model_bytes_for_initializers", "1");
+        }
+
+        if (options.use_global_thread_pool)
+        {
+            session_options.DisablePerSessionThreads();
+        }
+        else
+        {
+            session_options.SetIntraOpNumThreads(static_cast<int>(options.intra_op_num_threads));
+            session_options.SetInterOpNumThreads(static_cast<int>(options.inter_op_num_threads));
+
+            if (!options.intra_op_thread_affinities.empty())
+            {
+                session_options.AddConfigEntry("session.intra_op_thread_affinities", to_thread_affinity_string(options).c_str());
+            }
+        }
+
+        session_options.AddConfigEntry("session.intra_op.allow_spinning", options.allow_spinning ? "1" : "0");
+        session_options.AddConfigEntry("session.inter_op.allow_spinning", options.allow_spinning ? "1" : "0");
+
+        session_options.SetExecutionMode(
+            options.execution_mode == ExecutionMode::Parallel ? ORT_PARALLEL : ORT_SEQUENTIAL
+        );
+        session_options.SetGraphOptimizationLevel(to_graph_optimization_level(options.optimization_level));
+        return session_options;
+    }
+
+    // ORT only appends the creation time in seconds to the prefix, which does not tell apart sessions created together.
+    static std::filesystem::path get_profile_file_prefix()
+    {
+        return std::filesystem::temp_directory_path() / ("inference_engine_ort_" + get_unique_id());
+    }
+};
+
+// Tensors bound to one set of input and output buffers.
+struct Binding
+{
+    Binding(Ort::Session &session, size_t input_count, size_t output_count)
+        : io_binding(session)
+        , input_data(input_count)
+        , output_data(output_count)
+        , is_input_owned(input_count, true)
+        , is_output_owned(output_count, true)
+    {
+        for (auto i = 0; i < input_count; i++)
+        {
+            input_values.emplace_back(nullptr);
+        }
+
+        for (auto i = 0; i < output_count; i++)
+        {
+            output_values.emplace_back(nullptr);
+        }
+    }
+
+    Ort::IoBinding io_binding;
+
+    std::vector<Ort::Value> input_values;
+    std::vector<Ort::Value> output_values;
+
+    // Data the tensors are currently bound to.
+    std::vector<void *> input_data;
+    std::vector<void *> output_data;
+
+    // Whether tensors are backed by the arena rather than by caller data.
+    std::vector<bool> is_input_owned;
+    std::vector<bool> is_output_owned;
+};
+
+class OrtInferenceEngine::Impl
+{
+public:
+    Impl(std::shared_ptr<Model> model)
+        : model(model)
+        , session(&model->session)
+        , memory_info(Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeCPU))
+        , run_options(nullptr)
+        , input_count(model->input_count)
+        , output_count(model->output_count)
+        , input_names(model->input_names)
+        , output_names(model->output_names)
+        , input_shapes(model->input_shapes)
+        , output_shapes(model->output_shapes)
+        , input_types(model->input_types)
+        , output_types(model->output_types)
+        , arena(model->numa_node)
+    {
+        for (auto i = 0; i < input_count; i++)
+        {
+            input_name_ptrs.push_back(input_names[i].get());
+        }
+
+        for (auto i = 0; i < output_count; i++)
+        {
+            output_name_ptrs.push_back(output_names[i].get());
+        }
+
+        for (auto i = 0; i < input_count; i++)
+        {
+            input_element_types.push_back(to_element_type(input_types[i]));
+        }
+
+        for (auto i = 0; i < output_count; i++)
+        {
+            output_element_types.push_back(to_element_type(output_types[i]));
+        }
+
+        bindings.push_back(std::make_unique<Binding>(*session, input_count, output_count));
+        binding = bindings.front().get();
+
+        buffer_sizes.resize(input_count + output_count);
+        allocate_buffers();
+
+        if (model->enable_stats)
+        {
+            stats = std::make_unique<EngineStatsRecorder>();
+        }
+    }
+
+    // Asynchronous runs complete on ORT's threads and keep using the bindings and the arena until then.
+    ~Impl()
+    {
+        std::unique_lock<std::mutex> lock(async_run_mutex);
+        async_run_finished.wait(lock, [this] { return async_run_count == 0; });
+    }
+
+    size_t get_input_count() const
+    {
+        return input_count;
+    }
+
+    size_t get_output_count() const
+    {
+        return output_count;
+    }
+
+    const std::vector<size_t> &get_input_shape(size_t index) const
+    {
+        return input_shapes[index];
+    }
+
+    const std::vector<size_t> &get_output_shape(size_t index) const
+    {
+        return output_shapes[index];
+    }
+
+    void set_input_shape(size_t index, Span<const size_t> shape)
+    {
+        StatsTimer timer(stats.get(), &EngineStatsRecorder::record_reshape);
+        validate_input_shape(index, shape);
+
+        if (update_input_shape(index, shape))
+        {
+            allocate_buffers();
+        }
+    }
+
+    void set_input_shapes(Span<const Span<const size_t>> shapes)
+    {
+        StatsTimer timer(stats.get(), &EngineStatsRecorder::record_reshape);
+        update_input_shapes(shapes);
+    }
+
+    void set_output_shape(size_t index, Span<const size_t> shape)
+    {
+        StatsTimer timer(stats.get(), &EngineStatsRecorder::record_reshape);
+
+        if (binding->is_output_owned[index] && shape == output_shapes[index])
+        {
+            return;
+        }
+
+        drop_buffer_sets();
+        output_shapes[index] = shape;
+        binding->output_data[index] = nullptr;
+        binding->is_output_owned[index] = true;
+        allocate_buffers();
+    }
+
+    ElementType get_input_element_type(size_t index) const
+    {
+        return input_element_types[index];
+    }
+
+    ElementType get_output_element_type(size_t index) const
+    {
+        return output_element_types[index];
+    }
+
+    void *get_input_raw_data(size_t index)
+    {
+        return binding->input_values[index].GetTensorMutableRawData();
+    }
+
+    const void *get_output_raw_data(size_t index) const
+    {
+        return binding->output_values[index].GetTensorRawData();
+    }
+
+    // Binding the engine's own buffer counts as not binding caller data, so that buffer sets registered with the
+    // current bindings can still be reshaped to the same shapes without being dropped.
+    void set_input_raw_data(size_t index, const void *data)
+    {
+        if (data == buffers[index])
+        {
+            data = nullptr;
+        }
+
+        if (stats && data)
+        {
+            stats->record_binding(input_shapes[index].get_element_count() * get_element_size(input_element_types[index]));
+        }
+
+        binding->is_input_owned[index] = !data;
+        bind_input(index, data ? const_cast<void *>(data) : buffers[index]);
+    }
+
+    void set_output_raw_data(size_t index, void *data)
+    {
+        if (data == buffers[input_count + index])
+        {
+            data = nullptr;
+        }
+
+        if (stats && data)
+        {
+            stats->record_binding(output_shapes[index].get_element_count() * get_element_size(output_element_types[index]));
+        }
+
+        binding->is_output_owned[index] = !data;
+        bind_output(index, data ? data : buffers[input_count + index]);
+    }
+
+    size_t register_buffer_set(const std::vector<const void *> &inputs, const std::vector<void *> &outputs)
+    {
+        if (inputs.size() != input_count || outputs.size() != output_count)
+        {
+            throw std::runtime_error("buffer count mismatch");
+        }
+
+        // Released slots are handed out again before the set list grows.
+        size_t id = 1;
+
+        while (id < bindings.size() && bindings[id])
+        {
+            id++;
+        }
+
+        if (id == bindings.size())
+        {
+            bindings.emplace_back();
+        }
+
+        auto selected_binding = binding;
+        bindings[id] = std::make_unique<Binding>(*session, input_count, output_count);
+        binding = bindings[id].get();
+
+        try
+        {
+            for (auto i = 0; i < input_count; i++)
+            {
+                set_input_raw_data(i, inputs[i]);
+            }
+
+            for (auto i = 0; i < output_count; i++)
+            {
+                set_output_raw_data(i, outputs[i]);
+            }
+        }
+        catch (...)
+        {
+            bindings[id].reset();
+            binding = selected_binding;
+            throw;
+        }
+
+        binding = selected_binding;
+        return id;
+    }
+
+    void select_buffer_set(size_t id)
+    {
+        if (id >= bindings.size())
+        {
+            throw std::runtime_error("invalid buffer set id");
+        }
+
+        binding = bindings[id] ? bindings[id].get() : bindings.front().get();
+    }
+
+    void unregister_buffer_set(size_t id)
+    {
+        if (id == 0 || id >= bindings.size())
+        {
+            throw std::runtime_error("invalid buffer set id");
+        }
+
+        if (binding == bindings[id].get())
+        {
+            binding = bindings.front().get();
+        }
+
+        bindings[id].reset();
+    }
+
+    size_t get_buffer_set_count() const
+    {
+        return bindings.size();
+    }
+
+    size_t get_memory_footprint() const
+    {
+        return model->data_size + arena.get_capacity();
+    }
+
+    std::vector<WarmupTiming> warmup(const std::vector<std::vector<std::vector<size_t>>> &shape_sets, size_t iterations)
+    {
+        std::vector<WarmupTiming> timings;
+
+        for (const auto &shapes : shape_sets)
+        {
+            WarmupTiming timing;
+            auto start = std::chrono::steady_clock::now();
+
+            update_input_shapes(get_spans(shapes));
+            drop_buffer_sets();
+
+            for (auto i = 0; i < input_count; i++)
+            {
+                set_input_raw_data(i, nullptr);
+                std::memset(buffers[i], 0, input_shapes[i].get_element_count() * get_element_size(input_element_types[i]));
+            }
+
+            for (auto i = 0; i < output_count; i++)
+            {
+                set_output_raw_data(i, nullptr);
+            }
+
+            timing.reshape = std::chrono::steady_clock::now() - start;
+
+            // Outputs are allocated by ORT, as dynamic output shapes are only known once the model ran.
+            Ort::IoBinding io_binding(*session);
+
+            for (auto i = 0; i < input_count; i++)
+            {
+                io_binding.BindInput(input_names[i].get(), binding->input_values[i]);
+            }
+
+            for (auto i = 0; i < output_count; i++)
+            {
+                io_binding.BindOutput(output_names[i].get(), memory_info);
+            }
+
+            for (auto i = 0; i < iterations; i++)
+            {
+                start = std::chrono::steady_clock::now();
+                session->Run(run_options, io_binding);
+                timing.last_run = std::chrono::steady_clock::now() - start;
+
+                if (i == 0)
+                {
+                    timing.first_run = timing.last_run;
+                }
+            }
+
+            timings.push_back(timing);
+        }
+
+        return timings;
+    }
+
+    EngineStats get_stats() const
+    {
+        if (!stats)
+        {
+            throw std::runtime_error("engine stats are disabled");
+        }
+
+        return stats->get_stats();
+    }
+
+    void reset_stats()
+    {
+        if (!stats)
+        {
+            throw std::runtime_error("engine stats are disabled");
+        }
+
+        stats->reset();
+    }
+
+    // Profiling again discards the events of the previous start.
+    void start_profiling()
+    {
+        if (!model->enable_profiling)
+        {
+            throw std::runtime_error("engine profiling is disabled");
+        }
+
+        if (profiling_session)
+        {
+            stop_profiling();
+        }
+
+        profiling_session = std::make_unique<Ort::Session>(model->create_profiling_session());
+        switch_session(profiling_session.get());
+    }
+
+    ProfileTrace stop_profiling()
+    {
+        if (!profiling_session)
+        {
+            throw std::runtime_error("profiling is not started");
+        }
+
+        auto ended_session = std::move(profiling_session);
+        switch_session(&model->session);
+
+        auto file_path = std::filesystem::u8path(ended_session->EndProfilingAllocated(model->allocator).get());
+        auto records = OrtProfileParser(file_path).parse();
+        std::filesystem::remove(file_path);
+
+        const std::string suffix = "_kernel_time";
+        ProfileTrace trace{"onnxruntime", model->name, {}};
+
+        for (auto &record : records)
+        {
+            const auto &name = record["name"];
+
+            if (record["cat"] != "Node" || name.size() < suffix.size() || name.compare(name.size() - suffix.size(), suffix.size(), suffix) != 0)
+            {
+                continue;
+            }
+
+            auto node_name = name.substr(0, name.size() - suffix.size());
+            const auto &op_type = record["args.op_name"];
+            trace.events.push_back({get_node_name(node_name, op_type, record["args.node_index"]), op_type, std::chrono::microseconds(std::stoll(record["ts"])), std::chrono::microseconds(std::stoll(record["dur"]))});
+        }
+
+        if (!trace.events.empty())
+        {
+            auto first = std::min_element(trace.events.begin(), trace.events.end(), [](const ProfileEvent &a, const ProfileEvent &b) { return a.start < b.start; })->start;
+
+            for (auto &event : trace.events)
+            {
+                event.start -= first;
+            }
+        }
+
+        return trace;
+    }
+
+    void run()
+    {
+        StatsTimer timer(stats.get(), &EngineStatsRecorder::record_run);
+        session->Run(run_options, binding->io_binding);
+    }
+
+    void run_async(RunCallback callback)
+    {
+        if (!model->supports_run_async)
+        {
+            worker.post([this, callback = std::move(callback)] {
+                std::exception_ptr error;
+
+                try
+                {
+                    run();
+                }
+                catch (...)
+                {
+                    error = std::current_exception();
+                }
+
+                callback(error);
+            });
+            return;
+        }
+
+        if (stats)
+        {
+            callback = [stats = stats.get(), start = std::chrono::steady_clock::now(), callback = std::move(callback)](std::exception_ptr error) {
+                if (!error)
+                {
+                    stats->record_run(std::chrono::steady_clock::now() - start);
+                }
+
+                callback(error);
+            };
+        }
+
+        auto user_data = std::make_unique<RunCallback>([this, callback = std::move(callback)](std::exception_ptr error) {
+            callback(error);
+            finish_async_run();
+        });
+
+        {
+            std::lock_guard<std::mutex> lock(async_run_mutex);
+            async_run_count++;
+        }
+
+        try
+        {
+            session->RunAsync(
+                run_options,
+                input_name_ptrs.data(),
+                binding->input_values.data(),
+                input_count,
+                output_name_ptrs.data(),
+                binding->output_values.data(),
+                output_count,
+                on_run_async_completed,
+                user_data.get()
+            );
+        }
+        catch (...)
+        {
+            finish_async_run();
+            throw;
+        }
+
+        user_data.release();
+    }
+
+private:
+    Ort::Value create_tensor(const Shape &shape, ONNXTensorElementDataType type, void *data)
+    {
+        return Ort::Value::CreateTensor(
+            memory_info,
+            data,
+            shape.get_element_count() * get_element_size(to_element_type(type)),
+            reinterpret_cast<const int64_t *>(shape.data()),
+            shape.size(),
+            type
+        );
+    }
+
+    // Nodes are named after their first output tensor, as TFLite names its nodes. ORT never reuses node indices, so
+    // that nodes it added while optimizing have indices past the ONNX ones and keep their names.
+    std::string get_node_name(const std::string &name, const std::string &op_type, const std::string &index) const
+    {
+        const auto &node_outputs = model->node_outputs;
+        auto node_index = index.empty() ? node_outputs.size() : std::stoull(index);
+
+        if (node_index < node_outputs.size() && !node_outputs[node_index].empty())
+        {
+            return node_outputs[node_index];
+        }
+
+        return name.empty() ? op_type : name;
+    }
+
+    // IoBindings belong to a session, so that all buffer sets are bound again to switch to another one.
+    void switch_session(Ort::Session *new_session)
+    {
+        for (auto &buffer_set : bindings)
+        {
+            if (!buffer_set)
+            {
+                continue;
+            }
+
+            Ort::IoBinding io_binding(*new_session);
+
+            for (auto i = 0; i < input_count; i++)
+            {
+                io_binding.BindInput(input_names[i].get(), buffer_set->input_values[i]);
+            }
+
+            for (auto i = 0; i < output_count; i++)
+            {
+                io_binding.BindOutput(output_names[i].get(), buffer_set->output_values[i]);
+            }
+
+            buffer_set->io_binding = std::move(io_binding);
+        }
+
+        session = new_session;
+    }
+
+    // Reshapes invalidate the views of registered buffer sets, so they are dropped and the engine's own set selected.
+    void drop_buffer_sets()
+    {
+        binding = bindings.front().get();
+        bindings.resize(1);
+    }
+
+    // Dynamic dimensions of the model are zero, and accept any size.
+    void validate_input_shape(size_t index, Span<const size_t> shape) const
+    {
+        const std::vector<size_t> &model_shape = model->input_shapes[index];
+
+        if (shape.size() != model_shape.size())
+        {
+            throw std::runtime_error("input shape rank mismatch");
+        }
+
+        for (size_t i = 0; i < shape.size(); i++)
+        {
+            if (model_shape[i] > 0 && shape[i] != model_shape[i])
+            {
+                throw std::runtime_error("input shape mismatch");
+            }
+        }
+    }
+
+    // Returns whether the tensor needs a new binding, resetting it to its engine-owned buffer if so.
+    bool update_input_shape(size_t index, Span<const size_t> shape)
+    {
+        if (binding->is_input_owned[index] && shape == input_shapes[index])
+        {
+            return false;
+        }
+
+        drop_buffer_sets();
+        input_shapes[index] = shape;
+        binding->input_data[index] = nullptr;
+        binding->is_input_owned[index] = true;
+        return true;
+    }
+
+    void update_input_shapes(Span<const Span<const size_t>> shapes)
+    {
+        if (shapes.size() != input_count)
+        {
+            throw std::runtime_error("input shape count mismatch");
+        }
+
+        // All shapes are checked before any is applied, so that a rejected set leaves the engine as it was.
+        for (size_t i = 0; i < input_count; i++)
+        {
+            validate_input_shape(i, shapes[i]);
+        }
+
+        auto is_changed = false;
+
+        for (auto i = 0; i < input_count; i++)
+        {
+            is_changed |= update_input_shape(i, shapes[i]);
+        }
+
+        if (is_changed)
+        {
+            allocate_buffers();
+        }
+    }
+
+    // Tensors are views over their data, so they are only recreated and rebound when the data or the shape changed.
+    void bind_input(size_t index, void *data)
+    {
+        if (binding->input_data[index] == data)
+        {
+            return;
+        }
+
+        binding->input_values[index] = create_tensor(input_shapes[index], input_types[index], data);
+        binding->io_binding.BindInput(input_names[index].get(), binding->input_values[index]);
+        binding->input_data[index] = data;
+    }
+
+    void bind_output(size_t index, void *data)
+    {
+        if (binding->output_data[index] == data)
+        {
+            return;
+        }
+
+        binding->output_values[index] = create_tensor(output_shapes[index], output_types[index], data);
+        binding->io_binding.BindOutput(output_names[index].get(), binding->output_values[index]);
+        binding->output_data[index] = data;
+    }
+
+    // Lays out the buffers of all inputs and outputs in the arena and rebinds the engine-owned ones.
+    // Every buffer keeps the largest size its tensor has needed, so shrinking a shape or going back to a smaller one
+    // moves nothing. Tensors bound to caller data keep their place too, so that unbinding them needs no new layout.
+    // Buffers moved by another tensor growing keep their contents.
+    void allocate_buffers()
+    {
+        previous_buffer_sizes = buffer_sizes;
+
+        for (auto i = 0; i < input_count; i++)
+        {
+            buffer_sizes[i] = std::max(buffer_sizes[i], input_shapes[i].get_element_count() * get_element_size(input_element_types[i]));
+        }
+
+        for (auto i = 0; i < output_count; i++)
+        {
+            auto &buffer_size = buffer_sizes[input_count + i];
+            buffer_size = std::max(buffer_size, output_shapes[i].get_element_count() * get_element_size(output_element_types[i]));
+        }
+
+        arena.reallocate(previous_buffer_sizes, buffer_sizes, buffers);
+
+        for (auto i = 0; i < input_count; i++)
+        {
+            if (binding->is_input_owned[i])
+            {
+                bind_input(i, buffers[i]);
+            }
+        }
+
+        for (auto i = 0; i < output_count; i++)
+        {
+            if (binding->is_output_owned[i])
+            {
+                bind_output(i, buffers[input_count + i]);
+            }
+        }
+    }
+
+    // Nothing of the engine is touched once the count is released, as the destructor may be waiting on it.
+    void finish_async_run()
+    {
+        std::lock_guard<std::mutex> lock(async_run_mutex);
+        async_run_count--;
+        async_run_finished.notify_all();
+    }
+
+    static void on_run_async_completed(void *user_data, OrtValue **outputs, size_t output_count, OrtStatusPtr status_ptr)
+    {
+        std::unique_ptr<RunCallback> callback(static_cast<RunCallback *>(user_data));
+        Ort::Status status(status_ptr);
+
+        if (status.IsOK())
+        {
+            (*callback)(nullptr);
+        }
+        else
+        {
+            (*callback)(std::make_exception_ptr(std::runtime_error(status.GetErrorMessage())));
+        }
+    }
+
+    std::shared_ptr<Model> model;
+
+    // Session of the engine while profiling, declared before the bindings that belong to it.
+    std::unique_ptr<Ort::Session> profiling_session;
+
+    // The model's session, or the profiling one.
+    Ort::Session *session;
+
+    Ort::MemoryInfo memory_info;
+    Ort::RunOptions run_options;
+
+    const size_t input_count;
+    const size_t output_count;
+
+    const std::vector<Ort::AllocatedStringPtr> &input_names;
+    const std::vector<Ort::AllocatedStringPtr> &output_names;
+
+    std::vector<const char *> input_name_ptrs;
+    std::vector<const char *> output_name_ptrs;
+
+    std::vector<Shape> input_shapes;
+    std::vector<Shape> output_shapes;
+
+    const std::vector<ONNXTensorElementDataType> &input_types;
+    const std::vector<ONNXTensorElementDataType> &output_types;
+
+    std::vector<ElementType> input_element_types;
+    std::vector<ElementType> output_element_types;
+
+    BufferArena arena;
+    std::vector<size_t> buffer_sizes;
+    std::vector<size_t> previous_buffer_sizes;
+    std::vector<std::byte *> buffers;
+
+    // Buffer sets the tensors can be bound to. The first one is the engine's own, the selected one is used by runs.
+    std::vector<std::unique_ptr<Binding>> bindings;
+    Binding *binding;
+
+    // Null unless stats are enabled, so that disabled engines only pay for the null checks.
+    std::unique_ptr<EngineStatsRecorder> stats;
+
+    std::mutex async_run_mutex;
+    std::condition_variable async_run_finished;
+    size_t async_run_count = 0;
+
+    Worker worker;
+};
+
+OrtInferenceEngine::OrtInferenceEngine(const void *model_data, size_t model_data_size_bytes, const EngineOptions &options)
+    : OrtInferenceEngine(load_model(model_data, model_data_size_bytes, options))
+{
+}
+
+OrtInferenceEngine::OrtInferenceEngine(const std::filesystem::path &model_path, const EngineOptions &options)
+    : OrtInferenceEngine(load_model(model_path, options))
+{
+}
+
+OrtInferenceEngine::OrtInferenceEngine(std::shared_ptr<Model> model)
+    : impl(new Impl(model))
+{
+}
+
+std::shared_ptr<OrtInferenceEngine::Model> OrtInferenceEngine::load_model(const void *model_data, size_t model_data_size_bytes, const EngineOptions &options)
+{
+    return std::make_shared<Model>(model_data, model_data_size_bytes, options);
+}
+
+std::shared_ptr<OrtInferenceEngine::Model> OrtInferenceEngine::load_model(const std::filesystem::path &model_path, const EngineOptions &options)
+{
+    return std::make_shared<Model>(model_path, options);
+}
+
+size_t OrtInferenceEngine::get_input_count() const
+{
+    return impl->get_input_count();
+}
+
+size_t OrtInferenceEngine::get_output_count() const
+{
+    return impl->get_output_count();
+}
+
+const std::vector<size_t> &OrtInferenceEngine::get_input_shape(size_t index) const
+{
+    return impl->get_input_shape(index);
+}
 
 const std::vector<size_t> &OrtInferenceEngine::get_output_shape(size_t index) const
 {
     return impl->get_output_shape(index);
 }
 
-void OrtInferenceEngine::set_input_shape(size_t index, const std::vector<size_t> &shape)
+void OrtInferenceEngine::set_input_shape(size_t index, Span<const size_t> shape)
 {
     impl->set_input_shape(index, shape);
 }
 
-void OrtInferenceEngine::set_output_shape(size_t index, const std::vector<size_t> &shape)
+void OrtInferenceEngine::set_input_shapes(Span<const Span<const size_t>> shapes)
+{
+    impl->set_input_shapes(shapes);
+}
+
+void OrtInferenceEngine::set_output_shape(size_t index, Span<const size_t> shape)
 {
     impl->set_output_shape(index, shape);
 }
 
-float *OrtInferenceEngine::get_input_data(size_t index)
+ElementType OrtInferenceEngine::get_input_element_type(size_t index) const
+{
+    return impl->get_input_element_type(index);
+}
+
+ElementType OrtInferenceEngine::get_output_element_type(size_t index) const
+{
+    return impl->get_output_element_type(index);
+}
+
+void *OrtInferenceEngine::get_input_raw_data(size_t index)
+{
+    return impl->get_input_raw_data(index);
+}
+
+const void *OrtInferenceEngine::get_output_raw_data(size_t index) const
+{
+    return impl->get_output_raw_data(index);
+}
+
+void OrtInferenceEngine::set_input_raw_data(size_t index, const void *data)
+{
+    impl->set_input_raw_data(index, data);
+}
+
+void OrtInferenceEngine::set_output_raw_data(size_t index, void *data)
+{
+    impl->set_output_raw_data(index, data);
+}
+
+size_t OrtInferenceEngine::register_buffer_set(const std::vector<const void *> &inputs, const std::vector<void *> &outputs)
+{
+    return impl->register_buffer_set(inputs, outputs);
+}
+
+void OrtInferenceEngine::select_buffer_set(size_t id)
+{
+    impl->select_buffer_set(id);
+}
+
+void OrtInferenceEngine::unregister_buffer_set(size_t id)
+{
+    impl->unregister_buffer_set(id);
+}
+
+size_t OrtInferenceEngine::get_buffer_set_count() const
+{
+    return impl->get_buffer_set_count();
+}
+
+size_t OrtInferenceEngine::get_memory_footprint() const
+{
+    return impl->get_memory_footprint();
+}
+
+std::vector<WarmupTiming> OrtInferenceEngine::warmup(const std::vector<std::vector<std::vector<size_t>>> &shape_sets, size_t iterations)
+{
+    return impl->warmup(shape_sets, iterations);
+}
+
+EngineStats OrtInferenceEngine::get_stats() const
 {
-    return impl->get_input_data(index);
+    return impl->get_stats();
 }
 
-const float *OrtInferenceEngine::get_output_data(size_t index) const
+void OrtInferenceEngine::reset_stats()
 {
-    return impl->get_output_data(index);
+    impl->reset_stats();
 }
 
-void OrtInferenceEngine::set_input_data(size_t index, const float *data)
+void OrtInferenceEngine::start_profiling()
 {
-    impl->set_input_data(index, data);
+    impl->start_profiling();
 }
 
-void OrtInferenceEngine::set_output_data(size_t index, float *data)
+ProfileTrace OrtInferenceEngine::stop_profiling()
 {
-    impl->set_output_data(index, data);
+    return impl->stop_profiling();
 }
 
 void OrtInferenceEngine::run()
 {
     impl->run();
 }
+
+void OrtInferenceEngine::run_async(RunCallback callback)
+{
+    impl->run_async(std::move(callback));
+}
 } // namespace inference_engine
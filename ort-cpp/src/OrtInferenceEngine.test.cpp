@@ -1,9 +1,21 @@
 #include "inference_engine/OrtInferenceEngine.hpp"
+#include "inference_engine/BatchScheduler.hpp"
+#include "inference_engine/ModelRegistry.hpp"
+#include "inference_engine/OrtEnginePool.hpp"
+#include "inference_engine/OverlapAddStream.hpp"
+#include "inference_engine/Pipeline.hpp"
+#include "inference_engine/StatefulSession.hpp"
 
 #include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <cstdint>
 #include <filesystem>
 #include <fstream>
+#include <numeric>
+#include <future>
+#include <memory>
 #include <string>
+#include <thread>
 #include <vector>
 
 std::vector<std::byte> read_file(const std::filesystem::path &file_path)
@@ -30,6 +42,11 @@ TEST_CASE("OrtInferenceEngine with fixed-shape model")
     REQUIRE(engine.get_input_shape(1) == std::vector<size_t>{2, 2});
     REQUIRE(engine.get_output_shape(0) == std::vector<size_t>{2, 2});
 
+    REQUIRE(engine.get_input_element_type(0) == ElementType::Float32);
+    REQUIRE(engine.get_input_element_type(1) == ElementType::Float32);
+    REQUIRE(engine.get_output_element_type(0) == ElementType::Float32);
+    REQUIRE_THROWS_WITH(engine.get_input_data<int64_t>(0), "element type mismatch");
+
     std::vector<std::vector<float>> inputs{{1, 2, 3, 4}, {5, 6, 7, 8}};
     for (auto i = 0; i < engine.get_input_count(); i++)
     {
@@ -66,6 +83,24 @@ TEST_CASE("OrtInferenceEngine with dynamic-shape model")
     REQUIRE(engine.get_input_shape(0) == std::vector<size_t>{2, 1});
     REQUIRE(engine.get_input_shape(1) == std::vector<size_t>{1, 2});
 
+    REQUIRE_THROWS_WITH(engine.set_input_shapes({{2, 1}}), "input shape count mismatch");
+    REQUIRE_THROWS_WITH(engine.set_input_shapes({{3, 1}, {1, 3, 1}}), "input shape rank mismatch");
+    REQUIRE(engine.get_input_shape(0) == std::vector<size_t>{2, 1});
+    engine.set_input_shapes({{3, 1}, {1, 3}});
+    REQUIRE(engine.get_input_shape(0) == std::vector<size_t>{3, 1});
+    REQUIRE(engine.get_input_shape(1) == std::vector<size_t>{1, 3});
+    REQUIRE(reinterpret_cast<uintptr_t>(engine.get_input_data(1)) % 64 == 0);
+
+    auto input_data = engine.get_input_data(1);
+    engine.set_input_shapes({{2, 1}, {1, 2}});
+    REQUIRE(engine.get_input_data(1) == input_data);
+
+    std::fill_n(engine.get_input_data(1), 2, 7.0f);
+    engine.set_input_shape(0, {20, 1});
+    REQUIRE(engine.get_input_data(1) != input_data);
+    REQUIRE(std::vector<float>(engine.get_input_data(1), engine.get_input_data(1) + 2) == std::vector<float>{7, 7});
+    engine.set_input_shape(0, {2, 1});
+
     engine.set_output_shape(0, {2, 2});
     REQUIRE(engine.get_output_shape(0) == std::vector<size_t>{2, 2});
 
@@ -86,3 +121,764 @@ TEST_CASE("OrtInferenceEngine with dynamic-shape model")
     engine.run();
     REQUIRE(outputs == std::vector<std::vector<float>>{{{3, 4, 6, 8}}});
 }
+
+TEST_CASE("OrtInferenceEngine with typed model")
+{
+    auto model = read_file("test-models/typed_io.onnx");
+    auto engine = OrtInferenceEngine(model.data(), model.size());
+
+    REQUIRE(engine.get_input_element_type(0) == ElementType::Int64);
+    REQUIRE(engine.get_input_element_type(1) == ElementType::Bool);
+    REQUIRE(engine.get_output_element_type(0) == ElementType::Float16);
+    REQUIRE(engine.get_output_element_type(1) == ElementType::Bool);
+
+    REQUIRE_THROWS_WITH(engine.get_input_data(0), "element type mismatch");
+
+    std::vector<int64_t> ids{1, 2, 3, -4};
+    bool mask[]{true, false, false, true};
+    engine.set_input_data(0, ids.data());
+    engine.set_input_data(1, mask);
+
+    Float16 features[4];
+    engine.set_output_data(0, features);
+
+    engine.run();
+
+    REQUIRE(features[0].bits == 0x3c00);
+    REQUIRE(features[1].bits == 0x4000);
+    REQUIRE(features[2].bits == 0x4200);
+    REQUIRE(features[3].bits == 0xc400);
+
+    auto inverted_mask = engine.get_output_data<bool>(1);
+    REQUIRE(std::vector<bool>(inverted_mask, inverted_mask + 4) == std::vector<bool>{false, true, true, false});
+}
+
+TEST_CASE("OrtInferenceEngine with model file")
+{
+    auto engine = OrtInferenceEngine(std::filesystem::path("test-models/matmul.onnx"));
+
+    REQUIRE(engine.get_input_count() == 2);
+    REQUIRE(engine.get_output_count() == 1);
+
+    std::vector<std::vector<float>> inputs{{1, 2, 3, 4}, {5, 6, 7, 8}};
+    for (auto i = 0; i < engine.get_input_count(); i++)
+    {
+        engine.set_input_data(i, inputs[i].data());
+    }
+
+    std::vector<std::vector<float>> outputs{{0, 0, 0, 0}};
+    for (auto i = 0; i < engine.get_output_count(); i++)
+    {
+        engine.set_output_data(i, outputs[i].data());
+    }
+
+    engine.run();
+
+    REQUIRE(outputs == std::vector<std::vector<float>>{{{19, 22, 43, 50}}});
+}
+
+TEST_CASE("OrtInferenceEngine with missing model file")
+{
+    REQUIRE_THROWS_WITH(OrtInferenceEngine(std::filesystem::path("test-models/missing.onnx")), "failed to open file: test-models/missing.onnx");
+}
+
+TEST_CASE("OrtInferenceEngine with engine options")
+{
+    auto model = read_file("test-models/matmul.onnx");
+    EngineOptions options;
+    options.intra_op_num_threads = 2;
+    options.inter_op_num_threads = 2;
+    options.execution_mode = ExecutionMode::Parallel;
+    auto engine = OrtInferenceEngine(model.data(), model.size(), options);
+
+    std::vector<std::vector<float>> inputs{{1, 2, 3, 4}, {5, 6, 7, 8}};
+    for (auto i = 0; i < engine.get_input_count(); i++)
+    {
+        engine.set_input_data(i, inputs[i].data());
+    }
+
+    std::vector<std::vector<float>> outputs{{0, 0, 0, 0}};
+    for (auto i = 0; i < engine.get_output_count(); i++)
+    {
+        engine.set_output_data(i, outputs[i].data());
+    }
+
+    engine.run();
+
+    REQUIRE(outputs == std::vector<std::vector<float>>{{{19, 22, 43, 50}}});
+}
+
+TEST_CASE("OrtInferenceEngine with thread placement")
+{
+    auto model = read_file("test-models/matmul.onnx");
+    EngineOptions options;
+    options.intra_op_num_threads = 2;
+    options.intra_op_thread_affinities = {{0}, {0}};
+    REQUIRE_THROWS_WITH(OrtInferenceEngine(model.data(), model.size(), options), "intra-op thread affinity count must be one less than the number of intra-op threads");
+
+    options.intra_op_thread_affinities = {{0}};
+    options.allow_spinning = false;
+#ifdef __linux__
+    options.numa_node = 0;
+#endif
+    auto engine = OrtInferenceEngine(model.data(), model.size(), options);
+
+    std::vector<std::vector<float>> inputs{{1, 2, 3, 4}, {5, 6, 7, 8}};
+    for (auto i = 0; i < engine.get_input_count(); i++)
+    {
+        engine.set_input_data(i, inputs[i].data());
+    }
+
+    engine.run();
+
+    auto output_data = engine.get_output_data(0);
+    REQUIRE(std::vector<float>(output_data, output_data + 4) == std::vector<float>{19, 22, 43, 50});
+}
+
+TEST_CASE("OrtInferenceEngine with global thread pool")
+{
+    auto model = read_file("test-models/matmul.onnx");
+    EngineOptions options;
+    options.intra_op_num_threads = 2;
+    options.use_global_thread_pool = true;
+
+    std::vector<OrtInferenceEngine> engines;
+    engines.emplace_back(model.data(), model.size(), options);
+    engines.emplace_back(model.data(), model.size(), options);
+    engines.emplace_back(model.data(), model.size());
+
+    for (auto &engine : engines)
+    {
+        std::vector<std::vector<float>> inputs{{1, 2, 3, 4}, {5, 6, 7, 8}};
+        for (auto i = 0; i < engine.get_input_count(); i++)
+        {
+            engine.set_input_data(i, inputs[i].data());
+        }
+
+        std::vector<std::vector<float>> outputs{{0, 0, 0, 0}};
+        for (auto i = 0; i < engine.get_output_count(); i++)
+        {
+            engine.set_output_data(i, outputs[i].data());
+        }
+
+        engine.run();
+
+        REQUIRE(outputs == std::vector<std::vector<float>>{{{19, 22, 43, 50}}});
+    }
+}
+
+TEST_CASE("OrtInferenceEngine with async run on a single-threaded global thread pool")
+{
+    auto model = read_file("test-models/matmul.onnx");
+    EngineOptions options;
+    options.intra_op_num_threads = 1;
+    options.use_global_thread_pool = true;
+
+    auto engine = OrtInferenceEngine(model.data(), model.size(), options);
+
+    // The pool keeps the single thread of the engine that created it, so that this engine falls back to its worker.
+    options.intra_op_num_threads = 2;
+    auto other_engine = OrtInferenceEngine(model.data(), model.size(), options);
+
+    std::vector<std::vector<float>> inputs{{1, 2, 3, 4}, {5, 6, 7, 8}};
+    for (auto i = 0; i < other_engine.get_input_count(); i++)
+    {
+        other_engine.set_input_data(i, inputs[i].data());
+    }
+
+    std::vector<float> output(4);
+    other_engine.set_output_data(0, output.data());
+    other_engine.run_async().get();
+
+    REQUIRE(output == std::vector<float>{19, 22, 43, 50});
+}
+
+TEST_CASE("OrtInferenceEngine with async run")
+{
+    auto model = read_file("test-models/matmul.onnx");
+    EngineOptions options;
+
+    SECTION("on the internal worker")
+    {
+        options.intra_op_num_threads = 1;
+    }
+
+    SECTION("on the intra-op thread pool")
+    {
+        options.intra_op_num_threads = 2;
+    }
+
+    auto engine = OrtInferenceEngine(model.data(), model.size(), options);
+
+    std::vector<std::vector<float>> inputs{{1, 2, 3, 4}, {5, 6, 7, 8}};
+    for (auto i = 0; i < engine.get_input_count(); i++)
+    {
+        engine.set_input_data(i, inputs[i].data());
+    }
+
+    std::vector<std::vector<float>> outputs{{0, 0, 0, 0}};
+    for (auto i = 0; i < engine.get_output_count(); i++)
+    {
+        engine.set_output_data(i, outputs[i].data());
+    }
+
+    engine.run_async().get();
+
+    REQUIRE(outputs == std::vector<std::vector<float>>{{{19, 22, 43, 50}}});
+
+    inputs[1][3] = 9;
+    std::promise<std::exception_ptr> completed;
+    engine.run_async([&completed](std::exception_ptr error) { completed.set_value(error); });
+
+    REQUIRE(completed.get_future().get() == nullptr);
+    REQUIRE(outputs == std::vector<std::vector<float>>{{{19, 24, 43, 54}}});
+
+    auto pending_engine = std::make_unique<OrtInferenceEngine>(model.data(), model.size(), options);
+    auto is_completed = false;
+    pending_engine->run_async([&is_completed](std::exception_ptr error) { is_completed = true; });
+    pending_engine.reset();
+    REQUIRE(is_completed);
+}
+
+TEST_CASE("OrtInferenceEngine with buffer sets")
+{
+    auto model = read_file("test-models/matmul.onnx");
+    auto engine = OrtInferenceEngine(model.data(), model.size());
+
+    std::vector<std::vector<float>> inputs{{1, 2, 3, 4}, {5, 6, 7, 8}, {1, 0, 0, 1}, {5, 6, 7, 9}};
+    std::vector<std::vector<float>> outputs{{0, 0, 0, 0}, {0, 0, 0, 0}};
+
+    auto first = engine.register_buffer_set({inputs[0].data(), inputs[1].data()}, {outputs[0].data()});
+    auto second = engine.register_buffer_set({inputs[2].data(), inputs[3].data()}, {outputs[1].data()});
+    REQUIRE(first == 1);
+    REQUIRE(second == 2);
+    REQUIRE_THROWS_WITH(engine.register_buffer_set({inputs[0].data()}, {outputs[0].data()}), "buffer count mismatch");
+    REQUIRE_THROWS_WITH(engine.select_buffer_set(3), "invalid buffer set id");
+
+    engine.select_buffer_set(first);
+    REQUIRE(engine.get_input_data(0) == inputs[0].data());
+    engine.run();
+
+    engine.select_buffer_set(second);
+    REQUIRE(engine.get_input_data(0) == inputs[2].data());
+    REQUIRE(engine.get_output_data(0) == outputs[1].data());
+    engine.run();
+
+    REQUIRE(outputs == std::vector<std::vector<float>>{{19, 22, 43, 50}, {5, 6, 7, 9}});
+
+    engine.unregister_buffer_set(second);
+    REQUIRE(engine.get_input_data(0) != inputs[2].data());
+    engine.select_buffer_set(second);
+    REQUIRE(engine.get_input_data(0) != inputs[2].data());
+    REQUIRE_THROWS_WITH(engine.unregister_buffer_set(0), "invalid buffer set id");
+    REQUIRE(engine.register_buffer_set({inputs[2].data(), inputs[3].data()}, {outputs[1].data()}) == second);
+    REQUIRE(engine.get_buffer_set_count() == 3);
+
+    engine.select_buffer_set(0);
+    REQUIRE(engine.get_input_data(0) != inputs[0].data());
+
+    REQUIRE_THROWS_WITH(engine.set_input_shape(0, {2, 1}), "input shape mismatch");
+    engine.select_buffer_set(first);
+
+    engine.set_input_shape(0, {2, 2});
+    REQUIRE_THROWS_WITH(engine.select_buffer_set(first), "invalid buffer set id");
+}
+
+TEST_CASE("OrtInferenceEngine with warmup")
+{
+    auto model = read_file("test-models/matmul_dynamic.onnx");
+    auto engine = OrtInferenceEngine(model.data(), model.size());
+
+    std::vector<float> input{1, 2};
+    engine.set_input_shapes({{2, 1}, {1, 2}});
+    engine.set_input_data(0, input.data());
+
+    REQUIRE_THROWS_WITH(engine.warmup({{{2, 1}}}, 1), "input shape count mismatch");
+
+    auto timings = engine.warmup({{{2, 1}, {1, 2}}, {{3, 1}, {1, 3}}}, 3);
+    REQUIRE(timings.size() == 2);
+
+    for (const auto &timing : timings)
+    {
+        REQUIRE(timing.first_run.count() > 0);
+        REQUIRE(timing.last_run.count() > 0);
+    }
+
+    REQUIRE(engine.get_input_shape(0) == std::vector<size_t>{3, 1});
+    REQUIRE(engine.get_input_shape(1) == std::vector<size_t>{1, 3});
+    REQUIRE(engine.get_input_data(0) != input.data());
+    REQUIRE(std::vector<float>(engine.get_input_data(0), engine.get_input_data(0) + 3) == std::vector<float>{0, 0, 0});
+
+    engine.set_output_shape(0, {3, 3});
+    std::copy_n(std::vector<float>{1, 2, 3}.begin(), 3, engine.get_input_data(0));
+    std::copy_n(std::vector<float>{1, 1, 1}.begin(), 3, engine.get_input_data(1));
+    engine.run();
+
+    auto output_data = engine.get_output_data(0);
+    REQUIRE(std::vector<float>(output_data, output_data + 9) == std::vector<float>{1, 1, 1, 2, 2, 2, 3, 3, 3});
+}
+
+TEST_CASE("OrtInferenceEngine with stats")
+{
+    auto model = read_file("test-models/matmul_dynamic.onnx");
+    REQUIRE_THROWS_WITH(OrtInferenceEngine(model.data(), model.size()).get_stats(), "engine stats are disabled");
+
+    EngineOptions options;
+    options.enable_stats = true;
+    auto engine = OrtInferenceEngine(model.data(), model.size(), options);
+
+    std::vector<std::vector<float>> inputs{{1, 2}, {3, 4}};
+    engine.warmup({{{3, 1}, {1, 3}}}, 2);
+    engine.set_input_shapes({{2, 1}, {1, 2}});
+    engine.set_output_shape(0, {2, 2});
+    engine.set_input_data(0, inputs[0].data());
+    engine.set_input_data(1, inputs[1].data());
+
+    for (auto i = 0; i < 3; i++)
+    {
+        engine.run();
+    }
+
+    auto stats = engine.get_stats();
+    REQUIRE(stats.run_count == 3);
+    REQUIRE(stats.run_time_min.count() > 0);
+    REQUIRE(stats.run_time_min <= stats.run_time_p50);
+    REQUIRE(stats.run_time_p50 <= stats.run_time_p99);
+    REQUIRE(stats.run_time_p99 <= stats.run_time_max);
+    REQUIRE(stats.run_time_total >= stats.run_time_max);
+    REQUIRE(stats.reshape_count == 2);
+    REQUIRE(stats.bytes_bound == 16);
+
+    engine.reset_stats();
+    stats = engine.get_stats();
+    REQUIRE(stats.run_count == 0);
+    REQUIRE(stats.run_time_min.count() == 0);
+    REQUIRE(stats.reshape_count == 0);
+    REQUIRE(stats.bytes_bound == 0);
+}
+
+TEST_CASE("OrtInferenceEngine with profiling")
+{
+    auto model = read_file("test-models/matmul.onnx");
+    REQUIRE_THROWS_WITH(OrtInferenceEngine(model.data(), model.size()).start_profiling(), "engine profiling is disabled");
+
+    EngineOptions options;
+    options.enable_profiling = true;
+    auto engine = OrtInferenceEngine(std::filesystem::path("test-models/matmul.onnx"), options);
+    REQUIRE_THROWS_WITH(engine.stop_profiling(), "profiling is not started");
+
+    engine.run();
+    engine.start_profiling();
+    engine.run();
+    engine.run();
+
+    auto trace = engine.stop_profiling();
+    REQUIRE(trace.engine == "onnxruntime");
+    REQUIRE(trace.model == "matmul.onnx");
+    REQUIRE(trace.events.size() == 2);
+    REQUIRE(trace.events[0].name == "C");
+    REQUIRE(trace.events[0].op_type == "MatMul");
+    REQUIRE(trace.events[0].start.count() == 0);
+    REQUIRE(trace.events[1].start >= trace.events[0].start + trace.events[0].duration);
+
+    // Engines of a pool share the model, but not their profiles.
+    auto pool = OrtEnginePool(model.data(), model.size(), options, 2);
+    auto first = pool.checkout();
+    auto second = pool.checkout();
+    first->start_profiling();
+    second->start_profiling();
+    first->run();
+    second->run();
+    second->run();
+    REQUIRE(first->stop_profiling().events.size() == 1);
+    REQUIRE(second->stop_profiling().events.size() == 2);
+
+    first->start_profiling();
+    first->run();
+    REQUIRE(first->stop_profiling().events[0].name == "C");
+
+    auto file_path = std::filesystem::temp_directory_path() / "inference_engine_ort_trace.json";
+    write_chrome_trace(file_path, {trace});
+    REQUIRE(std::filesystem::file_size(file_path) > 0);
+    std::filesystem::remove(file_path);
+}
+
+TEST_CASE("OrtInferenceEngine with optimized model cache")
+{
+    auto cache_dir = std::filesystem::temp_directory_path() / "inference_engine_ort_model_cache";
+    std::filesystem::remove_all(cache_dir);
+
+    auto model = read_file("test-models/matmul.onnx");
+    EngineOptions options;
+    options.optimization_level = OptimizationLevel::Extended;
+    options.optimized_model_cache_dir = cache_dir;
+
+    auto run = [](InferenceEngine &engine) {
+        std::vector<std::vector<float>> inputs{{1, 2, 3, 4}, {5, 6, 7, 8}};
+        for (auto i = 0; i < engine.get_input_count(); i++)
+        {
+            engine.set_input_data(i, inputs[i].data());
+        }
+
+        std::vector<float> output(4);
+        engine.set_output_data(0, output.data());
+        engine.run();
+
+        return output;
+    };
+
+    auto engine = OrtInferenceEngine(model.data(), model.size(), options);
+    REQUIRE(run(engine) == std::vector<float>{19, 22, 43, 50});
+
+    std::vector<std::filesystem::path> cached_files(std::filesystem::directory_iterator(cache_dir), {});
+    REQUIRE(cached_files.size() == 1);
+    REQUIRE(cached_files[0].extension() == ".ort");
+
+    auto cached_engine = OrtInferenceEngine(model.data(), model.size(), options);
+    REQUIRE(run(cached_engine) == std::vector<float>{19, 22, 43, 50});
+    REQUIRE(std::distance(std::filesystem::directory_iterator(cache_dir), {}) == 1);
+
+    auto ort_format_engine = OrtInferenceEngine(cached_files[0]);
+    REQUIRE(run(ort_format_engine) == std::vector<float>{19, 22, 43, 50});
+
+    // Errors of the model itself are thrown rather than taken for an unwritable cache, and leave no partial copy.
+    REQUIRE_THROWS(OrtInferenceEngine(model.data(), model.size() / 2, options));
+    REQUIRE(std::distance(std::filesystem::directory_iterator(cache_dir), {}) == 1);
+
+    // A file in place of the directory cannot be written to.
+    std::filesystem::remove_all(cache_dir);
+    std::ofstream(cache_dir).put('x');
+    auto uncached_engine = OrtInferenceEngine(model.data(), model.size(), options);
+    REQUIRE(run(uncached_engine) == std::vector<float>{19, 22, 43, 50});
+    REQUIRE(std::filesystem::is_regular_file(cache_dir));
+
+    std::filesystem::remove_all(cache_dir);
+}
+
+TEST_CASE("OrtEnginePool with concurrent runs")
+{
+    auto model = read_file("test-models/matmul.onnx");
+    auto pool = OrtEnginePool(model.data(), model.size(), {}, 2);
+
+    REQUIRE(pool.get_capacity() == 2);
+
+    std::vector<std::thread> threads;
+    std::vector<std::vector<float>> outputs(8, std::vector<float>(4));
+
+    for (auto t = 0; t < outputs.size(); t++)
+    {
+        threads.emplace_back([&pool, &outputs, t] {
+            auto engine = pool.checkout();
+
+            std::vector<std::vector<float>> inputs{{1, 2, 3, 4}, {5, 6, 7, static_cast<float>(8 + t)}};
+            for (auto i = 0; i < engine->get_input_count(); i++)
+            {
+                engine->set_input_data(i, inputs[i].data());
+            }
+
+            engine->set_output_data(0, outputs[t].data());
+            engine->run();
+            engine->set_output_data(0, nullptr);
+        });
+    }
+
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+
+    for (auto t = 0; t < outputs.size(); t++)
+    {
+        REQUIRE(outputs[t] == std::vector<float>{19, 22.0f + 2 * t, 43, 50.0f + 4 * t});
+    }
+}
+
+TEST_CASE("BatchScheduler with dynamic-batch model")
+{
+    auto model = read_file("test-models/add_dynamic.onnx");
+    auto engine = OrtInferenceEngine(model.data(), model.size());
+
+    BatchSchedulerOptions options;
+    options.max_batch_size = 4;
+    options.max_queue_delay = std::chrono::seconds(1);
+    options.output_shapes = {{2}};
+
+    std::vector<std::future<std::vector<BatchScheduler::Tensor>>> futures;
+
+    {
+        auto scheduler = BatchScheduler(engine, options);
+
+        futures.push_back(scheduler.submit({{{1, 2}, {1, 2}}, {{1, 2}, {10, 20}}}));
+        futures.push_back(scheduler.submit({{{2, 2}, {3, 4, 5, 6}}, {{2, 2}, {30, 40, 50, 60}}}));
+        futures.push_back(scheduler.submit({{{1, 2}, {7, 8}}, {{1, 2}, {70, 80}}}));
+
+        REQUIRE_THROWS_WITH(scheduler.submit({{{1, 2}, {1, 2}}}), "number of request inputs does not match the engine");
+        REQUIRE_THROWS_WITH(scheduler.submit({{{0, 2}, {}}, {{0, 2}, {}}}), "request batch dimension must not be zero");
+    }
+
+    REQUIRE(engine.get_input_shape(0) == std::vector<size_t>{4, 2});
+
+    auto outputs = futures[0].get();
+    REQUIRE(outputs[0].shape == std::vector<size_t>{1, 2});
+    REQUIRE(outputs[0].data == std::vector<float>{11, 22});
+
+    outputs = futures[1].get();
+    REQUIRE(outputs[0].shape == std::vector<size_t>{2, 2});
+    REQUIRE(outputs[0].data == std::vector<float>{33, 44, 55, 66});
+
+    outputs = futures[2].get();
+    REQUIRE(outputs[0].shape == std::vector<size_t>{1, 2});
+    REQUIRE(outputs[0].data == std::vector<float>{77, 88});
+}
+
+TEST_CASE("StatefulSession with accumulating model")
+{
+    auto model = read_file("test-models/accumulate.onnx");
+    auto engine = OrtInferenceEngine(model.data(), model.size());
+    auto session = StatefulSession(engine, {{1, 1}});
+
+    std::vector<float> x{1, 2};
+    engine.set_input_data(0, x.data());
+
+    auto output = [&engine] {
+        auto data = engine.get_output_data(0);
+        return std::vector<float>(data, data + 2);
+    };
+
+    auto first = session.create_state();
+    auto second = session.create_state();
+
+    session.run(first);
+    session.run(first);
+    REQUIRE(output() == std::vector<float>{2, 4});
+
+    session.run(second);
+    REQUIRE(output() == std::vector<float>{1, 2});
+
+    auto snapshot = first;
+    session.run(first);
+    REQUIRE(output() == std::vector<float>{3, 6});
+
+    first = snapshot;
+    session.run(first);
+    REQUIRE(output() == std::vector<float>{3, 6});
+    REQUIRE(static_cast<const float *>(first.get_data(0))[1] == 6);
+
+    first.reset();
+    session.run(first);
+    REQUIRE(output() == std::vector<float>{1, 2});
+}
+
+TEST_CASE("StatefulSession releases buffer sets of closed streams")
+{
+    auto model = read_file("test-models/accumulate.onnx");
+    auto engine = OrtInferenceEngine(model.data(), model.size());
+    auto session = StatefulSession(engine, {{1, 1}});
+
+    std::vector<float> x{1, 2};
+    engine.set_input_data(0, x.data());
+
+    for (auto i = 0; i < 100; i++)
+    {
+        auto state = session.create_state();
+        session.run(state);
+        session.run(state);
+    }
+
+    REQUIRE(engine.get_buffer_set_count() == 3);
+    engine.select_buffer_set(0);
+    REQUIRE(engine.get_input_data(0) == x.data());
+}
+
+TEST_CASE("OverlapAddStream with windowed model")
+{
+    auto model = read_file("test-models/window.onnx");
+    auto engine = OrtInferenceEngine(model.data(), model.size());
+
+    OverlapAddStreamOptions options;
+    options.window_size = 4;
+    options.hop_size = 2;
+    options.lookahead = 2;
+    options.synthesis_window = {0.5f, 0.5f, 0.5f, 0.5f};
+
+    std::vector<float> outputs;
+    auto stream = OverlapAddStream(engine, options, [&outputs](const float *data, size_t size) {
+        outputs.insert(outputs.end(), data, data + size);
+    });
+
+    std::vector<float> inputs(100);
+    std::iota(inputs.begin(), inputs.end(), 1.0f);
+
+    for (size_t offset = 0, size = 1; offset < inputs.size(); offset += size, size = size % 7 + 2)
+    {
+        stream.push(inputs.data() + offset, std::min(size, inputs.size() - offset));
+    }
+
+    // Each window sees 6 samples and scales the first 4 by 2, so past the first hop every sample is the sum of two
+    // windows weighted by 0.5.
+    REQUIRE(outputs.size() == 96);
+
+    for (auto i = 0; i < outputs.size(); i++)
+    {
+        REQUIRE(outputs[i] == (i < 2 ? 1 : 2) * inputs[i]);
+    }
+
+    outputs.clear();
+    stream.flush();
+    REQUIRE(outputs == std::vector<float>{97, 98});
+}
+
+TEST_CASE("OverlapAddStream releases its buffer sets")
+{
+    auto model = read_file("test-models/window.onnx");
+    auto engine = OrtInferenceEngine(model.data(), model.size());
+
+    OverlapAddStreamOptions options;
+    options.window_size = 4;
+    options.hop_size = 2;
+    options.lookahead = 2;
+
+    std::vector<float> inputs(40, 1.0f);
+
+    for (auto i = 0; i < 20; i++)
+    {
+        auto stream = OverlapAddStream(engine, options, [](const float *, size_t) {});
+        stream.push(inputs.data(), inputs.size());
+    }
+
+    // The windows of one stream cover all nine window positions.
+    REQUIRE(engine.get_buffer_set_count() == 10);
+}
+
+TEST_CASE("Pipeline with chained models")
+{
+    auto model = read_file("test-models/add_dynamic.onnx");
+    auto first = OrtInferenceEngine(model.data(), model.size());
+    auto second = OrtInferenceEngine(model.data(), model.size());
+
+    // The second stage adds 100 to the sums of the first, and follows its batch size.
+    auto reshape = [](InferenceEngine &engine) {
+        auto shape = engine.get_input_shape(0);
+        engine.set_input_shape(1, shape);
+        engine.set_output_shape(0, shape);
+        std::fill_n(engine.get_input_data(1), shape[0] * shape[1], 100.0f);
+    };
+
+    std::vector<std::vector<float>> outputs(6);
+    std::vector<std::future<void>> futures;
+
+    {
+        auto pipeline = Pipeline({{&first}, {&second, {{0, 0}}, reshape}});
+
+        for (auto i = 0; i < outputs.size(); i++)
+        {
+            auto prepare = [i](InferenceEngine &engine) {
+                if (i == 3)
+                {
+                    throw std::runtime_error("bad chunk");
+                }
+
+                std::vector<size_t> shape{size_t(i % 2 + 1), 2};
+                engine.set_input_shapes({shape, shape});
+                engine.set_output_shape(0, shape);
+                std::fill_n(engine.get_input_data(0), shape[0] * 2, float(i));
+                std::fill_n(engine.get_input_data(1), shape[0] * 2, 1.0f);
+            };
+
+            auto finish = [&outputs, i](InferenceEngine &engine) {
+                auto shape = engine.get_output_shape(0);
+                auto data = engine.get_output_data(0);
+                outputs[i].assign(data, data + shape[0] * shape[1]);
+            };
+
+            futures.push_back(pipeline.submit(prepare, finish));
+        }
+    }
+
+    for (auto i = 0; i < outputs.size(); i++)
+    {
+        if (i == 3)
+        {
+            REQUIRE_THROWS_WITH(futures[i].get(), "bad chunk");
+            continue;
+        }
+
+        futures[i].get();
+        REQUIRE(outputs[i] == std::vector<float>((i % 2 + 1) * 2, i + 101.0f));
+    }
+}
+
+TEST_CASE("ModelRegistry with memory budget")
+{
+    auto model = read_file("test-models/matmul.onnx");
+    auto registry = ModelRegistry(250);
+    std::vector<int> load_counts(3);
+    std::vector<bool> is_model0_loaded_by_loads;
+
+    for (auto i = 0; i < load_counts.size(); i++)
+    {
+        auto loader = [&model, &registry, &load_counts, &is_model0_loaded_by_loads, i] {
+            load_counts[i]++;
+            is_model0_loaded_by_loads.push_back(registry.is_loaded("model0"));
+            return std::make_unique<OrtInferenceEngine>(model.data(), model.size());
+        };
+
+        registry.register_model("model" + std::to_string(i), loader, 100);
+    }
+
+    REQUIRE_THROWS(registry.register_model("model0", [] { return nullptr; }, 100));
+    REQUIRE_THROWS(registry.acquire("model3"));
+    REQUIRE(registry.get_memory_usage() == 0);
+
+    auto engine0 = registry.acquire("model0");
+    auto engine1 = registry.acquire("model1");
+    REQUIRE(registry.get_memory_usage() == 200);
+
+    {
+        auto engine2 = registry.acquire("model2");
+        auto engine2_copy = engine2;
+        REQUIRE(engine2_copy.get() == engine2.get());
+        REQUIRE(registry.get_memory_usage() == 300);
+
+        std::vector<std::vector<float>> inputs{{1, 2, 3, 4}, {5, 6, 7, 8}};
+        for (auto i = 0; i < engine2->get_input_count(); i++)
+        {
+            engine2->set_input_data(i, inputs[i].data());
+        }
+
+        std::vector<float> output(4);
+        engine2->set_output_data(0, output.data());
+        engine2->run();
+        REQUIRE(output == std::vector<float>{19, 22, 43, 50});
+    }
+
+    REQUIRE_FALSE(registry.is_loaded("model2"));
+    REQUIRE(registry.get_memory_usage() == 200);
+
+    engine0.release();
+    engine1.release();
+    REQUIRE(registry.is_loaded("model0"));
+    REQUIRE(registry.is_loaded("model1"));
+
+    auto engine2 = registry.acquire("model2");
+    REQUIRE_FALSE(registry.is_loaded("model0"));
+    REQUIRE(registry.is_loaded("model1"));
+    REQUIRE(load_counts == std::vector<int>{1, 1, 2});
+
+    // Room is made before loading.
+    REQUIRE_FALSE(is_model0_loaded_by_loads.back());
+
+    REQUIRE_THROWS(registry.unregister_model("model2"));
+    engine2.release();
+    registry.unregister_model("model2");
+    REQUIRE(registry.get_memory_usage() == 100);
+
+    registry.set_memory_budget(0);
+    REQUIRE(registry.get_memory_usage() == 0);
+
+    registry.set_memory_budget(1 << 30);
+    registry.register_model("reported", [&model] { return std::make_unique<OrtInferenceEngine>(model.data(), model.size()); });
+    auto reported = registry.acquire("reported");
+    REQUIRE(reported->get_memory_footprint() >= model.size());
+    REQUIRE(registry.get_memory_usage() == reported->get_memory_footprint());
+}
@@ -1,2 +1,6 @@
+from models.window import *
+from models.accumulate import *
+from models.typed_io import *
+from models.add_dynamic import *
 from models.matmul_dynamic import *
 from models.matmul import *
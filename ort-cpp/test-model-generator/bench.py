@@ -0,0 +1,20 @@
+import argparse, os
+
+from bench_models import conv, lstm, transformer
+
+parser = argparse.ArgumentParser(description="Generate models for benchmarking.")
+parser.add_argument(
+    "--scales",
+    type=int,
+    nargs="+",
+    default=[1, 2, 4],
+    help="width multipliers of the generated models",
+)
+args = parser.parse_args()
+
+os.makedirs("../bench-models", exist_ok=True)
+
+for scale in args.scales:
+    for family in [conv, lstm, transformer]:
+        name = family.__name__.split(".")[-1]
+        family.generate(scale, f"../bench-models/{name}_{scale}.onnx")
@@ -0,0 +1,64 @@
+import numpy as np
+from onnx import helper, numpy_helper, TensorProto, OperatorSetIdProto
+
+
+# Image classifier of 4 3x3 convolutions with 16 * scale channels, taking (N, 3, 32, 32) to (N, 10).
+def generate(scale, model_file):
+    rng = np.random.default_rng(0)
+    channels = 16 * scale
+    nodes = []
+    initializers = []
+
+    def weight(name, shape):
+        data = (rng.standard_normal(shape) * 0.1).astype(np.float32)
+        initializers.append(numpy_helper.from_array(data, name))
+        return name
+
+    x = "X"
+    input_channels = 3
+
+    for i in range(4):
+        w = weight(f"W{i}", (channels, input_channels, 3, 3))
+        b = weight(f"B{i}", (channels,))
+        stride = 2 if i % 2 else 1
+        nodes.append(
+            helper.make_node(
+                "Conv",
+                [x, w, b],
+                [f"Conv{i}"],
+                pads=[1, 1, 1, 1],
+                strides=[stride, stride],
+            )
+        )
+        nodes.append(helper.make_node("Relu", [f"Conv{i}"], [f"Relu{i}"]))
+        x = f"Relu{i}"
+        input_channels = channels
+
+    nodes.append(helper.make_node("GlobalAveragePool", [x], ["Pool"]))
+    nodes.append(helper.make_node("Flatten", ["Pool"], ["Flatten"]))
+    nodes.append(
+        helper.make_node(
+            "Gemm",
+            ["Flatten", weight("W", (channels, 10)), weight("B", (10,))],
+            ["Y"],
+        )
+    )
+
+    graph = helper.make_graph(
+        name="graph",
+        nodes=nodes,
+        inputs=[
+            helper.make_tensor_value_info("X", TensorProto.FLOAT, ("N", 3, 32, 32))
+        ],
+        outputs=[helper.make_tensor_value_info("Y", TensorProto.FLOAT, ("N", 10))],
+        initializer=initializers,
+    )
+
+    model = helper.make_model(
+        graph,
+        ir_version=8,
+        opset_imports=[OperatorSetIdProto(version=17)],
+    )
+
+    with open(model_file, "wb") as f:
+        f.write(model.SerializeToString())
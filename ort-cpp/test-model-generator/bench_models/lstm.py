@@ -0,0 +1,51 @@
+import numpy as np
+from onnx import helper, numpy_helper, TensorProto, OperatorSetIdProto
+
+
+# 2 stacked LSTMs with 64 * scale hidden units, taking (T, N, 32) to (T, N, 32).
+def generate(scale, model_file):
+    rng = np.random.default_rng(0)
+    hidden_size = 64 * scale
+    nodes = []
+    initializers = [numpy_helper.from_array(np.array([1], dtype=np.int64), "Axes")]
+
+    def weight(name, shape):
+        data = (rng.standard_normal(shape) * 0.1).astype(np.float32)
+        initializers.append(numpy_helper.from_array(data, name))
+        return name
+
+    x = "X"
+    input_size = 32
+
+    for i in range(2):
+        w = weight(f"W{i}", (1, 4 * hidden_size, input_size))
+        r = weight(f"R{i}", (1, 4 * hidden_size, hidden_size))
+        b = weight(f"B{i}", (1, 8 * hidden_size))
+        nodes.append(
+            helper.make_node(
+                "LSTM", [x, w, r, b], [f"Lstm{i}"], hidden_size=hidden_size
+            )
+        )
+        # Drops the direction axis of (T, 1, N, H).
+        nodes.append(helper.make_node("Squeeze", [f"Lstm{i}", "Axes"], [f"Squeeze{i}"]))
+        x = f"Squeeze{i}"
+        input_size = hidden_size
+
+    nodes.append(helper.make_node("MatMul", [x, weight("W", (hidden_size, 32))], ["Y"]))
+
+    graph = helper.make_graph(
+        name="graph",
+        nodes=nodes,
+        inputs=[helper.make_tensor_value_info("X", TensorProto.FLOAT, ("T", "N", 32))],
+        outputs=[helper.make_tensor_value_info("Y", TensorProto.FLOAT, ("T", "N", 32))],
+        initializer=initializers,
+    )
+
+    model = helper.make_model(
+        graph,
+        ir_version=8,
+        opset_imports=[OperatorSetIdProto(version=17)],
+    )
+
+    with open(model_file, "wb") as f:
+        f.write(model.SerializeToString())
@@ -0,0 +1,102 @@
+import numpy as np
+from onnx import helper, numpy_helper, TensorProto, OperatorSetIdProto
+
+
+# 2 pre-norm transformer encoder layers of width 64 * scale with 4 heads, taking (N, T, 32) to (N, T, 32).
+def generate(scale, model_file):
+    rng = np.random.default_rng(0)
+    model_size = 64 * scale
+    head_count = 4
+    head_size = model_size // head_count
+    nodes = []
+    initializers = [
+        numpy_helper.from_array(
+            np.array([0, -1, head_count, head_size], dtype=np.int64), "HeadShape"
+        ),
+        numpy_helper.from_array(
+            np.array([0, -1, model_size], dtype=np.int64), "ModelShape"
+        ),
+        numpy_helper.from_array(
+            np.array(1 / np.sqrt(head_size), dtype=np.float32), "Scale"
+        ),
+    ]
+
+    def weight(name, shape, value=None):
+        data = (
+            rng.standard_normal(shape) * 0.1 if value is None else np.full(shape, value)
+        )
+        initializers.append(numpy_helper.from_array(data.astype(np.float32), name))
+        return name
+
+    def node(op_type, inputs, name, **attributes):
+        nodes.append(helper.make_node(op_type, inputs, [name], **attributes))
+        return name
+
+    def layer_norm(x, name):
+        return node(
+            "LayerNormalization",
+            [
+                x,
+                weight(f"{name}Scale", (model_size,), 1),
+                weight(f"{name}Bias", (model_size,), 0),
+            ],
+            name,
+            axis=-1,
+        )
+
+    def heads(x, name):
+        x = node("MatMul", [x, weight(f"{name}W", (model_size, model_size))], f"{name}")
+        x = node("Reshape", [x, "HeadShape"], f"{name}Heads")
+        return node("Transpose", [x], f"{name}Transposed", perm=[0, 2, 1, 3])
+
+    x = node("MatMul", ["X", weight("InputW", (32, model_size))], "Input")
+
+    for i in range(2):
+        n = layer_norm(x, f"Norm{i}a")
+        q = heads(n, f"Q{i}")
+        k = node("Transpose", [heads(n, f"K{i}")], f"K{i}T", perm=[0, 1, 3, 2])
+        v = heads(n, f"V{i}")
+        scores = node(
+            "Mul", [node("MatMul", [q, k], f"Scores{i}"), "Scale"], f"Scaled{i}"
+        )
+        weights = node("Softmax", [scores], f"Weights{i}", axis=-1)
+        attention = node("MatMul", [weights, v], f"Attention{i}")
+        attention = node("Transpose", [attention], f"Attention{i}T", perm=[0, 2, 1, 3])
+        attention = node("Reshape", [attention, "ModelShape"], f"Attention{i}Merged")
+        attention = node(
+            "MatMul", [attention, weight(f"O{i}W", (model_size, model_size))], f"O{i}"
+        )
+        x = node("Add", [x, attention], f"Residual{i}a")
+
+        n = layer_norm(x, f"Norm{i}b")
+        hidden = node(
+            "MatMul", [n, weight(f"Ff{i}W1", (model_size, 4 * model_size))], f"Ff{i}a"
+        )
+        hidden = node("Relu", [hidden], f"Ff{i}Relu")
+        hidden = node(
+            "MatMul",
+            [hidden, weight(f"Ff{i}W2", (4 * model_size, model_size))],
+            f"Ff{i}b",
+        )
+        x = node("Add", [x, hidden], f"Residual{i}b")
+
+    nodes.append(
+        helper.make_node("MatMul", [x, weight("OutputW", (model_size, 32))], ["Y"])
+    )
+
+    graph = helper.make_graph(
+        name="graph",
+        nodes=nodes,
+        inputs=[helper.make_tensor_value_info("X", TensorProto.FLOAT, ("N", "T", 32))],
+        outputs=[helper.make_tensor_value_info("Y", TensorProto.FLOAT, ("N", "T", 32))],
+        initializer=initializers,
+    )
+
+    model = helper.make_model(
+        graph,
+        ir_version=8,
+        opset_imports=[OperatorSetIdProto(version=17)],
+    )
+
+    with open(model_file, "wb") as f:
+        f.write(model.SerializeToString())
@@ -0,0 +1,36 @@
+from onnx import helper, TensorProto, OperatorSetIdProto
+
+model_file = "../test-models/accumulate.onnx"
+
+input_names = ["X", "StateIn"]
+inputs = [
+    helper.make_tensor_value_info(name, TensorProto.FLOAT, [2])
+    for name in input_names
+]
+
+output_names = ["Y", "StateOut"]
+outputs = [
+    helper.make_tensor_value_info(name, TensorProto.FLOAT, [2])
+    for name in output_names
+]
+
+nodes = [
+    helper.make_node(op_type="Add", inputs=input_names, outputs=["Y"]),
+    helper.make_node(op_type="Identity", inputs=["Y"], outputs=["StateOut"]),
+]
+
+graph = helper.make_graph(
+    name="graph",
+    nodes=nodes,
+    inputs=inputs,
+    outputs=outputs,
+)
+
+model = helper.make_model(
+    graph,
+    ir_version=8,
+    opset_imports=[OperatorSetIdProto(version=17)],
+)
+
+with open(model_file, "wb") as f:
+    f.write(model.SerializeToString())
@@ -0,0 +1,43 @@
+from onnx import helper, TensorProto, OperatorSetIdProto
+
+model_file = "../test-models/typed_io.onnx"
+
+inputs = [
+    helper.make_tensor_value_info("A", TensorProto.INT64, (2, 2)),
+    helper.make_tensor_value_info("B", TensorProto.BOOL, (2, 2)),
+]
+
+outputs = [
+    helper.make_tensor_value_info("C", TensorProto.FLOAT16, (2, 2)),
+    helper.make_tensor_value_info("D", TensorProto.BOOL, (2, 2)),
+]
+
+nodes = [
+    helper.make_node(
+        op_type="Cast",
+        inputs=["A"],
+        outputs=["C"],
+        to=TensorProto.FLOAT16,
+    ),
+    helper.make_node(
+        op_type="Not",
+        inputs=["B"],
+        outputs=["D"],
+    ),
+]
+
+graph = helper.make_graph(
+    name="graph",
+    nodes=nodes,
+    inputs=inputs,
+    outputs=outputs,
+)
+
+model = helper.make_model(
+    graph,
+    ir_version=8,
+    opset_imports=[OperatorSetIdProto(version=17)],
+)
+
+with open(model_file, "wb") as f:
+    f.write(model.SerializeToString())
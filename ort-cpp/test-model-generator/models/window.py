@@ -0,0 +1,34 @@
+from onnx import helper, TensorProto, OperatorSetIdProto
+
+model_file = "../test-models/window.onnx"
+
+inputs = [helper.make_tensor_value_info("X", TensorProto.FLOAT, [6])]
+outputs = [helper.make_tensor_value_info("Y", TensorProto.FLOAT, [4])]
+
+initializers = [
+    helper.make_tensor("Starts", TensorProto.INT64, [1], [0]),
+    helper.make_tensor("Ends", TensorProto.INT64, [1], [4]),
+    helper.make_tensor("Gain", TensorProto.FLOAT, [], [2]),
+]
+
+nodes = [
+    helper.make_node(op_type="Slice", inputs=["X", "Starts", "Ends"], outputs=["S"]),
+    helper.make_node(op_type="Mul", inputs=["S", "Gain"], outputs=["Y"]),
+]
+
+graph = helper.make_graph(
+    name="graph",
+    nodes=nodes,
+    inputs=inputs,
+    outputs=outputs,
+    initializer=initializers,
+)
+
+model = helper.make_model(
+    graph,
+    ir_version=8,
+    opset_imports=[OperatorSetIdProto(version=17)],
+)
+
+with open(model_file, "wb") as f:
+    f.write(model.SerializeToString())
@@ -1,7 +1,8 @@
 pub use inference_engine_core::*;
 
 use inference_engine_ort_sys as sys;
-use std::ffi::c_void;
+use std::ffi::{c_void, CString};
+use std::path::Path;
 use std::ptr::null_mut;
 
 #[derive(Debug)]
@@ -11,15 +12,44 @@ pub struct OrtInferenceEngine {
 
 impl OrtInferenceEngine {
     pub fn new(model_data: impl AsRef<[u8]>) -> Result<Self, Error> {
+        Self::with_options(model_data, &EngineOptions::default())
+    }
+
+    pub fn with_options(
+        model_data: impl AsRef<[u8]>,
+        options: &EngineOptions,
+    ) -> Result<Self, Error> {
         unsafe {
             let model_data = model_data.as_ref();
+            let options = sys::RawEngineOptions::try_from(options)?;
+            let mut raw = null_mut();
+
+            Result::from(
+                sys::inference_engine_ort__create_inference_engine_with_options(
+                    model_data.as_ptr() as _,
+                    model_data.len(),
+                    options.as_ptr(),
+                    &mut raw,
+                ),
+            )?;
+
+            Ok(Self { raw })
+        }
+    }
+    pub fn from_file(model_path: impl AsRef<Path>, options: &EngineOptions) -> Result<Self, Error> {
+        unsafe {
+            let model_path = CString::new(model_path.as_ref().to_string_lossy().as_bytes())
+                .map_err(|e| Error::Unknown(Box::new(e)))?;
+            let options = sys::RawEngineOptions::try_from(options)?;
             let mut raw = null_mut();
 
-            Result::from(sys::inference_engine_ort__create_inference_engine(
-                model_data.as_ptr() as _,
-                model_data.len(),
-                &mut raw,
-            ))?;
+            Result::from(
+                sys::inference_engine_ort__create_inference_engine_from_file(
+                    model_path.as_ptr(),
+                    options.as_ptr(),
+                    &mut raw,
+                ),
+            )?;
 
             Ok(Self { raw })
         }
@@ -35,6 +65,29 @@ extern crate assert_matches;
 #[cfg(test)]
 mod tests {
     use super::*;
+    use std::alloc::{GlobalAlloc, Layout, System};
+    use std::cell::Cell;
+
+    thread_local! {
+        static ALLOCATION_COUNT: Cell<usize> = const { Cell::new(0) };
+    }
+
+    /// Counts the allocations of each thread, so that tests running in parallel do not disturb each other.
+    struct CountingAllocator;
+
+    unsafe impl GlobalAlloc for CountingAllocator {
+        unsafe fn alloc(&self, layout: Layout) -> *mut u8 {
+            ALLOCATION_COUNT.with(|count| count.set(count.get() + 1));
+            System.alloc(layout)
+        }
+
+        unsafe fn dealloc(&self, ptr: *mut u8, layout: Layout) {
+            System.dealloc(ptr, layout)
+        }
+    }
+
+    #[global_allocator]
+    static ALLOCATOR: CountingAllocator = CountingAllocator;
 
     #[test]
     fn with_invalid_model_data() {
@@ -49,15 +102,15 @@ mod tests {
         let model_data = include_bytes!("../../ort-cpp/test-models/matmul.onnx");
         let mut engine = OrtInferenceEngine::new(model_data).unwrap();
 
-        assert_eq!(engine.input_shapes(), [[2, 2], [2, 2]]);
-        assert_eq!(engine.output_shapes(), [[2, 2]]);
+        assert_eq!(engine.input_shapes().collect::<Vec<_>>(), [[2, 2], [2, 2]]);
+        assert_eq!(engine.output_shapes().collect::<Vec<_>>(), [[2, 2]]);
 
         let input_data = [[1., 2., 3., 4.], [5., 6., 7., 8.]];
         let input_data = input_data.iter().map(|v| v.as_slice()).collect::<Vec<_>>();
         engine.set_input_data_all(&input_data).unwrap();
         engine
             .input_data_all()
-            .iter()
+            .unwrap()
             .zip(input_data.iter())
             .for_each(|(a, b)| {
                 assert_eq!(a.as_ptr(), b.as_ptr() as _);
@@ -71,7 +124,7 @@ mod tests {
         engine.set_output_data_all(&mut output_data).unwrap();
         engine
             .output_data_all()
-            .iter()
+            .unwrap()
             .zip(output_data.iter())
             .for_each(|(a, b)| {
                 assert_eq!(a.as_ptr(), b.as_ptr() as _);
@@ -81,26 +134,225 @@ mod tests {
         assert_eq!(output_data, [[19., 22., 43., 50.]]);
     }
 
+    #[test]
+    fn with_typed_model() {
+        let model_data = include_bytes!("../../ort-cpp/test-models/typed_io.onnx");
+        let mut engine = OrtInferenceEngine::new(model_data).unwrap();
+
+        assert_eq!(engine.input_element_type(0), ElementType::Int64);
+        assert_eq!(engine.input_element_type(1), ElementType::Bool);
+        assert_eq!(engine.output_element_type(0), ElementType::Float16);
+        assert_eq!(engine.output_element_type(1), ElementType::Bool);
+
+        assert_matches!(
+            engine.typed_input_data::<f32>(0),
+            Err(Error::ElementTypeMismatch {
+                expected: ElementType::Float32,
+                found: ElementType::Int64
+            })
+        );
+        assert!(engine.input_data(0).is_err());
+        assert!(engine.output_data_all().is_err());
+
+        let ids = [1i64, 2, 3, -4];
+        engine.set_typed_input_data(0, &ids).unwrap();
+        engine
+            .typed_input_data::<bool>(1)
+            .unwrap()
+            .copy_from_slice(&[true, false, false, true]);
+
+        let mut features = [Float16::default(); 4];
+        engine.set_typed_output_data(0, &mut features).unwrap();
+
+        engine.run().unwrap();
+        assert_eq!(features, [0x3c00, 0x4000, 0x4200, 0xc400].map(Float16));
+        assert_eq!(
+            engine.typed_output_data::<bool>(1).unwrap(),
+            [false, true, true, false]
+        );
+    }
+
+    #[test]
+    fn from_file() {
+        let model_path =
+            Path::new(env!("CARGO_MANIFEST_DIR")).join("../ort-cpp/test-models/matmul.onnx");
+        let mut engine =
+            OrtInferenceEngine::from_file(model_path, &EngineOptions::default()).unwrap();
+
+        assert_eq!(engine.input_shapes().collect::<Vec<_>>(), [[2, 2], [2, 2]]);
+        assert_eq!(engine.output_shapes().collect::<Vec<_>>(), [[2, 2]]);
+
+        let input_data = [[1., 2., 3., 4.], [5., 6., 7., 8.]];
+        let input_data = input_data.iter().map(|v| v.as_slice()).collect::<Vec<_>>();
+        engine.set_input_data_all(&input_data).unwrap();
+
+        engine.run().unwrap();
+        assert_eq!(engine.output_data(0).unwrap(), [19., 22., 43., 50.]);
+    }
+
+    #[test]
+    fn with_options() {
+        let model_data = include_bytes!("../../ort-cpp/test-models/matmul.onnx");
+        let options = EngineOptions {
+            intra_op_num_threads: 2,
+            inter_op_num_threads: 2,
+            execution_mode: ExecutionMode::Parallel,
+            ..Default::default()
+        };
+        let mut engine = OrtInferenceEngine::with_options(model_data, &options).unwrap();
+
+        let input_data = [[1., 2., 3., 4.], [5., 6., 7., 8.]];
+        let input_data = input_data.iter().map(|v| v.as_slice()).collect::<Vec<_>>();
+        engine.set_input_data_all(&input_data).unwrap();
+
+        engine.run().unwrap();
+        assert_eq!(engine.output_data(0).unwrap(), [19., 22., 43., 50.]);
+    }
+
+    #[test]
+    fn with_buffer_sets() {
+        let model_data = include_bytes!("../../ort-cpp/test-models/matmul.onnx");
+        let mut engine = OrtInferenceEngine::new(model_data).unwrap();
+
+        let inputs = [
+            [1., 2., 3., 4.],
+            [5., 6., 7., 8.],
+            [1., 0., 0., 1.],
+            [5., 6., 7., 9.],
+        ];
+        let mut outputs = [[0.; 4]; 2];
+        let [first_output, second_output] = &mut outputs;
+
+        // The buffers outlive the engine's runs and are only read back once they finished.
+        let (first, second) = unsafe {
+            (
+                engine
+                    .register_buffer_set(&[&inputs[0], &inputs[1]], &mut [first_output])
+                    .unwrap(),
+                engine
+                    .register_buffer_set(&[&inputs[2], &inputs[3]], &mut [second_output])
+                    .unwrap(),
+            )
+        };
+        assert!(engine.select_buffer_set(3).is_err());
+
+        engine.select_buffer_set(first).unwrap();
+        engine.run().unwrap();
+        engine.select_buffer_set(second).unwrap();
+        engine.run().unwrap();
+
+        assert_eq!(outputs, [[19., 22., 43., 50.], [5., 6., 7., 9.]]);
+    }
+
+    #[test]
+    fn warmup() {
+        let model_data = include_bytes!("../../ort-cpp/test-models/matmul_dynamic.onnx");
+        let mut engine = OrtInferenceEngine::new(model_data).unwrap();
+
+        assert!(engine.warmup(&[&[&[2, 1]]], 1).is_err());
+
+        let timings = engine
+            .warmup(&[&[&[2, 1], &[1, 2]], &[&[3, 1], &[1, 3]]], 2)
+            .unwrap();
+        assert_eq!(timings.len(), 2);
+        assert!(timings.iter().all(|timing| !timing.first_run.is_zero()));
+        assert_eq!(engine.input_shapes().collect::<Vec<_>>(), [[3, 1], [1, 3]]);
+    }
+
+    #[test]
+    fn stats() {
+        let model_data = include_bytes!("../../ort-cpp/test-models/matmul.onnx");
+        assert!(OrtInferenceEngine::new(model_data)
+            .unwrap()
+            .stats()
+            .is_err());
+
+        let options = EngineOptions {
+            enable_stats: true,
+            ..Default::default()
+        };
+        let mut engine = OrtInferenceEngine::with_options(model_data, &options).unwrap();
+
+        let input_data = [[1., 2., 3., 4.], [5., 6., 7., 8.]];
+        let input_data = input_data.iter().map(|v| v.as_slice()).collect::<Vec<_>>();
+        engine.set_input_data_all(&input_data).unwrap();
+        engine.run().unwrap();
+        engine.run().unwrap();
+
+        let stats = engine.stats().unwrap();
+        assert_eq!(stats.run_count, 2);
+        assert!(stats.run_time_min <= stats.run_time_max);
+        assert_eq!(stats.bytes_bound, 32);
+
+        engine.reset_stats().unwrap();
+        assert_eq!(engine.stats().unwrap().run_count, 0);
+    }
+
+    #[test]
+    fn profiling() {
+        let options = EngineOptions {
+            enable_profiling: true,
+            ..Default::default()
+        };
+        let model_path =
+            Path::new(env!("CARGO_MANIFEST_DIR")).join("../ort-cpp/test-models/matmul.onnx");
+        let mut engine = OrtInferenceEngine::from_file(model_path, &options).unwrap();
+        assert!(engine.stop_profiling().is_err());
+
+        engine.start_profiling().unwrap();
+        engine.run().unwrap();
+
+        let trace = engine.stop_profiling().unwrap();
+        assert_eq!(trace.engine, "onnxruntime");
+        assert_eq!(trace.model, "matmul.onnx");
+        assert_eq!(trace.events.len(), 1);
+        assert_eq!(trace.events[0].op_type, "MatMul");
+
+        let file_path = std::env::temp_dir().join("inference_engine_ort_rs_trace.json");
+        write_chrome_trace(&file_path, &[trace]).unwrap();
+        assert!(std::fs::read_to_string(&file_path)
+            .unwrap()
+            .contains("onnxruntime: matmul.onnx"));
+        std::fs::remove_file(file_path).unwrap();
+    }
+
+    #[test]
+    fn run_async() {
+        let model_data = include_bytes!("../../ort-cpp/test-models/matmul.onnx");
+        let options = EngineOptions {
+            intra_op_num_threads: 2,
+            ..Default::default()
+        };
+        let mut engine = OrtInferenceEngine::with_options(model_data, &options).unwrap();
+
+        let input_data = [[1., 2., 3., 4.], [5., 6., 7., 8.]];
+        let input_data = input_data.iter().map(|v| v.as_slice()).collect::<Vec<_>>();
+        engine.set_input_data_all(&input_data).unwrap();
+
+        futures::executor::block_on(unsafe { engine.run_async() }).unwrap();
+        assert_eq!(engine.output_data(0).unwrap(), [19., 22., 43., 50.]);
+    }
+
     #[test]
     fn with_dynamic_shape_model() {
         let model_data = include_bytes!("../../ort-cpp/test-models/matmul_dynamic.onnx");
         let mut engine = OrtInferenceEngine::new(model_data).unwrap();
 
-        assert_eq!(engine.input_shapes(), [[0, 0], [0, 0]]);
-        assert_eq!(engine.output_shapes(), [[0, 0]]);
+        assert_eq!(engine.input_shapes().collect::<Vec<_>>(), [[0, 0], [0, 0]]);
+        assert_eq!(engine.output_shapes().collect::<Vec<_>>(), [[0, 0]]);
 
         engine.set_input_shapes(&[&[2, 1], &[1, 2]]).unwrap();
-        assert_eq!(engine.input_shapes(), [[2, 1], [1, 2]]);
+        assert_eq!(engine.input_shapes().collect::<Vec<_>>(), [[2, 1], [1, 2]]);
 
         engine.set_output_shapes(&[&[2, 2]]).unwrap();
-        assert_eq!(engine.output_shapes(), [[2, 2]]);
+        assert_eq!(engine.output_shapes().collect::<Vec<_>>(), [[2, 2]]);
 
         let input_data = [[1., 2.], [3., 4.]];
         let input_data = input_data.iter().map(|v| v.as_slice()).collect::<Vec<_>>();
         engine.set_input_data_all(&input_data).unwrap();
         engine
             .input_data_all()
-            .iter()
+            .unwrap()
             .zip(input_data.iter())
             .for_each(|(a, b)| {
                 assert_eq!(a.as_ptr(), b.as_ptr() as _);
@@ -114,7 +366,7 @@ mod tests {
         engine.set_output_data_all(&mut output_data).unwrap();
         engine
             .output_data_all()
-            .iter()
+            .unwrap()
             .zip(output_data.iter())
             .for_each(|(a, b)| {
                 assert_eq!(a.as_ptr(), b.as_ptr() as _);
@@ -123,4 +375,38 @@ mod tests {
         engine.run().unwrap();
         assert_eq!(output_data, [[3., 4., 6., 8.]]);
     }
+
+    #[test]
+    fn with_allocation_free_frame_loop() {
+        let model_data = include_bytes!("../../ort-cpp/test-models/matmul_dynamic.onnx");
+        let mut engine = OrtInferenceEngine::new(model_data).unwrap();
+        let input_shapes: [&[usize]; 2] = [&[2, 1], &[1, 2]];
+
+        // Allocations of the backend go through its own allocator, so every frame is checked, including the first.
+        for _ in 0..4 {
+            let allocation_count = ALLOCATION_COUNT.with(Cell::get);
+
+            engine.set_input_shapes(&input_shapes).unwrap();
+            engine.set_output_shapes(&[&[2, 2]]).unwrap();
+            let shapes_match = engine.input_shapes().eq(input_shapes);
+
+            let [a, b] = engine.input_data_array().unwrap();
+            a.copy_from_slice(&[1., 2.]);
+            b.copy_from_slice(&[3., 4.]);
+            engine
+                .input_data_all()
+                .unwrap()
+                .for_each(|data| data.iter_mut().for_each(|v| *v *= 2.));
+
+            engine.run().unwrap();
+            let [output] = engine.output_data_array().unwrap();
+            let output_matches = output == [12., 16., 24., 32.];
+            let output_count = engine.output_data_all().unwrap().count();
+
+            assert_eq!(ALLOCATION_COUNT.with(Cell::get), allocation_count);
+            assert!(shapes_match);
+            assert!(output_matches);
+            assert_eq!(output_count, 1);
+        }
+    }
 }
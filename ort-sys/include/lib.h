@@ -7,6 +7,8 @@ extern "C"
 {
 #endif
     InferenceEngineResultCode inference_engine_ort__create_inference_engine(const void *model_data, size_t model_data_size_bytes, void **engine);
+    InferenceEngineResultCode inference_engine_ort__create_inference_engine_with_options(const void *model_data, size_t model_data_size_bytes, const InferenceEngineOptions *options, void **engine);
+    InferenceEngineResultCode inference_engine_ort__create_inference_engine_from_file(const char *model_path, const InferenceEngineOptions *options, void **engine);
 #ifdef __cplusplus
 }
 #endif
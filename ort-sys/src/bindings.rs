@@ -9,3 +9,18 @@ extern "C" {
         engine: *mut *mut ::std::os::raw::c_void,
     ) -> InferenceEngineResultCode;
 }
+extern "C" {
+    pub fn inference_engine_ort__create_inference_engine_with_options(
+        model_data: *const ::std::os::raw::c_void,
+        model_data_size_bytes: usize,
+        options: *const InferenceEngineOptions,
+        engine: *mut *mut ::std::os::raw::c_void,
+    ) -> InferenceEngineResultCode;
+}
+extern "C" {
+    pub fn inference_engine_ort__create_inference_engine_from_file(
+        model_path: *const ::std::os::raw::c_char,
+        options: *const InferenceEngineOptions,
+        engine: *mut *mut ::std::os::raw::c_void,
+    ) -> InferenceEngineResultCode;
+}
@@ -1,6 +1,7 @@
 #include "lib.h"
 
 #include <inference_engine/OrtInferenceEngine.hpp>
+#include <lib_core.hpp>
 
 InferenceEngineResultCode inference_engine_ort__create_inference_engine(const void *model_data, size_t model_data_size_bytes, void **engine)
 {
@@ -15,3 +16,31 @@ InferenceEngineResultCode inference_engine_ort__create_inference_engine(const vo
         return InferenceEngineResultCode::Error;
     }
 }
+
+InferenceEngineResultCode inference_engine_ort__create_inference_engine_with_options(const void *model_data, size_t model_data_size_bytes, const InferenceEngineOptions *options, void **engine)
+{
+    try
+    {
+        *engine = new inference_engine::OrtInferenceEngine(model_data, model_data_size_bytes, inference_engine::to_engine_options(options));
+        return InferenceEngineResultCode::Ok;
+    }
+    catch (const std::exception &e)
+    {
+        inference_engine__update_last_error_message(e.what());
+        return InferenceEngineResultCode::Error;
+    }
+}
+
+InferenceEngineResultCode inference_engine_ort__create_inference_engine_from_file(const char *model_path, const InferenceEngineOptions *options, void **engine)
+{
+    try
+    {
+        *engine = new inference_engine::OrtInferenceEngine(std::filesystem::u8path(model_path), inference_engine::to_engine_options(options));
+        return InferenceEngineResultCode::Ok;
+    }
+    catch (const std::exception &e)
+    {
+        inference_engine__update_last_error_message(e.what());
+        return InferenceEngineResultCode::Error;
+    }
+}
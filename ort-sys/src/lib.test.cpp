@@ -2,8 +2,76 @@
 
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/matchers/catch_matchers_exception.hpp>
+#include <algorithm>
+#include <cstdlib>
 #include <filesystem>
 #include <fstream>
+#include <new>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+// Counts the allocations of each thread, so that those of backend worker threads are left out.
+thread_local size_t allocation_count = 0;
+
+void *operator new(size_t size)
+{
+    allocation_count++;
+
+    if (auto data = std::malloc(size > 0 ? size : 1))
+    {
+        return data;
+    }
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void *data) noexcept
+{
+    std::free(data);
+}
+
+void operator delete(void *data, size_t) noexcept
+{
+    std::free(data);
+}
+
+// Engine-owned buffers come from aligned allocations, which the operators above do not see.
+void *operator new(size_t size, std::align_val_t alignment)
+{
+    allocation_count++;
+
+    auto align = static_cast<size_t>(alignment);
+    size = (std::max<size_t>(size, 1) + align - 1) / align * align;
+
+#ifdef _WIN32
+    auto data = _aligned_malloc(size, align);
+#else
+    auto data = std::aligned_alloc(align, size);
+#endif
+
+    if (data)
+    {
+        return data;
+    }
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void *data, std::align_val_t) noexcept
+{
+#ifdef _WIN32
+    _aligned_free(data);
+#else
+    std::free(data);
+#endif
+}
+
+void operator delete(void *data, size_t, std::align_val_t alignment) noexcept
+{
+    operator delete(data, alignment);
+}
 
 std::vector<std::byte> read_file(const std::filesystem::path &file_path)
 {
@@ -88,6 +156,25 @@ struct Engine
     }
 };
 
+TEST_CASE("OrtInferenceEngine with default options")
+{
+    auto model = read_file("../ort-cpp/test-models/matmul.onnx");
+
+    InferenceEngineOptions options;
+    inference_engine__get_default_options(&options);
+    REQUIRE(options.intra_op_num_threads == 1);
+    REQUIRE(options.optimization_level == InferenceEngineOptimizationLevel::All);
+    REQUIRE(options.shape_cache_capacity == 1);
+    REQUIRE(options.numa_node == -1);
+    REQUIRE(options.allow_spinning);
+    REQUIRE(options.optimized_model_cache_dir == nullptr);
+    REQUIRE(options.intra_op_thread_affinity_count == 0);
+
+    Engine engine;
+    unwrap(inference_engine_ort__create_inference_engine_with_options(model.data(), model.size(), &options, &engine.ptr));
+    REQUIRE(inference_engine__get_input_count(engine.ptr) == 2);
+}
+
 TEST_CASE("OrtInferenceEngine with invalid model data")
 {
     REQUIRE_THROWS_WITH(
@@ -135,3 +222,44 @@ TEST_CASE("OrtInferenceEngine with dynamic-shape model")
 
     engine.destroy();
 }
+
+TEST_CASE("OrtInferenceEngine with allocation-free frame loop")
+{
+    auto model = read_file("../ort-cpp/test-models/matmul_dynamic.onnx");
+
+    Engine engine;
+    unwrap(inference_engine_ort__create_inference_engine(model.data(), model.size(), &engine.ptr));
+
+    std::vector<std::vector<size_t>> input_shapes{{2, 1}, {1, 2}};
+    std::vector<const size_t *> input_shape_data{input_shapes[0].data(), input_shapes[1].data()};
+    std::vector<size_t> input_shape_sizes{2, 2};
+    std::vector<size_t> output_shape{2, 2};
+    std::vector<std::vector<float>> inputs{{1, 2}, {3, 4}};
+
+    // The first frame reshapes and allocates the engine-owned buffers.
+    for (auto frame = 0; frame < 4; frame++)
+    {
+        auto previous_allocation_count = allocation_count;
+
+        unwrap(inference_engine__set_input_shapes(engine.ptr, input_shape_data.data(), input_shape_sizes.data(), input_shapes.size()));
+
+        for (auto i = 0; i < input_shapes.size(); i++)
+        {
+            unwrap(inference_engine__set_input_shape(engine.ptr, i, input_shapes[i].data(), input_shapes[i].size()));
+            std::copy(inputs[i].begin(), inputs[i].end(), inference_engine__get_input_data(engine.ptr, i));
+        }
+
+        unwrap(inference_engine__set_output_shape(engine.ptr, 0, output_shape.data(), output_shape.size()));
+        auto output = inference_engine__get_output_data(engine.ptr, 0);
+        auto frame_allocation_count = allocation_count - previous_allocation_count;
+
+        // Allocations inside the backend's run are out of the bindings' control.
+        unwrap(inference_engine__run(engine.ptr));
+        REQUIRE(std::vector<float>(output, output + 4) == std::vector<float>{3, 4, 6, 8});
+
+        if (frame > 0)
+        {
+            REQUIRE(frame_allocation_count == 0);
+        }
+    }
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "inference_engine/EngineOptions.hpp"
+#include "inference_engine/EnginePool.hpp"
+#include "inference_engine/TfLiteInferenceEngine.hpp"
+
+#include <filesystem>
+#include <memory>
+
+namespace inference_engine
+{
+class TfLiteEnginePool : public EnginePool
+{
+public:
+    TfLiteEnginePool(const void *model_data, size_t model_data_size_bytes, const EngineOptions &options = {}, size_t capacity = 0);
+    TfLiteEnginePool(const std::filesystem::path &model_path, const EngineOptions &options = {}, size_t capacity = 0);
+
+protected:
+    std::unique_ptr<InferenceEngine> create_engine() override;
+
+private:
+    std::shared_ptr<TfLiteInferenceEngine::Model> model;
+};
+} // namespace inference_engine
@@ -0,0 +1,21 @@
+#include "inference_engine/TfLiteEnginePool.hpp"
+
+namespace inference_engine
+{
+TfLiteEnginePool::TfLiteEnginePool(const void *model_data, size_t model_data_size_bytes, const EngineOptions &options, size_t capacity)
+    : EnginePool(capacity)
+    , model(TfLiteInferenceEngine::load_model(model_data, model_data_size_bytes, options))
+{
+}
+
+TfLiteEnginePool::TfLiteEnginePool(const std::filesystem::path &model_path, const EngineOptions &options, size_t capacity)
+    : EnginePool(capacity)
+    , model(TfLiteInferenceEngine::load_model(model_path, options))
+{
+}
+
+std::unique_ptr<InferenceEngine> TfLiteEnginePool::create_engine()
+{
+    return std::unique_ptr<InferenceEngine>(new TfLiteInferenceEngine(model));
+}
+} // namespace inference_engine
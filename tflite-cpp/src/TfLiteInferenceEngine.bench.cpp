@@ -0,0 +1,63 @@
+#include "inference_engine/TfLiteInferenceEngine.hpp"
+
+#include "Benchmark.hpp"
+
+#include <fstream>
+#include <iostream>
+
+using namespace inference_engine;
+
+// Input shapes of the models written by test-model-generator/bench.py, by the model family their names start with.
+// Output shapes are inferred by the interpreter.
+bench::Case make_case(const std::filesystem::path &model_path)
+{
+    auto name = model_path.stem().string();
+    auto family = name.substr(0, name.find('_'));
+
+    if (family == "conv")
+    {
+        return {model_path, {{{1, 32, 32, 3}}, {{4, 32, 32, 3}}}};
+    }
+
+    if (family == "lstm")
+    {
+        return {model_path, {{{1, 16, 32}}, {{1, 64, 32}}}};
+    }
+
+    if (family == "transformer")
+    {
+        return {model_path, {{{1, 16, 32}}, {{1, 64, 32}}}};
+    }
+
+    throw std::runtime_error("unknown benchmark model: " + model_path.string());
+}
+
+int main(int argc, char **argv)
+{
+    try
+    {
+        auto options = bench::parse_options(argc, argv);
+        auto benchmark = bench::Benchmark(
+            "tflite",
+            [](const std::filesystem::path &model_path) { return std::make_unique<TfLiteInferenceEngine>(model_path); },
+            options
+        );
+
+        for (const auto &model_path : bench::find_models(options.model_paths, ".tflite"))
+        {
+            benchmark.run(make_case(model_path));
+        }
+
+        benchmark.print(std::cout);
+
+        std::ofstream ofs(options.output_path);
+        benchmark.write_json(ofs);
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
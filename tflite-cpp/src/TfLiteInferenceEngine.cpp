@@ -1,8 +1,23 @@
 #include "inference_engine/TfLiteInferenceEngine.hpp"
 
+#include "inference_engine/BufferArena.hpp"
+#include "inference_engine/CpuPlacement.hpp"
+#include "inference_engine/EngineStats.hpp"
+#include "inference_engine/MappedFile.hpp"
+#include "inference_engine/Quantization.hpp"
+#include "inference_engine/Worker.hpp"
+
+#include <tensorflow/lite/delegates/xnnpack/xnnpack_delegate.h>
 #include <tensorflow/lite/interpreter.h>
 #include <tensorflow/lite/kernels/register.h>
 #include <tensorflow/lite/model.h>
+#include <tensorflow/lite/profiling/buffered_profiler.h>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <list>
+#include <mutex>
+#include <string>
 #include <vector>
 
 namespace inference_engine
@@ -87,11 +102,110 @@ private:
     }
 };
 
-class TfLiteInferenceEngine::Impl
+ElementType to_element_type(TfLiteType type)
+{
+    switch (type)
+    {
+    case kTfLiteFloat32:
+        return ElementType::Float32;
+    case kTfLiteFloat16:
+        return ElementType::Float16;
+    case kTfLiteInt8:
+        return ElementType::Int8;
+    case kTfLiteUInt8:
+        return ElementType::Uint8;
+    case kTfLiteInt16:
+        return ElementType::Int16;
+    case kTfLiteInt32:
+        return ElementType::Int32;
+    case kTfLiteInt64:
+        return ElementType::Int64;
+    case kTfLiteBool:
+        return ElementType::Bool;
+    default:
+        throw std::runtime_error("unsupported tensor element type");
+    }
+}
+
+bool is_quantized(const TfLiteTensor *tensor)
+{
+    return (tensor->type == kTfLiteInt8 || tensor->type == kTfLiteUInt8) && tensor->params.scale != 0;
+}
+
+QuantizationParams get_quantization(const TfLiteTensor *tensor)
+{
+    return {tensor->params.scale, tensor->params.zero_point};
+}
+
+// XNNPACK kernels may read up to XNN_EXTRA_BYTES past the end of their inputs.
+constexpr size_t xnnpack_extra_bytes = 16;
+
+class TfLiteInferenceEngine::Model
 {
 public:
-    Impl(const void *model_data, size_t model_data_size_bytes)
+    Model(const void *model_data, size_t model_data_size_bytes, const EngineOptions &options)
+        : Model(nullptr, model_data, model_data_size_bytes, options)
+    {
+    }
+
+    Model(const std::filesystem::path &model_path, const EngineOptions &options)
+        : Model(std::make_shared<MappedFile>(model_path), options)
+    {
+        name = model_path.filename().string();
+    }
+
+    Model(std::shared_ptr<const MappedFile> mapped_file, const EngineOptions &options)
+        : Model(mapped_file, mapped_file->data(), mapped_file->size(), options)
     {
+    }
+
+    Model(std::shared_ptr<const MappedFile> mapped_file, const void *model_data, size_t model_data_size_bytes, const EngineOptions &options)
+        : use_float_io(options.use_float_io)
+        , shape_cache_capacity(std::max<size_t>(options.shape_cache_capacity, 1))
+        , use_xnnpack(options.use_xnnpack)
+        , enable_stats(options.enable_stats)
+        , enable_profiling(options.enable_profiling)
+        , numa_node(options.numa_node)
+        , data_size(model_data_size_bytes)
+        , mapped_file(mapped_file)
+        , num_threads(options.intra_op_num_threads > 0 ? static_cast<int>(options.intra_op_num_threads) : -1)
+        , xnnpack_options(create_xnnpack_options(options))
+        , xnnpack_cores(get_cores(options.intra_op_thread_affinities))
+        , weights_cache(nullptr, TfLiteXNNPackDelegateWeightsCacheDelete)
+    {
+        // Only the threads of the XNNPACK delegate can be placed, and TFLite threads always spin.
+        if (!options.intra_op_thread_affinities.empty() && !use_xnnpack)
+        {
+            throw std::runtime_error("intra-op thread affinities are not supported without XNNPACK");
+        }
+
+        if (!options.allow_spinning)
+        {
+            throw std::runtime_error("disabling spinning is not supported by TFLite");
+        }
+
+        if (numa_node >= 0 && mapped_file)
+        {
+            bind_to_numa_node(mapped_file->data(), mapped_file->size(), numa_node);
+        }
+
+        if (use_xnnpack)
+        {
+            op_resolver = std::make_unique<tflite::ops::builtin::BuiltinOpResolverWithoutDefaultDelegates>();
+            weights_cache.reset(TfLiteXNNPackDelegateWeightsCacheCreate());
+
+            if (!weights_cache)
+            {
+                throw std::runtime_error("failed to create the XNNPACK weights cache");
+            }
+
+            xnnpack_options.weights_cache = weights_cache.get();
+        }
+        else
+        {
+            op_resolver = std::make_unique<tflite::ops::builtin::BuiltinOpResolver>();
+        }
+
         model = tflite::FlatBufferModel::BuildFromBuffer(
             static_cast<const char *>(model_data),
             model_data_size_bytes
@@ -101,54 +215,374 @@ public:
         {
             throw std::runtime_error("failed to load model");
         }
+    }
 
-        tflite::ops::builtin::BuiltinOpResolver op_resolver;
-        tflite::InterpreterBuilder builder(*model, op_resolver);
+    // Inputs are resized before the delegate is applied, so that delegated graphs never need to be resized.
+    // Empty shapes keep the ones of the model.
+    std::unique_ptr<tflite::Interpreter> build_interpreter(const std::vector<std::vector<size_t>> &input_shapes)
+    {
+        tflite::InterpreterBuilder builder(*model, *op_resolver);
 
-        if (builder.SetNumThreads(1) != kTfLiteOk)
+        if (builder.SetNumThreads(num_threads) != kTfLiteOk)
         {
             throw std::runtime_error("failed to set the number of CPU threads");
         }
 
+        std::unique_ptr<tflite::Interpreter> interpreter;
+
         if (builder(&interpreter) != kTfLiteOk)
         {
             throw std::runtime_error("failed to build the interpreter");
         }
 
-        input_count = interpreter->inputs().size();
-        output_count = interpreter->outputs().size();
+        for (auto i = 0; i < input_shapes.size(); i++)
+        {
+            if (interpreter->ResizeInputTensor(interpreter->inputs()[i], {input_shapes[i].begin(), input_shapes[i].end()}) != kTfLiteOk)
+            {
+                throw std::runtime_error("failed to resize input tensor");
+            }
+        }
 
-        for (auto i = 0; i < input_count; i++)
+        if (use_xnnpack)
         {
-            interpreter->input_tensor(i)->allocation_type = kTfLiteCustom;
+            apply_xnnpack(*interpreter);
         }
 
-        for (auto i = 0; i < output_count; i++)
+        return interpreter;
+    }
+
+    const bool use_float_io;
+    const size_t shape_cache_capacity;
+    const bool use_xnnpack;
+    const bool enable_stats;
+    const bool enable_profiling;
+    const int numa_node;
+    const size_t data_size;
+
+    // File name of the model, empty when created from memory.
+    std::string name;
+
+private:
+    std::shared_ptr<const MappedFile> mapped_file;
+    std::unique_ptr<tflite::FlatBufferModel> model;
+    std::unique_ptr<tflite::OpResolver> op_resolver;
+    const int num_threads;
+
+    TfLiteXNNPackDelegateOptions xnnpack_options;
+
+    // The XNNPACK delegate creates its threads right away, so they inherit the cores of the thread creating it.
+    const std::vector<size_t> xnnpack_cores;
+
+    // Outlives the interpreters of all engines, which own the delegates reading from it.
+    std::unique_ptr<TfLiteXNNPackDelegateWeightsCache, decltype(&TfLiteXNNPackDelegateWeightsCacheDelete)> weights_cache;
+    bool is_weights_cache_finalized = false;
+    std::mutex weights_cache_mutex;
+
+    static TfLiteXNNPackDelegateOptions create_xnnpack_options(const EngineOptions &options)
+    {
+        auto xnnpack_options = TfLiteXNNPackDelegateOptionsDefault();
+        auto num_threads = options.xnnpack_num_threads > 0 ? options.xnnpack_num_threads : options.intra_op_num_threads;
+
+        if (num_threads > 0)
         {
-            interpreter->output_tensor(i)->allocation_type = kTfLiteCustom;
+            xnnpack_options.num_threads = static_cast<int32_t>(num_threads);
         }
 
-        if (interpreter->AllocateTensors() != kTfLiteOk)
+        if (options.xnnpack_enable_quantized)
+        {
+            xnnpack_options.flags |= TFLITE_XNNPACK_DELEGATE_FLAG_QS8 | TFLITE_XNNPACK_DELEGATE_FLAG_QU8;
+        }
+        else
+        {
+            xnnpack_options.flags &= ~(TFLITE_XNNPACK_DELEGATE_FLAG_QS8 | TFLITE_XNNPACK_DELEGATE_FLAG_QU8);
+        }
+
+        if (options.xnnpack_force_fp16)
+        {
+            xnnpack_options.flags |= TFLITE_XNNPACK_DELEGATE_FLAG_FORCE_FP16;
+        }
+
+        return xnnpack_options;
+    }
+
+    static std::vector<size_t> get_cores(const std::vector<std::vector<size_t>> &thread_affinities)
+    {
+        std::vector<size_t> cores;
+
+        for (const auto &thread_cores : thread_affinities)
+        {
+            cores.insert(cores.end(), thread_cores.begin(), thread_cores.end());
+        }
+
+        std::sort(cores.begin(), cores.end());
+        cores.erase(std::unique(cores.begin(), cores.end()), cores.end());
+        return cores;
+    }
+
+    // The first delegate packs the weights into the cache. The cache is then finalized softly, so that the delegates
+    // of later interpreters look packed weights up instead of packing them again.
+    void apply_xnnpack(tflite::Interpreter &interpreter)
+    {
+        std::lock_guard<std::mutex> lock(weights_cache_mutex);
+
+        tflite::Interpreter::TfLiteDelegatePtr delegate(nullptr, TfLiteXNNPackDelegateDelete);
+
+        {
+            ThreadAffinityScope affinity_scope(xnnpack_cores);
+            delegate.reset(TfLiteXNNPackDelegateCreate(&xnnpack_options));
+        }
+
+        if (!delegate)
+        {
+            throw std::runtime_error("failed to create the XNNPACK delegate");
+        }
+
+        if (interpreter.ModifyGraphWithDelegate(std::move(delegate)) != kTfLiteOk)
+        {
+            throw std::runtime_error("failed to apply the XNNPACK delegate");
+        }
+
+        if (!is_weights_cache_finalized)
+        {
+            if (!TfLiteXNNPackDelegateWeightsCacheFinalizeSoft(weights_cache.get()))
+            {
+                throw std::runtime_error("failed to finalize the XNNPACK weights cache");
+            }
+
+            is_weights_cache_finalized = true;
+        }
+    }
+};
+
+// An interpreter allocated for one combination of input shapes, together with the layout of the engine-owned buffers
+// of its input and output tensors.
+class InterpreterState
+{
+public:
+    InterpreterState(std::unique_ptr<tflite::Interpreter> interpreter, const std::vector<bool> &is_input_converted, const std::vector<bool> &is_output_converted)
+        : interpreter(std::move(interpreter))
+        , is_input_converted(is_input_converted)
+        , is_output_converted(is_output_converted)
+    {
+        for (auto i = 0; i < is_input_converted.size(); i++)
+        {
+            this->interpreter->input_tensor(i)->allocation_type = kTfLiteCustom;
+        }
+
+        for (auto i = 0; i < is_output_converted.size(); i++)
+        {
+            this->interpreter->output_tensor(i)->allocation_type = kTfLiteCustom;
+        }
+
+        if (this->interpreter->AllocateTensors() != kTfLiteOk)
         {
             throw std::runtime_error("failed to allocate tensor buffers");
         }
 
-        for (auto i = 0; i < input_count; i++)
+        input_float_ptrs.resize(is_input_converted.size());
+        output_float_ptrs.resize(is_output_converted.size());
+
+        update_layout();
+    }
+
+    bool has_input_shapes(Span<const Span<const size_t>> shapes) const
+    {
+        for (auto i = 0; i < input_shapes.size(); i++)
+        {
+            if (shapes[i] != input_shapes[i])
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    void set_input_shapes(const std::vector<std::vector<size_t>> &shapes)
+    {
+        std::vector<std::vector<size_t>> previous_shapes;
+
+        for (auto &shape : input_shapes)
+        {
+            previous_shapes.push_back(shape);
+        }
+
+        try
+        {
+            resize_inputs(shapes);
+        }
+        catch (...)
+        {
+            // Keep the state usable for the shapes it was allocated for.
+            try
+            {
+                resize_inputs(previous_shapes);
+            }
+            catch (...)
+            {
+            }
+
+            throw;
+        }
+
+        update_layout();
+    }
+
+    // Carves the engine-owned buffers from the arena and points all tensors at them.
+    void bind_buffers(BufferArena &arena)
+    {
+        arena.allocate(buffer_sizes, buffers);
+
+        for (auto i = 0; i < input_shapes.size(); i++)
+        {
+            interpreter->input_tensor(i)->data.data = get_input_buffer(i);
+            input_float_ptrs[i] = get_input_float_buffer(i);
+        }
+
+        for (auto i = 0; i < output_shapes.size(); i++)
+        {
+            interpreter->output_tensor(i)->data.data = get_output_buffer(i);
+            output_float_ptrs[i] = get_output_float_buffer(i);
+        }
+    }
+
+    std::byte *get_input_buffer(size_t index) const
+    {
+        return buffers[index];
+    }
+
+    std::byte *get_output_buffer(size_t index) const
+    {
+        return buffers[input_shapes.size() + index];
+    }
+
+    // Float-facing buffers of quantized tensors that are converted on every run.
+    float *get_input_float_buffer(size_t index) const
+    {
+        return reinterpret_cast<float *>(buffers[input_shapes.size() + output_shapes.size() + index]);
+    }
+
+    float *get_output_float_buffer(size_t index) const
+    {
+        return reinterpret_cast<float *>(buffers[2 * input_shapes.size() + output_shapes.size() + index]);
+    }
+
+    std::unique_ptr<tflite::Interpreter> interpreter;
+
+    std::vector<Shape> input_shapes;
+    std::vector<Shape> output_shapes;
+
+    std::vector<float *> input_float_ptrs;
+    std::vector<float *> output_float_ptrs;
+
+private:
+    void resize_inputs(const std::vector<std::vector<size_t>> &shapes)
+    {
+        for (auto i = 0; i < shapes.size(); i++)
+        {
+            if (interpreter->ResizeInputTensor(interpreter->inputs()[i], {shapes[i].begin(), shapes[i].end()}) != kTfLiteOk)
+            {
+                throw std::runtime_error("failed to resize input tensor");
+            }
+        }
+
+        if (interpreter->AllocateTensors() != kTfLiteOk)
+        {
+            throw std::runtime_error("failed to allocate tensor buffers for resized input tensor");
+        }
+    }
+
+    // Buffers are laid out as inputs, outputs, float inputs and float outputs.
+    void update_layout()
+    {
+        input_shapes.clear();
+        output_shapes.clear();
+        buffer_sizes.clear();
+
+        for (auto i = 0; i < is_input_converted.size(); i++)
         {
             auto tensor = interpreter->input_tensor(i);
             auto dims = tensor->dims;
             input_shapes.emplace_back(dims->data, dims->size);
-            input_data.emplace_back(new float[input_shapes[i].get_element_count()]);
-            tensor->data.data = input_data[i].get();
+            buffer_sizes.push_back(input_shapes[i].get_element_count() * get_element_size(to_element_type(tensor->type)));
         }
 
-        for (auto i = 0; i < output_count; i++)
+        for (auto i = 0; i < is_output_converted.size(); i++)
         {
             auto tensor = interpreter->output_tensor(i);
             auto dims = tensor->dims;
             output_shapes.emplace_back(dims->data, dims->size);
-            output_data.emplace_back(new float[output_shapes[i].get_element_count()]);
-            tensor->data.data = output_data[i].get();
+            buffer_sizes.push_back(output_shapes[i].get_element_count() * get_element_size(to_element_type(tensor->type)));
+        }
+
+        for (auto i = 0; i < is_input_converted.size(); i++)
+        {
+            buffer_sizes.push_back(is_input_converted[i] ? input_shapes[i].get_element_count() * sizeof(float) : 0);
+        }
+
+        for (auto i = 0; i < is_output_converted.size(); i++)
+        {
+            buffer_sizes.push_back(is_output_converted[i] ? output_shapes[i].get_element_count() * sizeof(float) : 0);
+        }
+    }
+
+    const std::vector<bool> is_input_converted;
+    const std::vector<bool> is_output_converted;
+
+    std::vector<size_t> buffer_sizes;
+    std::vector<std::byte *> buffers;
+};
+
+struct BufferSet
+{
+    std::vector<const void *> inputs;
+    std::vector<void *> outputs;
+    bool is_released = false;
+};
+
+class TfLiteInferenceEngine::Impl
+{
+public:
+    Impl(std::shared_ptr<Model> model)
+        : model(model)
+        , arena(model->numa_node, model->use_xnnpack ? xnnpack_extra_bytes : 0)
+    {
+        NumaNodeScope numa_scope(model->numa_node);
+
+        if (model->enable_profiling)
+        {
+            profiler = std::make_unique<tflite::profiling::BufferedProfiler>(1024, true);
+        }
+
+        auto interpreter = build_interpreter({});
+        input_count = interpreter->inputs().size();
+        output_count = interpreter->outputs().size();
+
+        for (auto i = 0; i < input_count; i++)
+        {
+            auto tensor = interpreter->input_tensor(i);
+            auto is_converted = model->use_float_io && is_quantized(tensor);
+            input_element_types.push_back(is_converted ? ElementType::Float32 : to_element_type(tensor->type));
+            is_input_converted.push_back(is_converted);
+        }
+
+        for (auto i = 0; i < output_count; i++)
+        {
+            auto tensor = interpreter->output_tensor(i);
+            auto is_converted = model->use_float_io && is_quantized(tensor);
+            output_element_types.push_back(is_converted ? ElementType::Float32 : to_element_type(tensor->type));
+            is_output_converted.push_back(is_converted);
+        }
+
+        states.emplace_front(std::move(interpreter), is_input_converted, is_output_converted);
+        state = &states.front();
+        state->bind_buffers(arena);
+
+        buffer_sets.push_back({std::vector<const void *>(input_count), std::vector<void *>(output_count)});
+
+        if (model->enable_stats)
+        {
+            stats = std::make_unique<EngineStatsRecorder>();
         }
     }
 
@@ -164,112 +598,545 @@ public:
 
     const std::vector<size_t> &get_input_shape(size_t index) const
     {
-        return input_shapes[index];
+        return state->input_shapes[index];
     }
 
     const std::vector<size_t> &get_output_shape(size_t index) const
     {
-        return output_shapes[index];
+        return state->output_shapes[index];
     }
 
-    void set_input_shape(size_t index, const std::vector<size_t> &shape)
+    void set_input_shape(size_t index, Span<const size_t> shape)
     {
-        if (interpreter->ResizeInputTensor(interpreter->inputs()[index], {shape.begin(), shape.end()}) != kTfLiteOk)
+        StatsTimer timer(stats.get(), &EngineStatsRecorder::record_reshape);
+
+        if (shape == state->input_shapes[index])
         {
-            throw std::runtime_error("failed to resize input tensor");
+            return;
         }
 
-        if (interpreter->AllocateTensors() != kTfLiteOk)
+        std::vector<Span<const size_t>> shapes(state->input_shapes.begin(), state->input_shapes.end());
+        shapes[index] = shape;
+        activate(shapes);
+    }
+
+    void set_input_shapes(Span<const Span<const size_t>> shapes)
+    {
+        StatsTimer timer(stats.get(), &EngineStatsRecorder::record_reshape);
+        activate(shapes);
+    }
+
+    void set_output_shape(size_t index, Span<const size_t> shape)
+    {
+        throw std::runtime_error("reshape output tensor is not supported");
+    }
+
+    ElementType get_input_element_type(size_t index) const
+    {
+        return input_element_types[index];
+    }
+
+    ElementType get_output_element_type(size_t index) const
+    {
+        return output_element_types[index];
+    }
+
+    QuantizationParams get_input_quantization(size_t index) const
+    {
+        return get_quantization(state->interpreter->input_tensor(index));
+    }
+
+    QuantizationParams get_output_quantization(size_t index) const
+    {
+        return get_quantization(state->interpreter->output_tensor(index));
+    }
+
+    void *get_input_raw_data(size_t index)
+    {
+        if (is_input_converted[index])
         {
-            throw std::runtime_error("failed to allocate tensor buffers for resized input tensor");
+            return state->input_float_ptrs[index];
         }
 
+        return state->interpreter->input_tensor(index)->data.data;
+    }
+
+    const void *get_output_raw_data(size_t index) const
+    {
+        if (is_output_converted[index])
         {
-            auto tensor = interpreter->input_tensor(index);
-            auto dims = tensor->dims;
-            input_shapes.emplace(input_shapes.begin() + index, dims->data, dims->size);
-            input_data[index].reset(new float[input_shapes[index].get_element_count()]);
-            tensor->data.data = input_data[index].get();
+            return state->output_float_ptrs[index];
+        }
+
+        return state->interpreter->output_tensor(index)->data.data;
+    }
+
+    void set_input_raw_data(size_t index, const void *data)
+    {
+        if (stats && data)
+        {
+            stats->record_binding(state->input_shapes[index].get_element_count() * get_element_size(input_element_types[index]));
+        }
+
+        buffer_sets[selected_buffer_set].inputs[index] = data;
+        bind_input(index, data);
+    }
+
+    void set_output_raw_data(size_t index, void *data)
+    {
+        if (stats && data)
+        {
+            stats->record_binding(state->output_shapes[index].get_element_count() * get_element_size(output_element_types[index]));
+        }
+
+        buffer_sets[selected_buffer_set].outputs[index] = data;
+        bind_output(index, data);
+    }
+
+    size_t register_buffer_set(const std::vector<const void *> &inputs, const std::vector<void *> &outputs)
+    {
+        if (inputs.size() != input_count || outputs.size() != output_count)
+        {
+            throw std::runtime_error("buffer count mismatch");
+        }
+
+        if (stats)
+        {
+            for (auto i = 0; i < input_count; i++)
+            {
+                if (inputs[i])
+                {
+                    stats->record_binding(state->input_shapes[i].get_element_count() * get_element_size(input_element_types[i]));
+                }
+            }
+
+            for (auto i = 0; i < output_count; i++)
+            {
+                if (outputs[i])
+                {
+                    stats->record_binding(state->output_shapes[i].get_element_count() * get_element_size(output_element_types[i]));
+                }
+            }
+        }
+
+        // Released slots are handed out again before the set list grows.
+        size_t id = 1;
+
+        while (id < buffer_sets.size() && !buffer_sets[id].is_released)
+        {
+            id++;
+        }
+
+        if (id == buffer_sets.size())
+        {
+            buffer_sets.emplace_back();
+        }
+
+        buffer_sets[id] = {inputs, outputs};
+        return id;
+    }
+
+    // The interpreter keeps the data pointers in its tensors, so selecting a set writes one pointer per tensor.
+    void select_buffer_set(size_t id)
+    {
+        if (id >= buffer_sets.size())
+        {
+            throw std::runtime_error("invalid buffer set id");
+        }
+
+        if (buffer_sets[id].is_released)
+        {
+            id = 0;
+        }
+
+        for (auto i = 0; i < input_count; i++)
+        {
+            bind_input(i, buffer_sets[id].inputs[i]);
         }
 
         for (auto i = 0; i < output_count; i++)
         {
-            auto tensor = interpreter->output_tensor(i);
-            auto dims = tensor->dims;
-            output_shapes.emplace(output_shapes.begin() + i, dims->data, dims->size);
-            output_data[i].reset(new float[output_shapes[i].get_element_count()]);
-            tensor->data.data = output_data[i].get();
+            bind_output(i, buffer_sets[id].outputs[i]);
         }
+
+        selected_buffer_set = id;
     }
 
-    void set_output_shape(size_t index, const std::vector<size_t> &shape)
+    void unregister_buffer_set(size_t id)
     {
-        throw std::runtime_error("reshape output tensor is not supported");
+        if (id == 0 || id >= buffer_sets.size())
+        {
+            throw std::runtime_error("invalid buffer set id");
+        }
+
+        if (id == selected_buffer_set)
+        {
+            select_buffer_set(0);
+        }
+
+        buffer_sets[id] = {{}, {}, true};
+    }
+
+    size_t get_buffer_set_count() const
+    {
+        return buffer_sets.size();
+    }
+
+    size_t get_memory_footprint() const
+    {
+        return model->data_size + arena.get_capacity();
     }
 
-    float *get_input_data(size_t index)
+    // With more sets than the shape cache holds, only the last ones stay primed.
+    std::vector<WarmupTiming> warmup(const std::vector<std::vector<std::vector<size_t>>> &shape_sets, size_t iterations)
     {
-        return interpreter->typed_input_tensor<float>(index);
+        std::vector<WarmupTiming> timings;
+
+        for (const auto &shapes : shape_sets)
+        {
+            WarmupTiming timing;
+            auto start = std::chrono::steady_clock::now();
+
+            activate(get_spans(shapes));
+            bind_own_buffers();
+
+            for (auto i = 0; i < input_count; i++)
+            {
+                std::memset(get_input_raw_data(i), 0, state->input_shapes[i].get_element_count() * get_element_size(input_element_types[i]));
+            }
+
+            timing.reshape = std::chrono::steady_clock::now() - start;
+
+            for (auto i = 0; i < iterations; i++)
+            {
+                start = std::chrono::steady_clock::now();
+                invoke();
+                timing.last_run = std::chrono::steady_clock::now() - start;
+
+                if (i == 0)
+                {
+                    timing.first_run = timing.last_run;
+                }
+            }
+
+            timings.push_back(timing);
+        }
+
+        return timings;
     }
 
-    const float *get_output_data(size_t index) const
+    EngineStats get_stats() const
     {
-        return interpreter->typed_output_tensor<float>(index);
+        if (!stats)
+        {
+            throw std::runtime_error("engine stats are disabled");
+        }
+
+        return stats->get_stats();
     }
 
-    void set_input_data(size_t index, const float *data)
+    void reset_stats()
     {
-        if (data)
+        if (!stats)
         {
-            interpreter->input_tensor(index)->data.data = const_cast<float *>(data);
-            input_data[index].reset();
+            throw std::runtime_error("engine stats are disabled");
         }
-        else
+
+        stats->reset();
+    }
+
+    void start_profiling()
+    {
+        if (!profiler)
         {
-            input_data[index].reset(new float[input_shapes[index].get_element_count()]);
-            interpreter->input_tensor(index)->data.data = input_data[index].get();
+            throw std::runtime_error("engine profiling is disabled");
         }
+
+        profiler->Reset();
+        profiler->StartProfiling();
+        is_profiling = true;
     }
 
-    void set_output_data(size_t index, float *data)
+    ProfileTrace stop_profiling()
     {
-        if (data)
+        if (!is_profiling)
         {
-            interpreter->output_tensor(index)->data.data = data;
-            output_data[index].reset();
+            throw std::runtime_error("profiling is not started");
         }
-        else
+
+        profiler->StopProfiling();
+        is_profiling = false;
+
+        ProfileTrace trace{"tflite", model->name, {}};
+
+        for (auto event : profiler->GetProfileEvents())
+        {
+            if (event->event_type != tflite::Profiler::EventType::OPERATOR_INVOKE_EVENT && event->event_type != tflite::Profiler::EventType::DELEGATE_OPERATOR_INVOKE_EVENT)
+            {
+                continue;
+            }
+
+            trace.events.push_back({get_node_name(*event), event->tag, std::chrono::microseconds(event->begin_timestamp_us), std::chrono::microseconds(event->elapsed_time)});
+        }
+
+        if (!trace.events.empty())
         {
-            output_data[index].reset(new float[output_shapes[index].get_element_count()]);
-            interpreter->output_tensor(index)->data.data = output_data[index].get();
+            auto first = std::min_element(trace.events.begin(), trace.events.end(), [](const ProfileEvent &a, const ProfileEvent &b) { return a.start < b.start; })->start;
+
+            for (auto &event : trace.events)
+            {
+                event.start -= first;
+            }
         }
+
+        return trace;
     }
 
     void run()
     {
+        StatsTimer timer(stats.get(), &EngineStatsRecorder::record_run);
+        invoke();
+    }
+
+    void run_async(RunCallback callback)
+    {
+        worker.post([this, callback = std::move(callback)] {
+            std::exception_ptr error;
+
+            try
+            {
+                run();
+            }
+            catch (...)
+            {
+                error = std::current_exception();
+            }
+
+            callback(error);
+        });
+    }
+
+private:
+    std::unique_ptr<tflite::Interpreter> build_interpreter(const std::vector<std::vector<size_t>> &input_shapes) const
+    {
+        auto interpreter = model->build_interpreter(input_shapes);
+
+        if (profiler)
+        {
+            interpreter->SetProfiler(profiler.get());
+        }
+
+        return interpreter;
+    }
+
+    // TFLite nodes have no names, so nodes of the primary subgraph are named after their first output tensor.
+    // Delegated operators are named by their tag.
+    std::string get_node_name(const tflite::profiling::ProfileEvent &event) const
+    {
+        if (event.event_type == tflite::Profiler::EventType::OPERATOR_INVOKE_EVENT && event.extra_event_metadata == 0)
+        {
+            auto node_and_registration = state->interpreter->node_and_registration(static_cast<int>(event.event_metadata));
+
+            if (node_and_registration && node_and_registration->first.outputs->size > 0)
+            {
+                auto tensor = state->interpreter->tensor(node_and_registration->first.outputs->data[0]);
+
+                if (tensor && tensor->name)
+                {
+                    return tensor->name;
+                }
+            }
+        }
+
+        return event.tag;
+    }
+
+    void invoke()
+    {
+        auto interpreter = state->interpreter.get();
+
+        for (auto i = 0; i < input_count; i++)
+        {
+            if (is_input_converted[i])
+            {
+                auto tensor = interpreter->input_tensor(i);
+                auto count = state->input_shapes[i].get_element_count();
+
+                if (tensor->type == kTfLiteInt8)
+                {
+                    quantize(state->input_float_ptrs[i], tensor->data.int8, count, get_quantization(tensor));
+                }
+                else
+                {
+                    quantize(state->input_float_ptrs[i], tensor->data.uint8, count, get_quantization(tensor));
+                }
+            }
+        }
+
         if (interpreter->Invoke() != kTfLiteOk)
         {
             throw std::runtime_error("failed to invoke the interpreter");
         }
+
+        for (auto i = 0; i < output_count; i++)
+        {
+            if (is_output_converted[i])
+            {
+                auto tensor = interpreter->output_tensor(i);
+                auto count = state->output_shapes[i].get_element_count();
+
+                if (tensor->type == kTfLiteInt8)
+                {
+                    dequantize(tensor->data.int8, state->output_float_ptrs[i], count, get_quantization(tensor));
+                }
+                else
+                {
+                    dequantize(tensor->data.uint8, state->output_float_ptrs[i], count, get_quantization(tensor));
+                }
+            }
+        }
     }
 
-private:
-    std::unique_ptr<tflite::FlatBufferModel> model;
-    std::unique_ptr<tflite::Interpreter> interpreter;
+    // Activates the interpreter allocated for the given input shapes, most recently used first. On a miss a new
+    // interpreter is built while the cache has room, otherwise the least recently used one is resized. Delegated
+    // interpreters are replaced instead, with a new delegate and thread pool that only reuse the packed weights.
+    void activate(Span<const Span<const size_t>> shapes)
+    {
+        if (shapes.size() != input_count)
+        {
+            throw std::runtime_error("input shape count mismatch");
+        }
+
+        if (state->has_input_shapes(shapes))
+        {
+            return;
+        }
+
+        NumaNodeScope numa_scope(model->numa_node);
+        auto it = std::find_if(states.begin(), states.end(), [&shapes](const InterpreterState &state) { return state.has_input_shapes(shapes); });
+
+        if (it == states.end())
+        {
+            // The shapes may view those of a state that is about to be replaced or resized.
+            std::vector<std::vector<size_t>> shape_values;
+
+            for (auto shape : shapes)
+            {
+                shape_values.emplace_back(shape.begin(), shape.end());
+            }
+
+            if (states.size() < model->shape_cache_capacity || model->use_xnnpack)
+            {
+                states.emplace_back(build_interpreter(shape_values), is_input_converted, is_output_converted);
+                it = std::prev(states.end());
+
+                if (states.size() > model->shape_cache_capacity)
+                {
+                    states.erase(std::prev(it));
+                }
+            }
+            else
+            {
+                it = std::prev(states.end());
+                it->set_input_shapes(shape_values);
+            }
+        }
+
+        states.splice(states.begin(), states, it);
+        state = &states.front();
+        bind_own_buffers();
+    }
+
+    // Binds the engine-owned buffers of the active interpreter and drops all registered buffer sets.
+    void bind_own_buffers()
+    {
+        state->bind_buffers(arena);
+
+        buffer_sets.resize(1);
+        std::fill(buffer_sets[0].inputs.begin(), buffer_sets[0].inputs.end(), nullptr);
+        std::fill(buffer_sets[0].outputs.begin(), buffer_sets[0].outputs.end(), nullptr);
+        selected_buffer_set = 0;
+    }
+
+    void bind_input(size_t index, const void *data)
+    {
+        if (is_input_converted[index])
+        {
+            state->input_float_ptrs[index] = data ? static_cast<float *>(const_cast<void *>(data)) : state->get_input_float_buffer(index);
+        }
+        else
+        {
+            state->interpreter->input_tensor(index)->data.data = data ? const_cast<void *>(data) : state->get_input_buffer(index);
+        }
+    }
+
+    void bind_output(size_t index, void *data)
+    {
+        if (is_output_converted[index])
+        {
+            state->output_float_ptrs[index] = data ? static_cast<float *>(data) : state->get_output_float_buffer(index);
+        }
+        else
+        {
+            state->interpreter->output_tensor(index)->data.data = data ? data : state->get_output_buffer(index);
+        }
+    }
+
+    std::shared_ptr<Model> model;
 
     size_t input_count;
     size_t output_count;
 
-    std::vector<Shape> input_shapes;
-    std::vector<Shape> output_shapes;
+    std::vector<ElementType> input_element_types;
+    std::vector<ElementType> output_element_types;
+
+    std::vector<bool> is_input_converted;
+    std::vector<bool> is_output_converted;
+
+    // Null unless profiling is enabled. Declared before the interpreters that point to it.
+    std::unique_ptr<tflite::profiling::BufferedProfiler> profiler;
+    bool is_profiling = false;
+
+    // Interpreters keyed by their input shapes, most recently used first. The front one is active.
+    std::list<InterpreterState> states;
+    InterpreterState *state;
 
-    std::vector<std::unique_ptr<float>> input_data;
-    std::vector<std::unique_ptr<float>> output_data;
+    // Backs the engine-owned buffers of the active interpreter.
+    BufferArena arena;
+
+    // Data pointers of each buffer set, null standing for the engine-owned buffers. The first set is the engine's own.
+    std::vector<BufferSet> buffer_sets;
+    size_t selected_buffer_set = 0;
+
+    // Null unless stats are enabled, so that disabled engines only pay for the null checks.
+    std::unique_ptr<EngineStatsRecorder> stats;
+
+    Worker worker;
 };
 
-TfLiteInferenceEngine::TfLiteInferenceEngine(const void *model_data, size_t model_data_size_bytes)
-    : impl(new Impl(model_data, model_data_size_bytes))
+TfLiteInferenceEngine::TfLiteInferenceEngine(const void *model_data, size_t model_data_size_bytes, const EngineOptions &options)
+    : TfLiteInferenceEngine(load_model(model_data, model_data_size_bytes, options))
+{
+}
+
+TfLiteInferenceEngine::TfLiteInferenceEngine(const std::filesystem::path &model_path, const EngineOptions &options)
+    : TfLiteInferenceEngine(load_model(model_path, options))
+{
+}
+
+TfLiteInferenceEngine::TfLiteInferenceEngine(std::shared_ptr<Model> model)
+    : impl(new Impl(model))
+{
+}
+
+std::shared_ptr<TfLiteInferenceEngine::Model> TfLiteInferenceEngine::load_model(const void *model_data, size_t model_data_size_bytes, const EngineOptions &options)
 {
+    return std::make_shared<Model>(model_data, model_data_size_bytes, options);
+}
+
+std::shared_ptr<TfLiteInferenceEngine::Model> TfLiteInferenceEngine::load_model(const std::filesystem::path &model_path, const EngineOptions &options)
+{
+    return std::make_shared<Model>(model_path, options);
 }
 
 size_t TfLiteInferenceEngine::get_input_count() const
@@ -292,38 +1159,118 @@ const std::vector<size_t> &TfLiteInferenceEngine::get_output_shape(size_t index)
     return impl->get_output_shape(index);
 }
 
-void TfLiteInferenceEngine::set_input_shape(size_t index, const std::vector<size_t> &shape)
+void TfLiteInferenceEngine::set_input_shape(size_t index, Span<const size_t> shape)
 {
     impl->set_input_shape(index, shape);
 }
 
-void TfLiteInferenceEngine::set_output_shape(size_t index, const std::vector<size_t> &shape)
+void TfLiteInferenceEngine::set_input_shapes(Span<const Span<const size_t>> shapes)
+{
+    impl->set_input_shapes(shapes);
+}
+
+void TfLiteInferenceEngine::set_output_shape(size_t index, Span<const size_t> shape)
 {
     impl->set_output_shape(index, shape);
 }
 
-float *TfLiteInferenceEngine::get_input_data(size_t index)
+ElementType TfLiteInferenceEngine::get_input_element_type(size_t index) const
+{
+    return impl->get_input_element_type(index);
+}
+
+ElementType TfLiteInferenceEngine::get_output_element_type(size_t index) const
+{
+    return impl->get_output_element_type(index);
+}
+
+QuantizationParams TfLiteInferenceEngine::get_input_quantization(size_t index) const
 {
-    return impl->get_input_data(index);
+    return impl->get_input_quantization(index);
 }
 
-const float *TfLiteInferenceEngine::get_output_data(size_t index) const
+QuantizationParams TfLiteInferenceEngine::get_output_quantization(size_t index) const
 {
-    return impl->get_output_data(index);
+    return impl->get_output_quantization(index);
 }
 
-void TfLiteInferenceEngine::set_input_data(size_t index, const float *data)
+void *TfLiteInferenceEngine::get_input_raw_data(size_t index)
 {
-    impl->set_input_data(index, data);
+    return impl->get_input_raw_data(index);
 }
 
-void TfLiteInferenceEngine::set_output_data(size_t index, float *data)
+const void *TfLiteInferenceEngine::get_output_raw_data(size_t index) const
 {
-    impl->set_output_data(index, data);
+    return impl->get_output_raw_data(index);
+}
+
+void TfLiteInferenceEngine::set_input_raw_data(size_t index, const void *data)
+{
+    impl->set_input_raw_data(index, data);
+}
+
+void TfLiteInferenceEngine::set_output_raw_data(size_t index, void *data)
+{
+    impl->set_output_raw_data(index, data);
+}
+
+size_t TfLiteInferenceEngine::register_buffer_set(const std::vector<const void *> &inputs, const std::vector<void *> &outputs)
+{
+    return impl->register_buffer_set(inputs, outputs);
+}
+
+void TfLiteInferenceEngine::select_buffer_set(size_t id)
+{
+    impl->select_buffer_set(id);
+}
+
+void TfLiteInferenceEngine::unregister_buffer_set(size_t id)
+{
+    impl->unregister_buffer_set(id);
+}
+
+size_t TfLiteInferenceEngine::get_buffer_set_count() const
+{
+    return impl->get_buffer_set_count();
+}
+
+size_t TfLiteInferenceEngine::get_memory_footprint() const
+{
+    return impl->get_memory_footprint();
+}
+
+std::vector<WarmupTiming> TfLiteInferenceEngine::warmup(const std::vector<std::vector<std::vector<size_t>>> &shape_sets, size_t iterations)
+{
+    return impl->warmup(shape_sets, iterations);
+}
+
+EngineStats TfLiteInferenceEngine::get_stats() const
+{
+    return impl->get_stats();
+}
+
+void TfLiteInferenceEngine::reset_stats()
+{
+    impl->reset_stats();
+}
+
+void TfLiteInferenceEngine::start_profiling()
+{
+    impl->start_profiling();
+}
+
+ProfileTrace TfLiteInferenceEngine::stop_profiling()
+{
+    return impl->stop_profiling();
 }
 
 void TfLiteInferenceEngine::run()
 {
     impl->run();
 }
+
+void TfLiteInferenceEngine::run_async(RunCallback callback)
+{
+    impl->run_async(std::move(callback));
+}
 } // namespace inference_engine
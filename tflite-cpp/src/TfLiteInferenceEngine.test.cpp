@@ -1,9 +1,16 @@
 #include "inference_engine/TfLiteInferenceEngine.hpp"
+#include "inference_engine/StatefulSession.hpp"
+#include "inference_engine/TfLiteEnginePool.hpp"
 
+#include <algorithm>
 #include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <cstdint>
 #include <filesystem>
 #include <fstream>
+#include <future>
 #include <string>
+#include <thread>
 #include <vector>
 
 std::vector<std::byte> read_file(const std::filesystem::path &file_path)
@@ -30,6 +37,11 @@ TEST_CASE("TfLiteInferenceEngine with fixed-shape model")
     REQUIRE(engine.get_input_shape(1) == std::vector<size_t>{2, 2});
     REQUIRE(engine.get_output_shape(0) == std::vector<size_t>{2, 2});
 
+    REQUIRE(engine.get_input_element_type(0) == ElementType::Float32);
+    REQUIRE(engine.get_input_element_type(1) == ElementType::Float32);
+    REQUIRE(engine.get_output_element_type(0) == ElementType::Float32);
+    REQUIRE_THROWS_WITH(engine.get_input_data<int64_t>(0), "element type mismatch");
+
     std::vector<std::vector<float>> inputs{{1, 2, 3, 4}, {5, 6, 7, 8}};
     for (auto i = 0; i < engine.get_input_count(); i++)
     {
@@ -84,3 +96,500 @@ TEST_CASE("TfLiteInferenceEngine with reshaping inputs")
     engine.run();
     REQUIRE(outputs == std::vector<std::vector<float>>{{{3, 4, 6, 8}}});
 }
+
+TEST_CASE("TfLiteInferenceEngine with alternating input shapes")
+{
+    auto model = read_file("test-models/matmul.tflite");
+    EngineOptions options;
+
+    SECTION("with shape cache")
+    {
+        options.shape_cache_capacity = 4;
+    }
+
+    SECTION("without shape cache")
+    {
+        options.shape_cache_capacity = 1;
+    }
+
+    SECTION("with XNNPACK delegate")
+    {
+        options.shape_cache_capacity = 1;
+        options.use_xnnpack = true;
+        options.xnnpack_num_threads = 2;
+    }
+
+    auto engine = TfLiteInferenceEngine(model.data(), model.size(), options);
+    auto fixed_input_data = engine.get_input_data(0);
+
+    REQUIRE_THROWS_WITH(engine.set_input_shapes({{2, 2}}), "input shape count mismatch");
+
+    for (auto n = 0; n < 3; n++)
+    {
+        engine.set_input_shape(0, {2, 1});
+        engine.set_input_shape(1, {1, 2});
+        REQUIRE(engine.get_input_shape(0) == std::vector<size_t>{2, 1});
+        REQUIRE(engine.get_input_shape(1) == std::vector<size_t>{1, 2});
+        REQUIRE(engine.get_output_shape(0) == std::vector<size_t>{2, 2});
+
+        std::copy_n(std::vector<float>{1, 2}.begin(), 2, engine.get_input_data(0));
+        std::copy_n(std::vector<float>{3, 4}.begin(), 2, engine.get_input_data(1));
+        engine.run();
+
+        auto output_data = engine.get_output_data(0);
+        REQUIRE(std::vector<float>(output_data, output_data + 4) == std::vector<float>{3, 4, 6, 8});
+
+        engine.set_input_shapes({{2, 2}, {2, 2}});
+        REQUIRE(engine.get_input_shape(0) == std::vector<size_t>{2, 2});
+        REQUIRE(engine.get_input_shape(1) == std::vector<size_t>{2, 2});
+        REQUIRE(engine.get_output_shape(0) == std::vector<size_t>{2, 2});
+
+        REQUIRE(engine.get_input_data(0) == fixed_input_data);
+        REQUIRE(reinterpret_cast<uintptr_t>(engine.get_input_data(1)) % 64 == 0);
+
+        std::copy_n(std::vector<float>{1, 2, 3, 4}.begin(), 4, engine.get_input_data(0));
+        std::copy_n(std::vector<float>{5, 6, 7, 8}.begin(), 4, engine.get_input_data(1));
+        engine.run();
+
+        output_data = engine.get_output_data(0);
+        REQUIRE(std::vector<float>(output_data, output_data + 4) == std::vector<float>{19, 22, 43, 50});
+    }
+}
+
+TEST_CASE("TfLiteInferenceEngine with warmup")
+{
+    auto model = read_file("test-models/matmul.tflite");
+    auto engine = TfLiteInferenceEngine(model.data(), model.size());
+
+    std::vector<float> output(4);
+    engine.set_output_data(0, output.data());
+
+    REQUIRE_THROWS_WITH(engine.warmup({{{2, 2}}}, 1), "input shape count mismatch");
+
+    auto timings = engine.warmup({{{2, 1}, {1, 2}}, {{2, 2}, {2, 2}}}, 2);
+    REQUIRE(timings.size() == 2);
+
+    for (const auto &timing : timings)
+    {
+        REQUIRE(timing.first_run.count() > 0);
+        REQUIRE(timing.last_run.count() > 0);
+    }
+
+    REQUIRE(engine.get_input_shape(0) == std::vector<size_t>{2, 2});
+    REQUIRE(engine.get_output_data(0) != output.data());
+
+    std::copy_n(std::vector<float>{1, 2, 3, 4}.begin(), 4, engine.get_input_data(0));
+    std::copy_n(std::vector<float>{5, 6, 7, 8}.begin(), 4, engine.get_input_data(1));
+    engine.run();
+
+    auto output_data = engine.get_output_data(0);
+    REQUIRE(std::vector<float>(output_data, output_data + 4) == std::vector<float>{19, 22, 43, 50});
+}
+
+TEST_CASE("TfLiteInferenceEngine with stats")
+{
+    auto model = read_file("test-models/matmul.tflite");
+    REQUIRE_THROWS_WITH(TfLiteInferenceEngine(model.data(), model.size()).get_stats(), "engine stats are disabled");
+
+    EngineOptions options;
+    options.enable_stats = true;
+    auto engine = TfLiteInferenceEngine(model.data(), model.size(), options);
+
+    std::vector<float> output(2);
+    engine.warmup({{{2, 2}, {2, 2}}}, 2);
+    engine.set_input_shapes({{2, 1}, {1, 2}});
+    engine.set_input_shape(0, {1, 1});
+    engine.set_output_data(0, output.data());
+
+    for (auto i = 0; i < 3; i++)
+    {
+        engine.run();
+    }
+
+    auto stats = engine.get_stats();
+    REQUIRE(stats.run_count == 3);
+    REQUIRE(stats.run_time_min.count() > 0);
+    REQUIRE(stats.run_time_min <= stats.run_time_p50);
+    REQUIRE(stats.run_time_p50 <= stats.run_time_p99);
+    REQUIRE(stats.run_time_p99 <= stats.run_time_max);
+    REQUIRE(stats.run_time_total >= stats.run_time_max);
+    REQUIRE(stats.reshape_count == 2);
+    REQUIRE(stats.bytes_bound == 8);
+
+    engine.reset_stats();
+    stats = engine.get_stats();
+    REQUIRE(stats.run_count == 0);
+    REQUIRE(stats.run_time_min.count() == 0);
+    REQUIRE(stats.reshape_count == 0);
+    REQUIRE(stats.bytes_bound == 0);
+}
+
+TEST_CASE("TfLiteInferenceEngine with profiling")
+{
+    auto model = read_file("test-models/matmul.tflite");
+    REQUIRE_THROWS_WITH(TfLiteInferenceEngine(model.data(), model.size()).start_profiling(), "engine profiling is disabled");
+
+    EngineOptions options;
+    options.enable_profiling = true;
+    auto engine = TfLiteInferenceEngine(std::filesystem::path("test-models/matmul.tflite"), options);
+    REQUIRE_THROWS_WITH(engine.stop_profiling(), "profiling is not started");
+
+    engine.run();
+    engine.start_profiling();
+    engine.run();
+    engine.set_input_shapes({{2, 1}, {1, 2}});
+    engine.run();
+
+    auto trace = engine.stop_profiling();
+    REQUIRE(trace.engine == "tflite");
+    REQUIRE(trace.model == "matmul.tflite");
+    REQUIRE(trace.events.size() == 2);
+    REQUIRE(trace.events[0].name == "Identity");
+    REQUIRE(trace.events[0].start.count() == 0);
+
+    engine.start_profiling();
+    engine.run();
+    REQUIRE(engine.stop_profiling().events.size() == 1);
+}
+
+TEST_CASE("TfLiteInferenceEngine with quantized model")
+{
+    auto model = read_file("test-models/quantize_io.tflite");
+
+    SECTION("with quantized IO")
+    {
+        auto engine = TfLiteInferenceEngine(model.data(), model.size());
+
+        REQUIRE(engine.get_input_element_type(0) == ElementType::Int8);
+        REQUIRE(engine.get_input_element_type(1) == ElementType::Float32);
+        REQUIRE(engine.get_output_element_type(0) == ElementType::Float32);
+        REQUIRE(engine.get_output_element_type(1) == ElementType::Uint8);
+
+        REQUIRE(engine.get_input_quantization(0).scale == 0.5f);
+        REQUIRE(engine.get_input_quantization(0).zero_point == -3);
+        REQUIRE(engine.get_input_quantization(1).scale == 0);
+        REQUIRE(engine.get_output_quantization(1).scale == 0.25f);
+        REQUIRE(engine.get_output_quantization(1).zero_point == 128);
+
+        std::vector<int8_t> x{-1, -7, -2, 127};
+        std::vector<float> y{1, -0.5f, 0.1f, -40};
+        engine.set_input_data(0, x.data());
+        engine.set_input_data(1, y.data());
+
+        engine.run();
+
+        auto x_out = engine.get_output_data(0);
+        auto y_out = engine.get_output_data<uint8_t>(1);
+        REQUIRE(std::vector<float>(x_out, x_out + 4) == std::vector<float>{1, -2, 0.5f, 65});
+        REQUIRE(std::vector<uint8_t>(y_out, y_out + 4) == std::vector<uint8_t>{132, 126, 128, 0});
+    }
+
+    SECTION("with float IO")
+    {
+        EngineOptions options;
+        options.use_float_io = true;
+        auto engine = TfLiteInferenceEngine(model.data(), model.size(), options);
+
+        REQUIRE(engine.get_input_element_type(0) == ElementType::Float32);
+        REQUIRE(engine.get_output_element_type(1) == ElementType::Float32);
+        REQUIRE(engine.get_input_quantization(0).scale == 0.5f);
+
+        std::vector<float> x{1, -2, 0.3f, 100};
+        std::vector<float> y{1, -0.5f, 0.1f, -40};
+        engine.set_input_data(0, x.data());
+        engine.set_input_data(1, y.data());
+
+        std::vector<float> x_out(4);
+        engine.set_output_data(0, x_out.data());
+
+        engine.run();
+
+        auto y_out = engine.get_output_data(1);
+        REQUIRE(x_out == std::vector<float>{1, -2, 0.5f, 65});
+        REQUIRE(std::vector<float>(y_out, y_out + 4) == std::vector<float>{1, -0.5f, 0, -32});
+
+        engine.set_input_shape(0, {40});
+        engine.set_input_shape(1, {40});
+
+        for (auto i = 0; i < 40; i++)
+        {
+            engine.get_input_data(0)[i] = 0.3f * (i - 20);
+            engine.get_input_data(1)[i] = 0.3f * (i - 20);
+        }
+
+        engine.run();
+
+        for (auto i = 0; i < 40; i++)
+        {
+            REQUIRE(engine.get_output_data(0)[i] == 0.5f * std::round(0.6f * (i - 20)));
+            REQUIRE(engine.get_output_data(1)[i] == 0.25f * std::round(1.2f * (i - 20)));
+        }
+    }
+}
+
+TEST_CASE("TfLiteInferenceEngine with model file")
+{
+    auto engine = TfLiteInferenceEngine(std::filesystem::path("test-models/matmul.tflite"));
+
+    REQUIRE(engine.get_input_count() == 2);
+    REQUIRE(engine.get_output_count() == 1);
+
+    std::vector<std::vector<float>> inputs{{1, 2, 3, 4}, {5, 6, 7, 8}};
+    for (auto i = 0; i < engine.get_input_count(); i++)
+    {
+        engine.set_input_data(i, inputs[i].data());
+    }
+
+    std::vector<std::vector<float>> outputs{{0, 0, 0, 0}};
+    for (auto i = 0; i < engine.get_output_count(); i++)
+    {
+        engine.set_output_data(i, outputs[i].data());
+    }
+
+    engine.run();
+
+    REQUIRE(outputs == std::vector<std::vector<float>>{{{19, 22, 43, 50}}});
+}
+
+TEST_CASE("TfLiteInferenceEngine with missing model file")
+{
+    REQUIRE_THROWS_WITH(TfLiteInferenceEngine(std::filesystem::path("test-models/missing.tflite")), "failed to open file: test-models/missing.tflite");
+}
+
+TEST_CASE("TfLiteInferenceEngine with engine options")
+{
+    auto model = read_file("test-models/matmul.tflite");
+    EngineOptions options;
+    options.intra_op_num_threads = 2;
+    auto engine = TfLiteInferenceEngine(model.data(), model.size(), options);
+
+    std::vector<std::vector<float>> inputs{{1, 2, 3, 4}, {5, 6, 7, 8}};
+    for (auto i = 0; i < engine.get_input_count(); i++)
+    {
+        engine.set_input_data(i, inputs[i].data());
+    }
+
+    std::vector<std::vector<float>> outputs{{0, 0, 0, 0}};
+    for (auto i = 0; i < engine.get_output_count(); i++)
+    {
+        engine.set_output_data(i, outputs[i].data());
+    }
+
+    engine.run();
+
+    REQUIRE(outputs == std::vector<std::vector<float>>{{{19, 22, 43, 50}}});
+}
+
+#ifdef __linux__
+TEST_CASE("TfLiteInferenceEngine with thread placement")
+{
+    EngineOptions options;
+    options.intra_op_num_threads = 2;
+    options.intra_op_thread_affinities = {{0}};
+    options.numa_node = 0;
+    options.use_xnnpack = true;
+    auto engine = TfLiteInferenceEngine(std::filesystem::path("test-models/matmul.tflite"), options);
+
+    std::copy_n(std::vector<float>{1, 2, 3, 4}.begin(), 4, engine.get_input_data(0));
+    std::copy_n(std::vector<float>{5, 6, 7, 8}.begin(), 4, engine.get_input_data(1));
+    engine.run();
+
+    auto output_data = engine.get_output_data(0);
+    REQUIRE(std::vector<float>(output_data, output_data + 4) == std::vector<float>{19, 22, 43, 50});
+
+    options.use_xnnpack = false;
+    REQUIRE_THROWS_WITH(TfLiteInferenceEngine(std::filesystem::path("test-models/matmul.tflite"), options), "intra-op thread affinities are not supported without XNNPACK");
+}
+#endif
+
+TEST_CASE("TfLiteInferenceEngine without spinning")
+{
+    EngineOptions options;
+    options.allow_spinning = false;
+    REQUIRE_THROWS_WITH(TfLiteInferenceEngine(std::filesystem::path("test-models/matmul.tflite"), options), "disabling spinning is not supported by TFLite");
+}
+
+TEST_CASE("TfLiteInferenceEngine with async run")
+{
+    auto model = read_file("test-models/matmul.tflite");
+    auto engine = TfLiteInferenceEngine(model.data(), model.size());
+
+    std::vector<std::vector<float>> inputs{{1, 2, 3, 4}, {5, 6, 7, 8}};
+    for (auto i = 0; i < engine.get_input_count(); i++)
+    {
+        engine.set_input_data(i, inputs[i].data());
+    }
+
+    std::vector<std::vector<float>> outputs{{0, 0, 0, 0}};
+    for (auto i = 0; i < engine.get_output_count(); i++)
+    {
+        engine.set_output_data(i, outputs[i].data());
+    }
+
+    engine.run_async().get();
+
+    REQUIRE(outputs == std::vector<std::vector<float>>{{{19, 22, 43, 50}}});
+
+    inputs[1][3] = 9;
+    std::promise<std::exception_ptr> completed;
+    engine.run_async([&completed](std::exception_ptr error) { completed.set_value(error); });
+
+    REQUIRE(completed.get_future().get() == nullptr);
+    REQUIRE(outputs == std::vector<std::vector<float>>{{{19, 24, 43, 54}}});
+}
+
+TEST_CASE("TfLiteInferenceEngine with buffer sets")
+{
+    auto model = read_file("test-models/matmul.tflite");
+    auto engine = TfLiteInferenceEngine(model.data(), model.size());
+
+    std::vector<std::vector<float>> inputs{{1, 2, 3, 4}, {5, 6, 7, 8}, {1, 0, 0, 1}, {5, 6, 7, 9}};
+    std::vector<std::vector<float>> outputs{{0, 0, 0, 0}, {0, 0, 0, 0}};
+
+    auto first = engine.register_buffer_set({inputs[0].data(), inputs[1].data()}, {outputs[0].data()});
+    auto second = engine.register_buffer_set({inputs[2].data(), inputs[3].data()}, {outputs[1].data()});
+    REQUIRE(first == 1);
+    REQUIRE(second == 2);
+    REQUIRE_THROWS_WITH(engine.register_buffer_set({inputs[0].data()}, {outputs[0].data()}), "buffer count mismatch");
+    REQUIRE_THROWS_WITH(engine.select_buffer_set(3), "invalid buffer set id");
+
+    engine.select_buffer_set(first);
+    REQUIRE(engine.get_input_data(0) == inputs[0].data());
+    engine.run();
+
+    engine.select_buffer_set(second);
+    REQUIRE(engine.get_input_data(0) == inputs[2].data());
+    REQUIRE(engine.get_output_data(0) == outputs[1].data());
+    engine.run();
+
+    REQUIRE(outputs == std::vector<std::vector<float>>{{19, 22, 43, 50}, {5, 6, 7, 9}});
+
+    engine.unregister_buffer_set(second);
+    REQUIRE(engine.get_input_data(0) != inputs[2].data());
+    engine.select_buffer_set(second);
+    REQUIRE(engine.get_input_data(0) != inputs[2].data());
+    REQUIRE_THROWS_WITH(engine.unregister_buffer_set(0), "invalid buffer set id");
+    REQUIRE(engine.register_buffer_set({inputs[2].data(), inputs[3].data()}, {outputs[1].data()}) == second);
+    REQUIRE(engine.get_buffer_set_count() == 3);
+
+    engine.select_buffer_set(0);
+    REQUIRE(engine.get_input_data(0) != inputs[0].data());
+
+    engine.set_input_shape(0, {2, 1});
+    REQUIRE_THROWS_WITH(engine.select_buffer_set(first), "invalid buffer set id");
+}
+
+TEST_CASE("StatefulSession with recurrent matmul model")
+{
+    auto model = read_file("test-models/matmul.tflite");
+    auto engine = TfLiteInferenceEngine(model.data(), model.size());
+    auto session = StatefulSession(engine, {{0, 1}});
+
+    // Every run multiplies the state by A, so that a stream starting from the identity holds A^n after n runs.
+    std::vector<float> a{1, 1, 0, 1};
+    engine.set_input_data(0, a.data());
+
+    auto create_identity_state = [&session] {
+        auto state = session.create_state();
+        auto data = static_cast<float *>(state.get_data(0));
+        data[0] = 1;
+        data[3] = 1;
+        return state;
+    };
+
+    auto read_state = [](const StreamState &state) {
+        auto data = static_cast<const float *>(state.get_data(0));
+        return std::vector<float>(data, data + 4);
+    };
+
+    auto first = create_identity_state();
+    auto second = create_identity_state();
+
+    session.run(first);
+    session.run(first);
+    REQUIRE(read_state(first) == std::vector<float>{1, 2, 0, 1});
+    REQUIRE(engine.get_output_raw_data(0) == first.get_data(0));
+
+    session.run(second);
+    REQUIRE(read_state(second) == std::vector<float>{1, 1, 0, 1});
+
+    session.run(first);
+    REQUIRE(read_state(first) == std::vector<float>{1, 3, 0, 1});
+    REQUIRE(engine.get_input_data(0) == a.data());
+
+    // Both arrangements of the first stream and one of the second are registered once, next to the engine's own set.
+    REQUIRE(engine.get_buffer_set_count() == 4);
+
+    engine.select_buffer_set(0);
+    REQUIRE(engine.get_input_data(0) == a.data());
+}
+
+TEST_CASE("StatefulSession releases buffer sets of closed streams")
+{
+    auto model = read_file("test-models/matmul.tflite");
+    auto engine = TfLiteInferenceEngine(model.data(), model.size());
+    auto session = StatefulSession(engine, {{0, 1}});
+
+    std::vector<float> a{1, 1, 0, 1};
+    engine.set_input_data(0, a.data());
+
+    for (auto i = 0; i < 100; i++)
+    {
+        auto state = session.create_state();
+        session.run(state);
+        session.run(state);
+    }
+
+    REQUIRE(engine.get_buffer_set_count() == 3);
+    engine.select_buffer_set(0);
+    REQUIRE(engine.get_input_data(0) == a.data());
+}
+
+TEST_CASE("TfLiteEnginePool with concurrent runs")
+{
+    auto model = read_file("test-models/matmul.tflite");
+    EngineOptions options;
+
+    SECTION("with default delegates")
+    {
+    }
+
+    SECTION("with XNNPACK delegate sharing packed weights")
+    {
+        options.use_xnnpack = true;
+    }
+
+    auto pool = TfLiteEnginePool(model.data(), model.size(), options, 2);
+
+    REQUIRE(pool.get_capacity() == 2);
+
+    std::vector<std::thread> threads;
+    std::vector<std::vector<float>> outputs(8, std::vector<float>(4));
+
+    for (auto t = 0; t < outputs.size(); t++)
+    {
+        threads.emplace_back([&pool, &outputs, t] {
+            auto engine = pool.checkout();
+
+            std::vector<std::vector<float>> inputs{{1, 2, 3, 4}, {5, 6, 7, static_cast<float>(8 + t)}};
+            for (auto i = 0; i < engine->get_input_count(); i++)
+            {
+                engine->set_input_data(i, inputs[i].data());
+            }
+
+            engine->set_output_data(0, outputs[t].data());
+            engine->run();
+            engine->set_output_data(0, nullptr);
+        });
+    }
+
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+
+    for (auto t = 0; t < outputs.size(); t++)
+    {
+        REQUIRE(outputs[t] == std::vector<float>{19, 22.0f + 2 * t, 43, 50.0f + 4 * t});
+    }
+}
@@ -3,5 +3,6 @@ import os, sys
 if sys.platform != "darwin":
     os.system("pip install tensorflow==2.12.0")
 
+from models.quantize_io import *
 from models.matmul_dynamic import *
 from models.matmul import *
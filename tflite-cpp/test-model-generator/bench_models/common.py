@@ -0,0 +1,18 @@
+import tensorflow as tf
+
+
+def save_keras_model(model, model_file):
+    converter = tf.lite.TFLiteConverter.from_keras_model(model)
+    save(converter.convert(), model_file)
+
+
+def save_module(module, function, model_file):
+    converter = tf.lite.TFLiteConverter.from_concrete_functions(
+        [function.get_concrete_function()], module
+    )
+    save(converter.convert(), model_file)
+
+
+def save(tflite_model, model_file):
+    with open(model_file, "wb") as f:
+        f.write(tflite_model)
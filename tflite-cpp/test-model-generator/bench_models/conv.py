@@ -0,0 +1,26 @@
+import tensorflow as tf
+
+from bench_models.common import save_keras_model
+
+
+# Image classifier of 4 3x3 convolutions with 16 * scale channels, taking (N, 32, 32, 3) to (N, 10).
+def generate(scale, model_file):
+    tf.keras.utils.set_random_seed(0)
+    channels = 16 * scale
+
+    inputs = tf.keras.Input(shape=(32, 32, 3), name="X")
+    x = inputs
+
+    for i in range(4):
+        x = tf.keras.layers.Conv2D(
+            channels,
+            3,
+            strides=2 if i % 2 else 1,
+            padding="same",
+            activation="relu",
+        )(x)
+
+    x = tf.keras.layers.GlobalAveragePooling2D()(x)
+    outputs = tf.keras.layers.Dense(10)(x)
+
+    save_keras_model(tf.keras.Model(inputs, outputs), model_file)
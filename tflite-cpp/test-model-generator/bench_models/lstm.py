@@ -0,0 +1,16 @@
+import tensorflow as tf
+
+from bench_models.common import save_keras_model
+
+
+# 2 stacked LSTMs with 64 * scale hidden units, taking (1, T, 32) to (1, T, 32).
+def generate(scale, model_file):
+    tf.keras.utils.set_random_seed(0)
+    hidden_size = 64 * scale
+
+    inputs = tf.keras.Input(shape=(None, 32), batch_size=1, name="X")
+    x = tf.keras.layers.LSTM(hidden_size, return_sequences=True)(inputs)
+    x = tf.keras.layers.LSTM(hidden_size, return_sequences=True)(x)
+    outputs = tf.keras.layers.Dense(32)(x)
+
+    save_keras_model(tf.keras.Model(inputs, outputs), model_file)
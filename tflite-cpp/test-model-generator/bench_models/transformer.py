@@ -0,0 +1,67 @@
+import tensorflow as tf
+
+from bench_models.common import save_module
+
+
+# 2 pre-norm transformer encoder layers of width 64 * scale with 4 heads, taking (1, T, 32) to (1, T, 32).
+class Transformer(tf.Module):
+    def __init__(self, scale):
+        super().__init__()
+        tf.random.set_seed(0)
+        self.model_size = 64 * scale
+        self.head_count = 4
+        self.head_size = self.model_size // self.head_count
+
+        def weight(*shape):
+            return tf.Variable(tf.random.normal(shape, stddev=0.1))
+
+        self.input_w = weight(32, self.model_size)
+        self.output_w = weight(self.model_size, 32)
+        self.layers = [
+            {
+                "q": weight(self.model_size, self.model_size),
+                "k": weight(self.model_size, self.model_size),
+                "v": weight(self.model_size, self.model_size),
+                "o": weight(self.model_size, self.model_size),
+                "ff1": weight(self.model_size, 4 * self.model_size),
+                "ff2": weight(4 * self.model_size, self.model_size),
+            }
+            for _ in range(2)
+        ]
+
+    @tf.function(
+        input_signature=[tf.TensorSpec(shape=(1, None, 32), dtype=tf.float32, name="X")]
+    )
+    def encode(self, X):
+        x = tf.matmul(X, self.input_w)
+
+        for layer in self.layers:
+            n = self.layer_norm(x)
+            q = self.heads(tf.matmul(n, layer["q"]))
+            k = self.heads(tf.matmul(n, layer["k"]))
+            v = self.heads(tf.matmul(n, layer["v"]))
+            scores = tf.matmul(q, k, transpose_b=True) / self.head_size**0.5
+            attention = tf.matmul(tf.nn.softmax(scores, axis=-1), v)
+            attention = tf.reshape(
+                tf.transpose(attention, [0, 2, 1, 3]), [1, -1, self.model_size]
+            )
+            x = x + tf.matmul(attention, layer["o"])
+
+            n = self.layer_norm(x)
+            hidden = tf.nn.relu(tf.matmul(n, layer["ff1"]))
+            x = x + tf.matmul(hidden, layer["ff2"])
+
+        return tf.matmul(x, self.output_w)
+
+    def heads(self, x):
+        x = tf.reshape(x, [1, -1, self.head_count, self.head_size])
+        return tf.transpose(x, [0, 2, 1, 3])
+
+    def layer_norm(self, x):
+        mean, variance = tf.nn.moments(x, axes=[-1], keepdims=True)
+        return (x - mean) * tf.math.rsqrt(variance + 1e-5)
+
+
+def generate(scale, model_file):
+    model = Transformer(scale)
+    save_module(model, model.encode, model_file)
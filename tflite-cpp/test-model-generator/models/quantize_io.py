@@ -0,0 +1,68 @@
+import flatbuffers
+from tensorflow.lite.python import schema_py_generated as schema_fb
+
+model_file = "../test-models/quantize_io.tflite"
+
+
+def make_tensor(name, tensor_type, scale=None, zero_point=None):
+    tensor = schema_fb.TensorT()
+    tensor.name = name
+    tensor.shape = [4]
+    tensor.type = tensor_type
+    tensor.buffer = 0
+
+    if scale is not None:
+        tensor.quantization = schema_fb.QuantizationParametersT()
+        tensor.quantization.scale = [scale]
+        tensor.quantization.zeroPoint = [zero_point]
+
+    return tensor
+
+
+def make_operator_code(builtin_code):
+    operator_code = schema_fb.OperatorCodeT()
+    operator_code.deprecatedBuiltinCode = builtin_code
+    operator_code.builtinCode = builtin_code
+    operator_code.version = 2
+    return operator_code
+
+
+def make_operator(opcode_index, inputs, outputs):
+    operator = schema_fb.OperatorT()
+    operator.opcodeIndex = opcode_index
+    operator.inputs = inputs
+    operator.outputs = outputs
+    return operator
+
+
+# X_q (int8) -> DEQUANTIZE -> X (float32)
+# Y (float32) -> QUANTIZE -> Y_q (uint8)
+subgraph = schema_fb.SubGraphT()
+subgraph.name = "main"
+subgraph.tensors = [
+    make_tensor("x_q", schema_fb.TensorType.INT8, 0.5, -3),
+    make_tensor("x", schema_fb.TensorType.FLOAT32),
+    make_tensor("y", schema_fb.TensorType.FLOAT32),
+    make_tensor("y_q", schema_fb.TensorType.UINT8, 0.25, 128),
+]
+subgraph.inputs = [0, 2]
+subgraph.outputs = [1, 3]
+subgraph.operators = [
+    make_operator(0, [0], [1]),
+    make_operator(1, [2], [3]),
+]
+
+model = schema_fb.ModelT()
+model.version = 3
+model.operatorCodes = [
+    make_operator_code(schema_fb.BuiltinOperator.DEQUANTIZE),
+    make_operator_code(schema_fb.BuiltinOperator.QUANTIZE),
+]
+model.subgraphs = [subgraph]
+model.buffers = [schema_fb.BufferT()]
+
+builder = flatbuffers.Builder(1024)
+builder.Finish(model.Pack(builder), file_identifier=b"TFL3")
+
+with open(model_file, "wb") as f:
+    f.write(builder.Output())
@@ -1,7 +1,8 @@
 pub use inference_engine_core::*;
 
 use inference_engine_tflite_sys as sys;
-use std::ffi::c_void;
+use std::ffi::{c_void, CString};
+use std::path::Path;
 use std::ptr::{null, null_mut};
 
 #[derive(Debug)]
@@ -14,23 +15,85 @@ pub struct TfLiteInferenceEngine {
 
 impl TfLiteInferenceEngine {
     pub fn new(model_data: impl AsRef<[u8]>) -> Result<Self, Error> {
+        Self::with_options(model_data, &EngineOptions::default())
+    }
+
+    pub fn with_options(
+        model_data: impl AsRef<[u8]>,
+        options: &EngineOptions,
+    ) -> Result<Self, Error> {
         unsafe {
             let model_data = model_data.as_ref().to_owned();
+            let options = sys::RawEngineOptions::try_from(options)?;
             let mut raw = null_mut();
 
-            Result::from(sys::inference_engine_tflite__create_inference_engine(
-                if model_data.is_empty() {
-                    null()
-                } else {
-                    model_data.as_ptr() as _
-                },
-                model_data.len(),
-                &mut raw,
-            ))?;
+            Result::from(
+                sys::inference_engine_tflite__create_inference_engine_with_options(
+                    if model_data.is_empty() {
+                        null()
+                    } else {
+                        model_data.as_ptr() as _
+                    },
+                    model_data.len(),
+                    options.as_ptr(),
+                    &mut raw,
+                ),
+            )?;
 
             Ok(Self { raw, model_data })
         }
     }
+    pub fn from_file(model_path: impl AsRef<Path>, options: &EngineOptions) -> Result<Self, Error> {
+        unsafe {
+            let model_path = CString::new(model_path.as_ref().to_string_lossy().as_bytes())
+                .map_err(|e| Error::Unknown(Box::new(e)))?;
+            let options = sys::RawEngineOptions::try_from(options)?;
+            let mut raw = null_mut();
+
+            Result::from(
+                sys::inference_engine_tflite__create_inference_engine_from_file(
+                    model_path.as_ptr(),
+                    options.as_ptr(),
+                    &mut raw,
+                ),
+            )?;
+
+            Ok(Self {
+                raw,
+                model_data: Vec::new(),
+            })
+        }
+    }
+
+    pub fn input_quantization(&self, index: usize) -> QuantizationParams {
+        let mut quantization = QuantizationParams::default();
+
+        unsafe {
+            sys::inference_engine_tflite__get_input_quantization(
+                self.raw,
+                index,
+                &mut quantization.scale,
+                &mut quantization.zero_point,
+            );
+        }
+
+        quantization
+    }
+
+    pub fn output_quantization(&self, index: usize) -> QuantizationParams {
+        let mut quantization = QuantizationParams::default();
+
+        unsafe {
+            sys::inference_engine_tflite__get_output_quantization(
+                self.raw,
+                index,
+                &mut quantization.scale,
+                &mut quantization.zero_point,
+            );
+        }
+
+        quantization
+    }
 }
 
 sys::impl_inference_engine!(TfLiteInferenceEngine);
@@ -56,15 +119,15 @@ mod tests {
         let model_data = include_bytes!("../../tflite-cpp/test-models/matmul.tflite");
         let mut engine = TfLiteInferenceEngine::new(model_data).unwrap();
 
-        assert_eq!(engine.input_shapes(), [[2, 2], [2, 2]]);
-        assert_eq!(engine.output_shapes(), [[2, 2]]);
+        assert_eq!(engine.input_shapes().collect::<Vec<_>>(), [[2, 2], [2, 2]]);
+        assert_eq!(engine.output_shapes().collect::<Vec<_>>(), [[2, 2]]);
 
         let input_data = [[1., 2., 3., 4.], [5., 6., 7., 8.]];
         let input_data = input_data.iter().map(|v| v.as_slice()).collect::<Vec<_>>();
         engine.set_input_data_all(&input_data).unwrap();
         engine
             .input_data_all()
-            .iter()
+            .unwrap()
             .zip(input_data.iter())
             .for_each(|(a, b)| {
                 assert_eq!(a.as_ptr(), b.as_ptr() as _);
@@ -78,7 +141,7 @@ mod tests {
         engine.set_output_data_all(&mut output_data).unwrap();
         engine
             .output_data_all()
-            .iter()
+            .unwrap()
             .zip(output_data.iter())
             .for_each(|(a, b)| {
                 assert_eq!(a.as_ptr(), b.as_ptr() as _);
@@ -88,24 +151,142 @@ mod tests {
         assert_eq!(output_data, [[19., 22., 43., 50.]]);
     }
 
+    #[test]
+    fn from_file() {
+        let model_path =
+            Path::new(env!("CARGO_MANIFEST_DIR")).join("../tflite-cpp/test-models/matmul.tflite");
+        let mut engine =
+            TfLiteInferenceEngine::from_file(model_path, &EngineOptions::default()).unwrap();
+
+        assert_eq!(engine.input_shapes().collect::<Vec<_>>(), [[2, 2], [2, 2]]);
+        assert_eq!(engine.output_shapes().collect::<Vec<_>>(), [[2, 2]]);
+
+        let input_data = [[1., 2., 3., 4.], [5., 6., 7., 8.]];
+        let input_data = input_data.iter().map(|v| v.as_slice()).collect::<Vec<_>>();
+        engine.set_input_data_all(&input_data).unwrap();
+
+        engine.run().unwrap();
+        assert_eq!(engine.output_data(0).unwrap(), [19., 22., 43., 50.]);
+    }
+
+    #[test]
+    fn with_options() {
+        let model_data = include_bytes!("../../tflite-cpp/test-models/matmul.tflite");
+        let options = EngineOptions {
+            intra_op_num_threads: 2,
+            ..Default::default()
+        };
+        let mut engine = TfLiteInferenceEngine::with_options(model_data, &options).unwrap();
+
+        let input_data = [[1., 2., 3., 4.], [5., 6., 7., 8.]];
+        let input_data = input_data.iter().map(|v| v.as_slice()).collect::<Vec<_>>();
+        engine.set_input_data_all(&input_data).unwrap();
+
+        engine.run().unwrap();
+        assert_eq!(engine.output_data(0).unwrap(), [19., 22., 43., 50.]);
+    }
+
+    #[test]
+    fn with_buffer_sets() {
+        let model_data = include_bytes!("../../tflite-cpp/test-models/matmul.tflite");
+        let mut engine = TfLiteInferenceEngine::new(model_data).unwrap();
+
+        let inputs = [
+            [1., 2., 3., 4.],
+            [5., 6., 7., 8.],
+            [1., 0., 0., 1.],
+            [5., 6., 7., 9.],
+        ];
+        let mut outputs = [[0.; 4]; 2];
+        let [first_output, second_output] = &mut outputs;
+
+        // The buffers outlive the engine's runs and are only read back once they finished.
+        let (first, second) = unsafe {
+            (
+                engine
+                    .register_buffer_set(&[&inputs[0], &inputs[1]], &mut [first_output])
+                    .unwrap(),
+                engine
+                    .register_buffer_set(&[&inputs[2], &inputs[3]], &mut [second_output])
+                    .unwrap(),
+            )
+        };
+        assert!(engine.select_buffer_set(3).is_err());
+
+        engine.select_buffer_set(first).unwrap();
+        engine.run().unwrap();
+        engine.select_buffer_set(second).unwrap();
+        engine.run().unwrap();
+
+        assert_eq!(outputs, [[19., 22., 43., 50.], [5., 6., 7., 9.]]);
+    }
+
+    #[test]
+    fn run_async() {
+        let model_data = include_bytes!("../../tflite-cpp/test-models/matmul.tflite");
+        let mut engine = TfLiteInferenceEngine::new(model_data).unwrap();
+
+        let input_data = [[1., 2., 3., 4.], [5., 6., 7., 8.]];
+        let input_data = input_data.iter().map(|v| v.as_slice()).collect::<Vec<_>>();
+        engine.set_input_data_all(&input_data).unwrap();
+
+        futures::executor::block_on(unsafe { engine.run_async() }).unwrap();
+        assert_eq!(engine.output_data(0).unwrap(), [19., 22., 43., 50.]);
+    }
+
+    #[test]
+    fn with_quantized_model() {
+        let model_data = include_bytes!("../../tflite-cpp/test-models/quantize_io.tflite");
+        let options = EngineOptions {
+            use_float_io: true,
+            ..Default::default()
+        };
+        let mut engine = TfLiteInferenceEngine::with_options(model_data, &options).unwrap();
+
+        assert_eq!(
+            engine.input_quantization(0),
+            QuantizationParams {
+                scale: 0.5,
+                zero_point: -3
+            }
+        );
+        assert_eq!(
+            engine.output_quantization(1),
+            QuantizationParams {
+                scale: 0.25,
+                zero_point: 128
+            }
+        );
+        assert_eq!(engine.input_element_type(0), ElementType::Float32);
+        assert_eq!(engine.output_element_type(1), ElementType::Float32);
+
+        let input_data = [[1., -2., 0.3, 100.], [1., -0.5, 0.1, -40.]];
+        let input_data = input_data.iter().map(|v| v.as_slice()).collect::<Vec<_>>();
+        engine.set_input_data_all(&input_data).unwrap();
+
+        engine.run().unwrap();
+        assert_eq!(engine.output_data(0).unwrap(), [1., -2., 0.5, 65.]);
+        assert_eq!(engine.output_data(1).unwrap(), [1., -0.5, 0., -32.]);
+    }
+
     #[test]
     fn with_reshaping_inputs() {
         let model_data = include_bytes!("../../tflite-cpp/test-models/matmul.tflite");
         let mut engine = TfLiteInferenceEngine::new(model_data).unwrap();
 
-        assert_eq!(engine.input_shapes(), [[2, 2], [2, 2]]);
-        assert_eq!(engine.output_shapes(), [[2, 2]]);
+        assert_eq!(engine.input_shapes().collect::<Vec<_>>(), [[2, 2], [2, 2]]);
+        assert_eq!(engine.output_shapes().collect::<Vec<_>>(), [[2, 2]]);
 
         engine.set_input_shapes(&[&[2, 1], &[1, 2]]).unwrap();
-        assert_eq!(engine.input_shapes(), [[2, 1], [1, 2]]);
-        assert_eq!(engine.output_shapes(), [[2, 2]]);
+        assert_eq!(engine.input_shapes().collect::<Vec<_>>(), [[2, 1], [1, 2]]);
+        assert_eq!(engine.output_shapes().collect::<Vec<_>>(), [[2, 2]]);
 
         let input_data = [[1., 2.], [3., 4.]];
         let input_data = input_data.iter().map(|v| v.as_slice()).collect::<Vec<_>>();
         engine.set_input_data_all(&input_data).unwrap();
         engine
             .input_data_all()
-            .iter()
+            .unwrap()
             .zip(input_data.iter())
             .for_each(|(a, b)| {
                 assert_eq!(a.as_ptr(), b.as_ptr() as _);
@@ -119,7 +300,7 @@ mod tests {
         engine.set_output_data_all(&mut output_data).unwrap();
         engine
             .output_data_all()
-            .iter()
+            .unwrap()
             .zip(output_data.iter())
             .for_each(|(a, b)| {
                 assert_eq!(a.as_ptr(), b.as_ptr() as _);
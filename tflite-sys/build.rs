@@ -95,7 +95,7 @@ fn generate_bindings() {
     bindgen::Builder::default()
         .header(header_path.display().to_string())
         .allowlist_file(header_path.display().to_string())
-        .blocklist_item("InferenceEngineResultCode")
+        .blocklist_item("InferenceEngine.*")
         .clang_args(["-I../core-sys/include"])
         .parse_callbacks(Box::new(bindgen::CargoCallbacks))
         .raw_line("pub use inference_engine_core_sys::*;")
@@ -1,12 +1,18 @@
 #pragma once
 
 #include <lib_core.h>
+#include <stdint.h>
 
 #ifdef __cplusplus
 extern "C"
 {
 #endif
     InferenceEngineResultCode inference_engine_tflite__create_inference_engine(const void *model_data, size_t model_data_size_bytes, void **engine);
+    InferenceEngineResultCode inference_engine_tflite__create_inference_engine_with_options(const void *model_data, size_t model_data_size_bytes, const InferenceEngineOptions *options, void **engine);
+    InferenceEngineResultCode inference_engine_tflite__create_inference_engine_from_file(const char *model_path, const InferenceEngineOptions *options, void **engine);
+
+    void inference_engine_tflite__get_input_quantization(const void *engine, size_t index, float *scale, int32_t *zero_point);
+    void inference_engine_tflite__get_output_quantization(const void *engine, size_t index, float *scale, int32_t *zero_point);
 #ifdef __cplusplus
 }
 #endif
@@ -1,6 +1,7 @@
 #include "lib.h"
 
 #include <inference_engine/TfLiteInferenceEngine.hpp>
+#include <lib_core.hpp>
 
 InferenceEngineResultCode inference_engine_tflite__create_inference_engine(const void *model_data, size_t model_data_size_bytes, void **engine)
 {
@@ -15,3 +16,45 @@ InferenceEngineResultCode inference_engine_tflite__create_inference_engine(const
         return InferenceEngineResultCode::Error;
     }
 }
+
+InferenceEngineResultCode inference_engine_tflite__create_inference_engine_with_options(const void *model_data, size_t model_data_size_bytes, const InferenceEngineOptions *options, void **engine)
+{
+    try
+    {
+        *engine = new inference_engine::TfLiteInferenceEngine(model_data, model_data_size_bytes, inference_engine::to_engine_options(options));
+        return InferenceEngineResultCode::Ok;
+    }
+    catch (const std::exception &e)
+    {
+        inference_engine__update_last_error_message(e.what());
+        return InferenceEngineResultCode::Error;
+    }
+}
+
+InferenceEngineResultCode inference_engine_tflite__create_inference_engine_from_file(const char *model_path, const InferenceEngineOptions *options, void **engine)
+{
+    try
+    {
+        *engine = new inference_engine::TfLiteInferenceEngine(std::filesystem::u8path(model_path), inference_engine::to_engine_options(options));
+        return InferenceEngineResultCode::Ok;
+    }
+    catch (const std::exception &e)
+    {
+        inference_engine__update_last_error_message(e.what());
+        return InferenceEngineResultCode::Error;
+    }
+}
+
+void inference_engine_tflite__get_input_quantization(const void *engine, size_t index, float *scale, int32_t *zero_point)
+{
+    auto quantization = static_cast<const inference_engine::TfLiteInferenceEngine *>(engine)->get_input_quantization(index);
+    *scale = quantization.scale;
+    *zero_point = quantization.zero_point;
+}
+
+void inference_engine_tflite__get_output_quantization(const void *engine, size_t index, float *scale, int32_t *zero_point)
+{
+    auto quantization = static_cast<const inference_engine::TfLiteInferenceEngine *>(engine)->get_output_quantization(index);
+    *scale = quantization.scale;
+    *zero_point = quantization.zero_point;
+}